@@ -0,0 +1,217 @@
+// Tail latency of mixed-cost requests served inline on the reactor thread
+// versus offloaded to the work-stealing executor.
+//
+// Usage: sock_bench_executor [connections] [requests] [slow-every]
+
+#include "sock/executor.hpp"
+#include "sock/reactor.hpp"
+#include "sock/socket_factory.hpp"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr sock::CtorArgs TCP {
+    .domain = sock::Domain::INET,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::TCP,
+    .flags = sock::Flags::PASSIVE,
+};
+
+static auto spin(std::chrono::microseconds cost) -> void
+{
+	const auto until = Clock::now() + cost;
+
+	while (Clock::now() < until)
+	{}
+}
+
+// Requests are one byte: 's' is slow (2ms of work), anything else fast
+// (20us).
+static auto handle(sock::Socket& conn) -> bool
+{
+	char request;
+
+	if (recv(conn.native_handle(), &request, 1, 0) <= 0)
+	{
+		return false;
+	}
+
+	spin(std::chrono::microseconds {request == 's' ? 2000 : 20});
+	send(conn.native_handle(), &request, 1, MSG_NOSIGNAL);
+
+	return true;
+}
+
+static auto client(
+    uint16_t port,
+    int requests,
+    int slow_every,
+    std::vector<double>& latencies,
+    std::mutex& mutex
+) -> void
+{
+	sockaddr_in address {};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	const auto fd = socket(AF_INET, SOCK_STREAM, 0);
+	const int one = 1;
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+	connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+
+	std::vector<double> local;
+	local.reserve(requests);
+
+	for (int i = 0; i < requests; i++)
+	{
+		const char request = i % slow_every == slow_every - 1 ? 's' : 'f';
+		char reply;
+
+		const auto start = Clock::now();
+		send(fd, &request, 1, 0);
+		recv(fd, &reply, 1, 0);
+		const std::chrono::duration<double, std::micro> took =
+		    Clock::now() - start;
+
+		// Only the fast requests show whether slow ones got in the way.
+		if (request != 's')
+		{
+			local.push_back(took.count());
+		}
+	}
+
+	close(fd);
+
+	std::lock_guard lock {mutex};
+	latencies.insert(latencies.end(), local.begin(), local.end());
+}
+
+static auto bench(
+    const char* name,
+    const char* port,
+    sock::Executor* executor,
+    int connections,
+    int requests,
+    int slow_every
+) -> void
+{
+	sock::Reactor reactor;
+	auto server = sock::SocketFactory::instance().create(TCP);
+	server.option(sock::Option::REUSEADDR, 1);
+	server.bind({.host = "127.0.0.1", .port = port});
+	server.listen(connections);
+
+	const uint32_t events = sock::Events::READABLE | sock::Events::ONE_SHOT;
+
+	reactor.add(
+	    server,
+	    sock::Events::READABLE,
+	    [&](uint32_t)
+	    {
+		    auto conn = std::make_shared<sock::Socket>(server.accept());
+		    const auto fd = conn->native_handle();
+
+		    sock::Reactor::Handler handler = [&reactor, conn, fd](uint32_t)
+		    {
+			    if (!handle(*conn))
+			    {
+				    reactor.post(
+				        [&reactor, fd]()
+				        {
+					        reactor.remove(fd);
+				        }
+				    );
+			    }
+		    };
+
+		    if (executor != nullptr)
+		    {
+			    reactor.add(
+			        fd,
+			        events,
+			        executor->offload(reactor, fd, events, std::move(handler))
+			    );
+		    }
+		    else
+		    {
+			    reactor.add(fd, sock::Events::READABLE, std::move(handler));
+		    }
+	    }
+	);
+
+	std::thread loop {
+	    [&reactor]()
+	    {
+		    reactor.run();
+	    }};
+
+	std::vector<double> latencies;
+	std::mutex mutex;
+	std::vector<std::thread> clients;
+
+	for (int i = 0; i < connections; i++)
+	{
+		clients.emplace_back(
+		    client,
+		    std::atoi(port),
+		    requests,
+		    slow_every,
+		    std::ref(latencies),
+		    std::ref(mutex)
+		);
+	}
+
+	for (auto& t : clients)
+	{
+		t.join();
+	}
+
+	reactor.stop();
+	loop.join();
+
+	std::sort(latencies.begin(), latencies.end());
+
+	const auto at = [&latencies](double q)
+	{
+		return latencies[static_cast<size_t>(q * (latencies.size() - 1))];
+	};
+
+	std::printf(
+	    "%-18s p50=%8.1fus p99=%8.1fus p99.9=%8.1fus max=%8.1fus\n",
+	    name,
+	    at(0.5),
+	    at(0.99),
+	    at(0.999),
+	    latencies.back()
+	);
+}
+
+int main(int argc, char** argv)
+{
+	const int connections = argc > 1 ? std::atoi(argv[1]) : 16;
+	const int requests = argc > 2 ? std::atoi(argv[2]) : 500;
+	const int slow_every = argc > 3 ? std::atoi(argv[3]) : 50;
+
+	bench("inline", "13851", nullptr, connections, requests, slow_every);
+
+	sock::Executor executor {
+	    std::max(4u, std::thread::hardware_concurrency())};
+	bench("work-stealing", "13852", &executor, connections, requests, slow_every);
+
+	std::printf("steals=%lu\n", executor.steals());
+
+	return 0;
+}
@@ -0,0 +1,89 @@
+// Decoding throughput of `sock::FrameDecoder`, in frames per second, for
+// every prefix and a few payload sizes. A 1 MiB encoded stream, cache hot
+// like freshly received bytes, is fed over and over in chunks of
+// `sock::Buffer::MAX` bytes, as `receive()` would hand it out, so frames
+// regularly straddle reads.
+//
+// Usage: sock_bench_framing [megabytes]
+
+#include "sock/buffer.hpp"
+#include "sock/framing.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using Clock = std::chrono::steady_clock;
+
+static auto name(sock::Prefix prefix) -> const char*
+{
+	switch (prefix)
+	{
+		case sock::Prefix::U16:
+			return "u16";
+		case sock::Prefix::U32:
+			return "u32";
+		case sock::Prefix::VARINT:
+			return "varint";
+	}
+
+	return "?";
+}
+
+static auto run(sock::Prefix prefix, size_t payload_size, size_t megabytes)
+    -> void
+{
+	const sock::FrameEncoder encoder {prefix};
+	const std::string payload(payload_size, 'x');
+	std::string stream;
+
+	while (stream.size() < 1024 * 1024)
+	{
+		encoder.encode(payload, stream);
+	}
+
+	sock::FrameDecoder decoder {prefix};
+	size_t frames = 0;
+	size_t bytes = 0;
+	const auto start = Clock::now();
+
+	for (size_t round = 0; round < megabytes; round++)
+	{
+		for (size_t offset = 0; offset < stream.size(); offset += sock::Buffer::MAX)
+		{
+			decoder.feed(std::string_view {stream}.substr(offset, sock::Buffer::MAX));
+
+			while (const auto frame = decoder.next())
+			{
+				frames++;
+				bytes += frame->size();
+			}
+		}
+	}
+
+	const std::chrono::duration<double> took = Clock::now() - start;
+
+	std::printf(
+	    "%-7s %6zu B payload: %8.2f M frames/s %8.2f GB/s (%zu frames)\n",
+	    name(prefix),
+	    payload_size,
+	    frames / took.count() / 1e6,
+	    bytes / took.count() / 1e9,
+	    frames
+	);
+}
+
+int main(int argc, char** argv)
+{
+	const size_t megabytes = argc > 1 ? std::atoi(argv[1]) : 1024;
+
+	for (const auto prefix :
+	     {sock::Prefix::U16, sock::Prefix::U32, sock::Prefix::VARINT})
+	{
+		for (const size_t size : {16, 256, 4096})
+		{
+			run(prefix, size, megabytes);
+		}
+	}
+}
@@ -0,0 +1,162 @@
+// Loopback requests per second of sock::HttpServer on one core, with
+// keep-alive connections answered one request at a time, then with
+// pipelined batches of requests.
+//
+// Usage: sock_bench_http [connections] [rounds] [pipeline depth]
+
+#include "sock/http.hpp"
+#include "sock/runtime.hpp"
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+static constexpr sock::CtorArgs TCP {
+    .domain = sock::Domain::INET,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::TCP,
+    .flags = sock::Flags::PASSIVE,
+};
+
+static constexpr std::string_view REQUEST {
+    "GET /plaintext HTTP/1.1\r\n"
+    "Host: 127.0.0.1\r\n"
+    "User-Agent: sock_bench_http\r\n"
+    "Accept: text/plain\r\n"
+    "Connection: keep-alive\r\n"
+    "\r\n"};
+
+static constexpr std::string_view RESPONSE {
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Length: 13\r\n"
+    "Content-Type: text/plain\r\n"
+    "\r\n"
+    "Hello, World!"};
+
+// Every connection sends `depth` requests at once and reads all their
+// responses before the next round. Raw syscalls keep the client cheap.
+static auto drive(int connections, int rounds, int depth) -> bool
+{
+	sockaddr_in address {};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(13861);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	std::vector<int> fds;
+
+	for (int i = 0; i < connections; i++)
+	{
+		const auto fd = socket(AF_INET, SOCK_STREAM, 0);
+		const int one = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+		if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
+		{
+			return false;
+		}
+
+		fds.push_back(fd);
+	}
+
+	std::string requests;
+
+	for (int i = 0; i < depth; i++)
+	{
+		requests.append(REQUEST);
+	}
+
+	const auto expected = RESPONSE.size() * depth;
+	std::vector<char> buff(expected);
+	bool ok = true;
+
+	for (int r = 0; r < rounds && ok; r++)
+	{
+		for (auto fd : fds)
+		{
+			send(fd, requests.data(), requests.size(), 0);
+		}
+
+		for (auto fd : fds)
+		{
+			for (size_t received = 0; received < expected;)
+			{
+				const auto n = recv(fd, buff.data(), expected - received, 0);
+
+				if (n <= 0)
+				{
+					ok = false;
+					break;
+				}
+
+				received += n;
+			}
+		}
+	}
+
+	for (auto fd : fds)
+	{
+		close(fd);
+	}
+
+	return ok;
+}
+
+static auto bench(int connections, int rounds, int depth) -> void
+{
+	sock::HttpServer server {
+	    [](const sock::HttpRequest&, sock::HttpResponse& response)
+	    {
+		    response.header("Content-Type", "text/plain");
+		    response.body = "Hello, World!";
+	    }};
+	sock::Runtime runtime {{.cores = 1}};
+	runtime.listen(TCP, {.host = "127.0.0.1", .port = "13861"}, server.acceptor());
+
+	if (runtime.status() != sock::Status::GOOD)
+	{
+		std::printf("runtime: %s\n", sock::str_status(runtime.status()).data());
+		std::exit(1);
+	}
+
+	runtime.start();
+
+	const auto start = std::chrono::steady_clock::now();
+	const auto ok = drive(connections, rounds, depth);
+	const std::chrono::duration<double> elapsed =
+	    std::chrono::steady_clock::now() - start;
+
+	runtime.stop();
+
+	if (!ok)
+	{
+		std::printf("depth=%-3d failed\n", depth);
+		std::exit(1);
+	}
+
+	const auto requests = server.metrics().requests.load();
+
+	std::printf(
+	    "depth=%-3d requests/s=%-10.0f requests/write=%.1f\n",
+	    depth,
+	    requests / elapsed.count(),
+	    static_cast<double>(requests) / server.metrics().writes
+	);
+}
+
+int main(int argc, char** argv)
+{
+	const int connections = argc > 1 ? std::atoi(argv[1]) : 32;
+	const int rounds = argc > 2 ? std::atoi(argv[2]) : 2000;
+	const int depth = argc > 3 ? std::atoi(argv[3]) : 16;
+
+	bench(connections, rounds, 1);
+	bench(connections, rounds, depth);
+
+	return 0;
+}
@@ -0,0 +1,186 @@
+// Echo throughput and server CPU time of the io_uring and epoll engines.
+//
+// Usage: sock_bench_io_engine [connections] [rounds]
+
+#include "sock/io_engine.hpp"
+#include "sock/reactor.hpp"
+#include "sock/socket_factory.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <sys/resource.h>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+static constexpr sock::CtorArgs TCP {
+    .domain = sock::Domain::INET,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::TCP,
+    .flags = sock::Flags::PASSIVE,
+};
+
+static auto thread_cpu_time() -> std::chrono::duration<double>
+{
+	rusage usage;
+	getrusage(RUSAGE_THREAD, &usage);
+
+	return std::chrono::seconds {usage.ru_utime.tv_sec + usage.ru_stime.tv_sec}
+	     + std::chrono::microseconds {
+	           usage.ru_utime.tv_usec + usage.ru_stime.tv_usec
+	       };
+}
+
+static auto drive_clients(const char* port, int connections, int rounds)
+    -> void
+{
+	sock::Reactor reactor;
+	std::vector<sock::Socket> clients;
+	std::vector<int> remaining(connections, rounds);
+	int finished = 0;
+
+	clients.reserve(connections);
+
+	for (int i = 0; i < connections; i++)
+	{
+		auto& client = clients.emplace_back(
+		    sock::SocketFactory::instance().create(TCP)
+		);
+		client.connect({.host = "127.0.0.1", .port = port});
+		client.send("ping");
+
+		reactor.add(
+		    client,
+		    sock::Events::READABLE,
+		    [&, i](uint32_t)
+		    {
+			    sock::Buffer buff;
+			    clients[i].receive(buff);
+
+			    if (--remaining[i] > 0)
+			    {
+				    clients[i].send("ping");
+			    }
+			    else
+			    {
+				    reactor.remove(clients[i].native_handle());
+
+				    if (++finished == connections)
+				    {
+					    reactor.stop();
+				    }
+			    }
+		    }
+		);
+	}
+
+	reactor.run();
+}
+
+static auto bench(
+    sock::Engine kind,
+    const char* port,
+    int connections,
+    int rounds
+) -> void
+{
+	auto engine = sock::make_io_engine(kind);
+
+	auto server = sock::SocketFactory::instance().create(TCP);
+	server.option(sock::Option::REUSEADDR, 1);
+	server.bind({.host = "127.0.0.1", .port = port});
+	server.listen(connections);
+
+	// Echo replies must outlive their send completions.
+	std::unordered_map<int, std::string> replies;
+	std::atomic<int> closed = 0;
+	std::chrono::duration<double> cpu {};
+
+	engine->accept(
+	    server.native_handle(),
+	    [&](const sock::Completion& accepted)
+	    {
+		    if (accepted.result < 0)
+		    {
+			    return;
+		    }
+
+		    const auto fd = accepted.result;
+
+		    engine->receive(
+		        fd,
+		        [&, fd](const sock::Completion& c)
+		        {
+			        if (c.result <= 0)
+			        {
+				        engine->close(
+				            fd,
+				            [&closed](const sock::Completion&)
+				            {
+					            closed++;
+				            }
+				        );
+				        return;
+			        }
+
+			        auto& reply = replies[fd];
+			        reply.assign(c.data);
+			        engine->send(
+			            fd,
+			            reply,
+			            [](const sock::Completion&)
+			            {}
+			        );
+		        }
+		    );
+	    }
+	);
+
+	std::thread loop {
+	    [&]()
+	    {
+		    const auto start = thread_cpu_time();
+
+		    while (closed < connections)
+		    {
+			    engine->run_once(std::chrono::milliseconds {100});
+		    }
+
+		    cpu = thread_cpu_time() - start;
+	    }};
+
+	const auto start = std::chrono::steady_clock::now();
+	drive_clients(port, connections, rounds);
+	const std::chrono::duration<double> elapsed =
+	    std::chrono::steady_clock::now() - start;
+
+	loop.join();
+
+	const auto messages = static_cast<double>(connections) * rounds;
+
+	std::printf(
+	    "%-9s time=%.3fs msgs/s=%.0f server-cpu/msg=%.2fus\n",
+	    sock::str_engine(engine->kind()).data(),
+	    elapsed.count(),
+	    messages / elapsed.count(),
+	    cpu.count() * 1e6 / messages
+	);
+}
+
+int main(int argc, char** argv)
+{
+	const int connections = argc > 1 ? std::atoi(argv[1]) : 200;
+	const int rounds = argc > 2 ? std::atoi(argv[2]) : 200;
+
+	rlimit limit;
+	getrlimit(RLIMIT_NOFILE, &limit);
+	limit.rlim_cur = limit.rlim_max;
+	setrlimit(RLIMIT_NOFILE, &limit);
+
+	bench(sock::Engine::IO_URING, "13845", connections, rounds);
+	bench(sock::Engine::EPOLL, "13846", connections, rounds);
+
+	return 0;
+}
@@ -0,0 +1,171 @@
+// Accept rate of one shared listener versus a SO_REUSEPORT listener group
+// with one pinned accept thread per core.
+//
+// Usage: sock_bench_listener_group [connections] [client-threads]
+
+#include "sock/listener_group.hpp"
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static constexpr sock::CtorArgs TCP {
+    .domain = sock::Domain::INET,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::TCP,
+    .flags = sock::Flags::PASSIVE,
+};
+
+static auto pin(size_t cpu) -> void
+{
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu % std::thread::hardware_concurrency(), &set);
+	sched_setaffinity(0, sizeof(set), &set);
+}
+
+// Raw syscalls keep name resolution out of the measured loop.
+static auto storm(uint16_t port, int connections) -> void
+{
+	sockaddr_in address {};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	const linger reset {.l_onoff = 1, .l_linger = 0};
+
+	for (int i = 0; i < connections; i++)
+	{
+		const auto fd = socket(AF_INET, SOCK_STREAM, 0);
+		connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+		// Reset instead of lingering in TIME_WAIT, or the ephemeral
+		// ports run out.
+		setsockopt(fd, SOL_SOCKET, SO_LINGER, &reset, sizeof(reset));
+		close(fd);
+	}
+}
+
+static auto bench(
+    const char* name,
+    const char* port,
+    size_t listeners,
+    bool steer,
+    int connections,
+    int client_threads
+) -> void
+{
+	sock::ListenerGroup group {
+	    TCP,
+	    {.host = "127.0.0.1", .port = port},
+	    listeners,
+	    {.steer_by_cpu = steer}};
+
+	if (group.status() != sock::Status::GOOD)
+	{
+		std::printf("%s: %s\n", name, sock::str_status(group.status()).data());
+		return;
+	}
+
+	std::atomic<bool> storming = true;
+	std::atomic<long> accepted = 0;
+	std::atomic<long> last_accept = 0;
+	const auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> workers;
+
+	for (size_t i = 0; i < listeners; i++)
+	{
+		workers.emplace_back(
+		    [&, i]()
+		    {
+			    pin(i);
+			    pollfd fd {
+			        .fd = group.listener(i).native_handle(),
+			        .events = POLLIN};
+
+			    // Drain until the clients are done and the queue is idle.
+			    while (poll(&fd, 1, 100) > 0 || storming)
+			    {
+				    if (fd.revents & POLLIN)
+				    {
+					    group.listener(i).accept();
+					    accepted++;
+					    last_accept = std::chrono::duration_cast<
+					                      std::chrono::nanoseconds>(
+					                      std::chrono::steady_clock::now()
+					                      - start
+					    )
+					                      .count();
+				    }
+			    }
+		    }
+		);
+	}
+
+	std::vector<std::thread> clients;
+
+	for (int i = 0; i < client_threads; i++)
+	{
+		clients.emplace_back(
+		    [&, i]()
+		    {
+			    pin(i);
+			    storm(std::atoi(port), connections / client_threads);
+		    }
+		);
+	}
+
+	for (auto& t : clients)
+	{
+		t.join();
+	}
+
+	storming = false;
+
+	for (auto& t : workers)
+	{
+		t.join();
+	}
+
+	const auto elapsed = last_accept / 1e9;
+
+	std::printf(
+	    "%-22s listeners=%zu accepted=%ld time=%.3fs accepts/s=%.0f\n",
+	    name,
+	    listeners,
+	    accepted.load(),
+	    elapsed,
+	    accepted / elapsed
+	);
+}
+
+int main(int argc, char** argv)
+{
+	const int connections = argc > 1 ? std::atoi(argv[1]) : 20000;
+	const int cores = std::thread::hardware_concurrency();
+	const int client_threads = argc > 2 ? std::atoi(argv[2]) : cores;
+
+	rlimit limit;
+	getrlimit(RLIMIT_NOFILE, &limit);
+	limit.rlim_cur = limit.rlim_max;
+	setrlimit(RLIMIT_NOFILE, &limit);
+
+	bench("single listener", "13847", 1, false, connections, client_threads);
+
+	for (int n = 2; n <= cores; n *= 2)
+	{
+		bench("reuseport", "13848", n, false, connections, client_threads);
+	}
+
+	bench("reuseport+cpu steering", "13849", cores, true, connections, client_threads);
+
+	return 0;
+}
@@ -0,0 +1,203 @@
+// Round-trip latency and bulk throughput of AF_UNIX sockets against TCP
+// over loopback, all set up through the same `sock::Socket` API.
+//
+// Usage: sock_bench_local_socket [round-trips] [megabytes]
+
+#include "sock/socket_factory.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+struct Transport
+{
+	const char* name;
+	sock::CtorArgs args;
+	sock::Address address;
+	bool stream;
+};
+
+static auto connected_pair(const Transport& transport)
+    -> std::pair<sock::Socket, sock::Socket>
+{
+	auto server = sock::SocketFactory::instance().create(transport.args);
+	server.option(sock::Option::REUSEADDR, 1);
+	server.bind(transport.address);
+	server.listen(1);
+
+	auto client = sock::SocketFactory::instance().create(transport.args);
+	client.connect(transport.address);
+
+	auto peer = server.accept();
+
+	if (transport.args.domain == sock::Domain::INET)
+	{
+		const int one = 1;
+
+		for (const auto fd : {client.native_handle(), peer.native_handle()})
+		{
+			setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+		}
+	}
+
+	return {std::move(client), std::move(peer)};
+}
+
+static auto latency(const Transport& transport, int round_trips) -> void
+{
+	auto [client, peer] = connected_pair(transport);
+	const auto peer_fd = peer.native_handle();
+
+	std::thread echo {
+	    [peer_fd, round_trips]()
+	    {
+		    char byte;
+
+		    for (int i = 0; i < round_trips; i++)
+		    {
+			    recv(peer_fd, &byte, 1, 0);
+			    send(peer_fd, &byte, 1, MSG_NOSIGNAL);
+		    }
+	    }};
+
+	std::vector<double> samples;
+	samples.reserve(round_trips);
+
+	for (int i = 0; i < round_trips; i++)
+	{
+		char byte = 'x';
+		const auto start = Clock::now();
+		send(client.native_handle(), &byte, 1, MSG_NOSIGNAL);
+		recv(client.native_handle(), &byte, 1, 0);
+		const std::chrono::duration<double, std::micro> took =
+		    Clock::now() - start;
+		samples.push_back(took.count());
+	}
+
+	echo.join();
+	std::sort(samples.begin(), samples.end());
+
+	std::printf(
+	    "%-16s round trip p50=%6.1fus p99=%6.1fus\n",
+	    transport.name,
+	    samples[samples.size() / 2],
+	    samples[samples.size() * 99 / 100]
+	);
+}
+
+static auto throughput(const Transport& transport, size_t megabytes) -> void
+{
+	constexpr size_t chunk = 64 * 1024;
+	const size_t total = megabytes * 1024 * 1024;
+
+	auto [client, peer] = connected_pair(transport);
+	const auto peer_fd = peer.native_handle();
+
+	std::thread sink {
+	    [peer_fd, total]()
+	    {
+		    std::vector<char> buff(chunk);
+		    size_t received = 0;
+
+		    while (received < total)
+		    {
+			    const auto n = recv(peer_fd, buff.data(), buff.size(), 0);
+
+			    if (n <= 0)
+			    {
+				    break;
+			    }
+
+			    received += n;
+		    }
+	    }};
+
+	const std::string payload(chunk, 'x');
+	const auto start = Clock::now();
+
+	for (size_t sent = 0; sent < total;)
+	{
+		const auto n = send(
+		    client.native_handle(),
+		    payload.data(),
+		    std::min(chunk, total - sent),
+		    MSG_NOSIGNAL
+		);
+
+		if (n <= 0)
+		{
+			break;
+		}
+
+		sent += n;
+	}
+
+	sink.join();
+
+	const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+	std::printf(
+	    "%-16s throughput %8.0f MiB/s\n",
+	    transport.name,
+	    megabytes / elapsed.count()
+	);
+}
+
+int main(int argc, char** argv)
+{
+	const int round_trips = argc > 1 ? std::atoi(argv[1]) : 50000;
+	const size_t megabytes = argc > 2 ? std::atoi(argv[2]) : 1024;
+	const auto name = "@sock-bench-" + std::to_string(getpid());
+	const auto stream_name = name + "-stream";
+	const auto seqpacket_name = name + "-seqpacket";
+
+	const Transport transports[] {
+	    {.name = "tcp-loopback",
+	     .args =
+	         {.domain = sock::Domain::INET,
+	          .type = sock::Type::STREAM,
+	          .protocol = sock::Protocol::TCP,
+	          .flags = sock::Flags::PASSIVE},
+	     .address = {.host = "127.0.0.1", .port = "13859"},
+	     .stream = true},
+	    {.name = "unix-stream",
+	     .args =
+	         {.domain = sock::Domain::LOCAL,
+	          .type = sock::Type::STREAM,
+	          .protocol = sock::Protocol::DEFAULT},
+	     .address = {.host = stream_name},
+	     .stream = true},
+	    {.name = "unix-seqpacket",
+	     .args =
+	         {.domain = sock::Domain::LOCAL,
+	          .type = sock::Type::SEQPACKET,
+	          .protocol = sock::Protocol::DEFAULT},
+	     .address = {.host = seqpacket_name},
+	     .stream = false},
+	};
+
+	for (const auto& transport : transports)
+	{
+		latency(transport, round_trips);
+	}
+
+	// Message boundaries make bulk transfer meaningless for seqpacket.
+	for (const auto& transport : transports)
+	{
+		if (transport.stream)
+		{
+			throughput(transport, megabytes);
+		}
+	}
+
+	return 0;
+}
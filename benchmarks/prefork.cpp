@@ -0,0 +1,133 @@
+// Accept throughput of the pre-fork model: one acceptor process handing
+// connections over SCM_RIGHTS to a varying amount of worker processes,
+// which answer each with one byte.
+//
+// Usage: sock_bench_prefork [connections] [client-threads]
+
+#include "sock/prefork.hpp"
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static constexpr sock::CtorArgs TCP {
+    .domain = sock::Domain::INET,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::TCP,
+    .flags = sock::Flags::PASSIVE,
+};
+
+// Raw syscalls keep name resolution out of the measured loop.
+static auto storm(uint16_t port, int connections) -> void
+{
+	sockaddr_in address {};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	const linger reset {.l_onoff = 1, .l_linger = 0};
+
+	for (int i = 0; i < connections; i++)
+	{
+		const auto fd = socket(AF_INET, SOCK_STREAM, 0);
+		connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+
+		// Wait for the worker, so each connection made the whole trip.
+		char byte;
+		recv(fd, &byte, 1, 0);
+
+		// Reset instead of lingering in TIME_WAIT, or the ephemeral
+		// ports run out.
+		setsockopt(fd, SOL_SOCKET, SO_LINGER, &reset, sizeof(reset));
+		close(fd);
+	}
+}
+
+static auto bench(
+    const char* port,
+    size_t workers,
+    int connections,
+    int client_threads
+) -> void
+{
+	sock::Prefork prefork {
+	    TCP,
+	    {.host = "127.0.0.1", .port = port},
+	    [](size_t, sock::FdChannel& channel)
+	    {
+		    std::vector<sock::Handoff> batch;
+
+		    while (channel.receive(batch) > 0)
+		    {
+			    for (auto& handoff : batch)
+			    {
+				    handoff.socket.send("x");
+			    }
+
+			    batch.clear();
+		    }
+	    },
+	    {.workers = workers}};
+
+	if (prefork.status() != sock::Status::GOOD)
+	{
+		std::printf("%s\n", sock::str_status(prefork.status()).data());
+		return;
+	}
+
+	prefork.start();
+
+	std::thread acceptor {
+	    [&prefork]()
+	    {
+		    prefork.run();
+	    }};
+
+	const auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> clients;
+
+	for (int i = 0; i < client_threads; i++)
+	{
+		clients.emplace_back(
+		    storm,
+		    std::atoi(port),
+		    connections / client_threads
+		);
+	}
+
+	for (auto& client : clients)
+	{
+		client.join();
+	}
+
+	const std::chrono::duration<double> elapsed =
+	    std::chrono::steady_clock::now() - start;
+
+	prefork.stop();
+	acceptor.join();
+
+	std::printf(
+	    "workers=%zu handed-off=%lu %.0f conn/s\n",
+	    workers,
+	    prefork.handed_off(),
+	    prefork.handed_off() / elapsed.count()
+	);
+}
+
+int main(int argc, char** argv)
+{
+	const int connections = argc > 1 ? std::atoi(argv[1]) : 20000;
+	const int client_threads = argc > 2 ? std::atoi(argv[2]) : 4;
+
+	bench("13856", 1, connections, client_threads);
+	bench("13857", 2, connections, client_threads);
+	bench("13858", 4, connections, client_threads);
+
+	return 0;
+}
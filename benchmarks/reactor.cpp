@@ -0,0 +1,225 @@
+// Compares echo throughput of a thread-per-connection server with a single
+// threaded `sock::Reactor` server.
+//
+// Usage: sock_bench_reactor [connections] [rounds]
+
+#include "sock/reactor.hpp"
+#include "sock/socket_factory.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <sys/resource.h>
+#include <thread>
+#include <vector>
+
+static constexpr sock::CtorArgs TCP {
+    .domain = sock::Domain::INET,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::TCP,
+    .flags = sock::Flags::PASSIVE,
+};
+
+static auto listen_on(const char* port, int backlog) -> sock::Socket
+{
+	auto server = sock::SocketFactory::instance().create(TCP);
+	server.option(sock::Option::REUSEADDR, 1);
+	server.bind({.host = "127.0.0.1", .port = port});
+	server.listen(backlog);
+
+	return server;
+}
+
+// Opens `connections` clients and plays `rounds` of ping-pong on each of
+// them, all driven by one reactor so the client side is never the
+// bottleneck of the comparison.
+static auto drive_clients(const char* port, int connections, int rounds)
+    -> std::chrono::duration<double>
+{
+	sock::Reactor reactor;
+	std::vector<sock::Socket> clients;
+	std::vector<int> remaining(connections, rounds);
+	int finished = 0;
+
+	clients.reserve(connections);
+
+	const auto start = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < connections; i++)
+	{
+		auto& client = clients.emplace_back(
+		    sock::SocketFactory::instance().create(TCP)
+		);
+		client.connect({.host = "127.0.0.1", .port = port});
+		client.send("ping");
+
+		reactor.add(
+		    client,
+		    sock::Events::READABLE,
+		    [&, i](uint32_t)
+		    {
+			    sock::Buffer buff;
+			    clients[i].receive(buff);
+
+			    if (--remaining[i] > 0)
+			    {
+				    clients[i].send("ping");
+			    }
+			    else
+			    {
+				    reactor.remove(clients[i].native_handle());
+
+				    if (++finished == connections)
+				    {
+					    reactor.stop();
+				    }
+			    }
+		    }
+		);
+	}
+
+	reactor.run();
+
+	return std::chrono::steady_clock::now() - start;
+}
+
+static auto echo(sock::Socket& connection) -> bool
+{
+	sock::Buffer buff;
+	connection.receive(buff);
+
+	if (buff.received_size() == 0)
+	{
+		return false;
+	}
+
+	connection.send(buff.view());
+
+	return true;
+}
+
+static auto bench_threads(int connections, int rounds)
+    -> std::chrono::duration<double>
+{
+	auto server = listen_on("13843", connections);
+	std::vector<std::thread> workers;
+
+	std::thread acceptor {
+	    [&]()
+	    {
+		    for (int i = 0; i < connections; i++)
+		    {
+			    workers.emplace_back(
+			        [connection = server.accept()]() mutable
+			        {
+				        while (echo(connection))
+				        {}
+			        }
+			    );
+		    }
+	    }};
+
+	const auto elapsed = drive_clients("13843", connections, rounds);
+
+	acceptor.join();
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+
+	return elapsed;
+}
+
+static auto bench_reactor(int connections, int rounds)
+    -> std::chrono::duration<double>
+{
+	auto server = listen_on("13844", connections);
+	server.non_blocking(true);
+
+	sock::Reactor reactor;
+	std::vector<std::unique_ptr<sock::Socket>> accepted;
+	std::atomic<int> closed = 0;
+
+	reactor.add(
+	    server,
+	    sock::Events::READABLE,
+	    [&](uint32_t)
+	    {
+		    auto& connection = *accepted.emplace_back(
+		        std::make_unique<sock::Socket>(server.accept())
+		    );
+		    reactor.add(
+		        connection,
+		        sock::Events::READABLE,
+		        [&](uint32_t)
+		        {
+			        if (!echo(connection))
+			        {
+				        reactor.remove(connection.native_handle());
+
+				        if (++closed == connections)
+				        {
+					        reactor.stop();
+				        }
+			        }
+		        }
+		    );
+	    }
+	);
+
+	std::thread loop {
+	    [&reactor]()
+	    {
+		    reactor.run();
+	    }};
+
+	const auto elapsed = drive_clients("13844", connections, rounds);
+
+	loop.join();
+
+	return elapsed;
+}
+
+static auto report(
+    const char* name,
+    int server_threads,
+    int connections,
+    int rounds,
+    std::chrono::duration<double> elapsed
+) -> void
+{
+	std::printf(
+	    "%-10s threads=%-6d conns/thread=%-8.1f time=%.3fs msgs/s=%.0f\n",
+	    name,
+	    server_threads,
+	    static_cast<double>(connections) / server_threads,
+	    elapsed.count(),
+	    connections * static_cast<double>(rounds) / elapsed.count()
+	);
+}
+
+int main(int argc, char** argv)
+{
+	const int connections = argc > 1 ? std::atoi(argv[1]) : 500;
+	const int rounds = argc > 2 ? std::atoi(argv[2]) : 100;
+
+	// Both sides of every connection live in this process.
+	rlimit limit;
+	getrlimit(RLIMIT_NOFILE, &limit);
+	limit.rlim_cur = limit.rlim_max;
+	setrlimit(RLIMIT_NOFILE, &limit);
+
+	sock::SocketFactory::instance();
+
+	report(
+	    "threads",
+	    connections + 1,
+	    connections,
+	    rounds,
+	    bench_threads(connections, rounds)
+	);
+	report("reactor", 1, connections, rounds, bench_reactor(connections, rounds));
+
+	return 0;
+}
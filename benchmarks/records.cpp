@@ -0,0 +1,154 @@
+// Delimiter search of `sock::find_delimiter()`, with every instruction
+// set the CPU has, against `std::string_view::find`, over a cache hot
+// 1 MiB buffer of `"\r\n"` terminated lines or NUL separated records.
+// Then `sock::RecordReader` over the same lines, fed in chunks of
+// `sock::Buffer::MAX` bytes as `receive()` would hand them out.
+//
+// Usage: sock_bench_records [average line length] [rounds]
+
+#include "sock/buffer.hpp"
+#include "sock/records.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+using Clock = std::chrono::steady_clock;
+
+static auto text(size_t average, std::string_view delimiter) -> std::string
+{
+	std::minstd_rand engine {7};
+	std::uniform_int_distribution<size_t> length {average / 2, average * 3 / 2};
+	std::string bytes;
+
+	while (bytes.size() < 1024 * 1024)
+	{
+		// Header-like text, no stray delimiter bytes.
+		const auto n = length(engine);
+
+		for (size_t i = 0; i < n; i++)
+		{
+			bytes += static_cast<char>('a' + (i * 7 + n) % 26);
+		}
+
+		bytes += delimiter;
+	}
+
+	return bytes;
+}
+
+template<class Find>
+static auto measure(const char* name, const std::string& bytes, size_t rounds, Find find)
+    -> void
+{
+	const std::string_view view {bytes};
+	size_t records = 0;
+	const auto start = Clock::now();
+
+	for (size_t round = 0; round < rounds; round++)
+	{
+		for (size_t from = 0;;)
+		{
+			const auto found = find(view.substr(from));
+
+			if (found == std::string_view::npos)
+			{
+				break;
+			}
+
+			records++;
+			from += found + 1;
+		}
+	}
+
+	const std::chrono::duration<double> took = Clock::now() - start;
+
+	std::printf(
+	    "  %-18s %8.2f GB/s %8.2f M records/s\n",
+	    name,
+	    bytes.size() * rounds / took.count() / 1e9,
+	    records / took.count() / 1e6
+	);
+}
+
+static auto search(std::string_view delimiter, size_t average, size_t rounds)
+    -> void
+{
+	const auto bytes = text(average, delimiter);
+
+	std::printf(
+	    "%s, %zu bytes per record:\n",
+	    delimiter.size() == 2 ? "\"\\r\\n\"" : "NUL",
+	    average
+	);
+
+	measure(
+	    "string_view::find",
+	    bytes,
+	    rounds,
+	    [delimiter](std::string_view view)
+	    {
+		    return view.find(delimiter);
+	    }
+	);
+
+	for (const auto isa : {sock::Isa::PORTABLE, sock::Isa::SSE2, sock::Isa::AVX2})
+	{
+		if (isa > sock::best_isa())
+		{
+			continue;
+		}
+
+		measure(
+		    sock::str_isa(isa).data(),
+		    bytes,
+		    rounds,
+		    [delimiter, isa](std::string_view view)
+		    {
+			    return sock::find_delimiter(view, delimiter, isa);
+		    }
+		);
+	}
+}
+
+static auto read(size_t average, size_t rounds) -> void
+{
+	const auto bytes = text(average, "\r\n");
+	const std::string_view view {bytes};
+	sock::RecordReader reader;
+	size_t records = 0;
+	const auto start = Clock::now();
+
+	for (size_t round = 0; round < rounds; round++)
+	{
+		for (size_t offset = 0; offset < view.size(); offset += sock::Buffer::MAX)
+		{
+			reader.feed(view.substr(offset, sock::Buffer::MAX));
+
+			while (reader.next())
+			{
+				records++;
+			}
+		}
+	}
+
+	const std::chrono::duration<double> took = Clock::now() - start;
+
+	std::printf(
+	    "RecordReader, %s: %8.2f GB/s %8.2f M records/s\n",
+	    sock::str_isa(sock::best_isa()).data(),
+	    bytes.size() * rounds / took.count() / 1e9,
+	    records / took.count() / 1e6
+	);
+}
+
+int main(int argc, char** argv)
+{
+	const size_t average = argc > 1 ? std::atoi(argv[1]) : 64;
+	const size_t rounds = argc > 2 ? std::atoi(argv[2]) : 200;
+
+	search("\r\n", average, rounds);
+	search({"\0", 1}, average, rounds);
+	read(average, rounds);
+}
@@ -0,0 +1,153 @@
+// Loopback echo throughput of sock::Runtime with 1..N cores.
+//
+// Usage: sock_bench_runtime [connections-per-core] [rounds]
+
+#include "sock/runtime.hpp"
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static constexpr sock::CtorArgs TCP {
+    .domain = sock::Domain::INET,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::TCP,
+    .flags = sock::Flags::PASSIVE,
+};
+
+static auto serve_echo(sock::Core& core, sock::Socket&& accepted) -> void
+{
+	auto conn = std::make_shared<sock::Socket>(std::move(accepted));
+
+	core.reactor().add(
+	    *conn,
+	    sock::Events::READABLE,
+	    [&core, conn](uint32_t)
+	    {
+		    auto buff = core.buffers().acquire();
+		    conn->receive(*buff);
+
+		    if (buff->received_size() == 0)
+		    {
+			    core.reactor().remove(conn->native_handle());
+			    return;
+		    }
+
+		    conn->send(buff->view());
+	    }
+	);
+}
+
+// One blocking ping-pong client thread per core, each with its share of
+// the connections. Raw syscalls keep client overhead small.
+static auto drive(uint16_t port, int connections, int rounds) -> void
+{
+	sockaddr_in address {};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	std::vector<int> fds;
+
+	for (int i = 0; i < connections; i++)
+	{
+		const auto fd = socket(AF_INET, SOCK_STREAM, 0);
+		const int one = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+		connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+		fds.push_back(fd);
+	}
+
+	char buff[64];
+
+	for (int r = 0; r < rounds; r++)
+	{
+		for (auto fd : fds)
+		{
+			send(fd, "ping", 4, 0);
+		}
+
+		for (auto fd : fds)
+		{
+			recv(fd, buff, sizeof(buff), 0);
+		}
+	}
+
+	for (auto fd : fds)
+	{
+		close(fd);
+	}
+}
+
+static auto bench(size_t cores, int connections, int rounds) -> double
+{
+	sock::Runtime runtime {{.cores = cores}};
+	runtime.listen(TCP, {.host = "127.0.0.1", .port = "13850"}, serve_echo);
+
+	if (runtime.status() != sock::Status::GOOD)
+	{
+		std::printf("runtime: %s\n", sock::str_status(runtime.status()).data());
+		std::exit(1);
+	}
+
+	runtime.start();
+
+	const auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> clients;
+
+	for (size_t i = 0; i < cores; i++)
+	{
+		clients.emplace_back(drive, 13850, connections, rounds);
+	}
+
+	for (auto& t : clients)
+	{
+		t.join();
+	}
+
+	const std::chrono::duration<double> elapsed =
+	    std::chrono::steady_clock::now() - start;
+
+	runtime.stop();
+
+	const auto messages = static_cast<double>(cores) * connections * rounds;
+
+	return messages / elapsed.count();
+}
+
+int main(int argc, char** argv)
+{
+	const int connections = argc > 1 ? std::atoi(argv[1]) : 50;
+	const int rounds = argc > 2 ? std::atoi(argv[2]) : 2000;
+	const size_t max_cores = std::thread::hardware_concurrency();
+
+	rlimit limit;
+	getrlimit(RLIMIT_NOFILE, &limit);
+	limit.rlim_cur = limit.rlim_max;
+	setrlimit(RLIMIT_NOFILE, &limit);
+
+	double base = 0;
+
+	for (size_t cores = 1; cores <= max_cores; cores *= 2)
+	{
+		const auto rate = bench(cores, connections, rounds);
+		base = base > 0 ? base : rate;
+
+		std::printf(
+		    "cores=%-3zu msgs/s=%-9.0f scaling=%.2fx\n",
+		    cores,
+		    rate,
+		    rate / base
+		);
+	}
+
+	return 0;
+}
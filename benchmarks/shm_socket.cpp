@@ -0,0 +1,201 @@
+// Shared-memory transport against AF_UNIX and TCP over loopback, every
+// transport driven through the same socket interface: round-trip latency
+// of small messages and bulk throughput.
+//
+// Usage: sock_bench_shm_socket [round-trips] [megabytes]
+
+#include "sock/shm_socket.hpp"
+#include "sock/socket_factory.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+template<class S>
+struct Pair
+{
+	S client;
+	S peer;
+};
+
+template<class S>
+static auto connect_pair(S server, S client, sock::Address address) -> Pair<S>
+{
+	server.option(sock::Option::REUSEADDR, 1);
+	server.bind(address);
+	server.listen(1);
+
+	// ShmSocket's accept() waits for the connecting side's handshake.
+	std::thread connecting {
+	    [&client, address]()
+	    {
+		    client.connect(address);
+	    }};
+	auto peer = server.accept();
+	connecting.join();
+
+	return {std::move(client), std::move(peer)};
+}
+
+template<class S>
+static auto latency(const char* name, Pair<S>& pair, int round_trips) -> void
+{
+	std::thread echo {
+	    [&pair, round_trips]()
+	    {
+		    sock::Buffer buff;
+
+		    for (int i = 0; i < round_trips; i++)
+		    {
+			    pair.peer.receive(buff);
+			    pair.peer.send(buff.view());
+		    }
+	    }};
+
+	std::vector<double> samples;
+	samples.reserve(round_trips);
+	sock::Buffer buff;
+
+	for (int i = 0; i < round_trips; i++)
+	{
+		const auto start = Clock::now();
+		pair.client.send("x");
+		pair.client.receive(buff);
+		const std::chrono::duration<double, std::micro> took =
+		    Clock::now() - start;
+		samples.push_back(took.count());
+	}
+
+	echo.join();
+	std::sort(samples.begin(), samples.end());
+
+	std::printf(
+	    "%-14s round trip p50=%6.1fus p99=%6.1fus\n",
+	    name,
+	    samples[samples.size() / 2],
+	    samples[samples.size() * 99 / 100]
+	);
+}
+
+template<class S>
+static auto throughput(const char* name, Pair<S>& pair, size_t megabytes)
+    -> void
+{
+	const size_t total = megabytes * 1024 * 1024;
+
+	std::thread sink {
+	    [&pair, total]()
+	    {
+		    sock::Buffer buff;
+		    size_t received = 0;
+
+		    while (received < total)
+		    {
+			    pair.peer.receive(buff);
+
+			    if (buff.received_size() == 0)
+			    {
+				    break;
+			    }
+
+			    received += buff.received_size();
+		    }
+	    }};
+
+	const std::string payload(64 * 1024, 'x');
+	const auto start = Clock::now();
+
+	for (size_t sent = 0; sent < total; sent += payload.size())
+	{
+		pair.client.send(payload);
+	}
+
+	sink.join();
+
+	const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+	std::printf(
+	    "%-14s throughput %8.0f MiB/s\n",
+	    name,
+	    megabytes / elapsed.count()
+	);
+}
+
+template<class S>
+static auto bench(
+    const char* name,
+    Pair<S> pair,
+    int round_trips,
+    size_t megabytes
+) -> void
+{
+	latency(name, pair, round_trips);
+	throughput(name, pair, megabytes);
+}
+
+int main(int argc, char** argv)
+{
+	const int round_trips = argc > 1 ? std::atoi(argv[1]) : 50000;
+	const size_t megabytes = argc > 2 ? std::atoi(argv[2]) : 1024;
+
+	const sock::CtorArgs tcp {
+	    .domain = sock::Domain::INET,
+	    .type = sock::Type::STREAM,
+	    .protocol = sock::Protocol::TCP,
+	    .flags = sock::Flags::PASSIVE,
+	};
+	const sock::CtorArgs local {
+	    .domain = sock::Domain::LOCAL,
+	    .type = sock::Type::STREAM,
+	    .protocol = sock::Protocol::DEFAULT,
+	};
+
+	const auto& factory = sock::SocketFactory::instance();
+	const auto unix_name = "@sock-bench-unix-" + std::to_string(getpid());
+	const auto shm_name = "@sock-bench-shm-" + std::to_string(getpid());
+
+	auto tcp_pair = connect_pair(
+	    factory.create(tcp),
+	    factory.create(tcp),
+	    {.host = "127.0.0.1", .port = "13860"}
+	);
+	const int one = 1;
+
+	for (const auto fd :
+	     {tcp_pair.client.native_handle(), tcp_pair.peer.native_handle()})
+	{
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+	}
+
+	bench("tcp-loopback", std::move(tcp_pair), round_trips, megabytes);
+	bench(
+	    "unix-stream",
+	    connect_pair(
+	        factory.create(local),
+	        factory.create(local),
+	        {.host = unix_name}
+	    ),
+	    round_trips,
+	    megabytes
+	);
+	bench(
+	    "shared-memory",
+	    connect_pair(
+	        sock::ShmSocket {local},
+	        sock::ShmSocket {local},
+	        {.host = shm_name}
+	    ),
+	    round_trips,
+	    megabytes
+	);
+
+	return 0;
+}
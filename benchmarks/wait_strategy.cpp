@@ -0,0 +1,162 @@
+// Round-trip latency against server CPU use for each reactor wait
+// strategy. The client paces its requests, so a blocking server goes to
+// sleep between them and pays the wakeup on every request.
+//
+// Usage: sock_bench_wait_strategy [requests] [gap-us]
+
+#include "sock/reactor.hpp"
+#include "sock/socket_factory.hpp"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr sock::CtorArgs TCP {
+    .domain = sock::Domain::INET,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::TCP,
+    .flags = sock::Flags::PASSIVE,
+};
+
+static auto thread_cpu_time() -> std::chrono::duration<double>
+{
+	rusage usage;
+	getrusage(RUSAGE_THREAD, &usage);
+
+	return std::chrono::seconds {usage.ru_utime.tv_sec + usage.ru_stime.tv_sec}
+	     + std::chrono::microseconds {
+	           usage.ru_utime.tv_usec + usage.ru_stime.tv_usec
+	       };
+}
+
+static auto bench(
+    const char* name,
+    const char* port,
+    sock::WaitStrategy strategy,
+    int requests,
+    std::chrono::microseconds gap
+) -> void
+{
+	sock::Reactor reactor;
+	reactor.wait_strategy(strategy);
+
+	auto server = sock::SocketFactory::instance().create(TCP);
+	server.option(sock::Option::REUSEADDR, 1);
+	server.bind({.host = "127.0.0.1", .port = port});
+	server.listen(1);
+
+	std::unique_ptr<sock::Socket> conn;
+
+	reactor.add(
+	    server,
+	    sock::Events::READABLE,
+	    [&](uint32_t)
+	    {
+		    conn = std::make_unique<sock::Socket>(server.accept());
+		    reactor.add(
+		        *conn,
+		        sock::Events::READABLE,
+		        [&](uint32_t)
+		        {
+			        char byte;
+
+			        if (recv(conn->native_handle(), &byte, 1, 0) <= 0)
+			        {
+				        reactor.remove(conn->native_handle());
+				        reactor.stop();
+				        return;
+			        }
+
+			        send(conn->native_handle(), &byte, 1, MSG_NOSIGNAL);
+		        }
+		    );
+	    }
+	);
+
+	std::chrono::duration<double> cpu {};
+	std::chrono::duration<double> wall {};
+
+	std::thread loop {
+	    [&]()
+	    {
+		    const auto cpu_start = thread_cpu_time();
+		    const auto wall_start = Clock::now();
+		    reactor.run();
+		    cpu = thread_cpu_time() - cpu_start;
+		    wall = Clock::now() - wall_start;
+	    }};
+
+	sockaddr_in address {};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(std::atoi(port));
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	const auto fd = socket(AF_INET, SOCK_STREAM, 0);
+	const int one = 1;
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+	connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+
+	std::vector<double> latencies;
+	latencies.reserve(requests);
+
+	for (int i = 0; i < requests; i++)
+	{
+		// Pace without sleeping so the client's own wakeups stay out of
+		// the measurement.
+		const auto next = Clock::now() + gap;
+
+		while (Clock::now() < next)
+		{}
+
+		char byte = 'x';
+		const auto start = Clock::now();
+		send(fd, &byte, 1, 0);
+		recv(fd, &byte, 1, 0);
+		const std::chrono::duration<double, std::micro> took =
+		    Clock::now() - start;
+		latencies.push_back(took.count());
+	}
+
+	close(fd);
+	loop.join();
+
+	std::sort(latencies.begin(), latencies.end());
+
+	const auto& stats = reactor.wait_stats();
+
+	std::printf(
+	    "%-8s p50=%7.1fus p99=%7.1fus server-cpu=%5.1f%% spinning=%.0fms "
+	    "blocked=%.0fms spin-hits=%lu blocks=%lu\n",
+	    name,
+	    latencies[latencies.size() / 2],
+	    latencies[latencies.size() * 99 / 100],
+	    100 * cpu.count() / wall.count(),
+	    std::chrono::duration<double, std::milli>(stats.spinning).count(),
+	    std::chrono::duration<double, std::milli>(stats.blocked).count(),
+	    stats.spin_hits,
+	    stats.blocks
+	);
+}
+
+int main(int argc, char** argv)
+{
+	const int requests = argc > 1 ? std::atoi(argv[1]) : 20000;
+	const auto gap = std::chrono::microseconds {argc > 2 ? std::atoi(argv[2]) : 20};
+
+	bench("blocking", "13853", sock::WaitStrategy::blocking(), requests, gap);
+	bench("hybrid", "13854", sock::WaitStrategy::hybrid(), requests, gap);
+	bench("busy", "13855", sock::WaitStrategy::busy_polling(), requests, gap);
+
+	return 0;
+}
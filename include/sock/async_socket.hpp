@@ -0,0 +1,145 @@
+#ifndef SOCK_ASYNC_SOCKET_H_
+#define SOCK_ASYNC_SOCKET_H_
+
+#include "sock/buffer.hpp"
+#include "sock/endpoint.hpp"
+#include "sock/reactor.hpp"
+#include "sock/socket.hpp"
+#include "sock/task.hpp"
+#include "sock/utils.hpp"
+#include <chrono>
+#include <coroutine>
+#include <memory>
+#include <string_view>
+
+namespace sock
+{
+	/**
+	 * A `sock::Socket` driven by a `sock::Reactor` with awaitable
+	 * operations. Each operation first tries the non-blocking syscall and
+	 * only suspends when it would block.
+	 *
+	 * Must be used on the reactor thread only.
+	 */
+	class AsyncSocket
+	{
+	public:
+		AsyncSocket(Reactor&, sock::Socket&&);
+		AsyncSocket(Reactor&, CtorArgs);
+		AsyncSocket(AsyncSocket&&) = default;
+		AsyncSocket& operator=(AsyncSocket&&);
+		~AsyncSocket();
+
+		auto async_accept() -> Task<AsyncSocket>;
+
+		/**
+		 * Tries each resolved address in turn, `timeout()` limits every
+		 * attempt on its own. Yields `Status::TIMED_OUT` when the last
+		 * address did not answer in time. Attempts after the first use a
+		 * fresh descriptor.
+		 */
+		auto async_connect(sock::Address) -> Task<Status>;
+
+		/**
+		 * Connects to an already resolved address, no lookup involved.
+		 * The socket's family has to match the endpoint's, or be a
+		 * dual-stack IPv6 socket for IPv4 endpoints.
+		 */
+		auto async_connect(sock::Endpoint) -> Task<Status>;
+
+		/**
+		 * Receives whatever is available, like `sock::Socket::receive()`.
+		 * A zero `received_size()` means the peer closed the connection.
+		 */
+		auto async_receive(sock::Buffer&) -> Task<Status>;
+
+		/**
+		 * Sends whole `payload`.
+		 */
+		auto async_send(std::string_view payload) -> Task<Status>;
+
+		/**
+		 * Limits how long each subsequent operation may stay suspended.
+		 * Zero disables the limit. Expired operations yield
+		 * `Status::TIMED_OUT`.
+		 */
+		auto timeout(std::chrono::milliseconds) -> AsyncSocket&;
+
+		/**
+		 * Resumes suspended operations with `Status::CANCELLED`.
+		 */
+		auto cancel() -> void;
+
+		auto socket() -> sock::Socket&
+		{
+			return m_sock;
+		}
+
+		auto native_handle() const
+		{
+			return m_sock.native_handle();
+		}
+
+		auto is_valid() const -> bool
+		{
+			return m_sock.is_valid();
+		}
+
+		auto status() const -> Status
+		{
+			return m_status != Status::GOOD ? m_status : m_sock.status();
+		}
+
+	private:
+		struct Waiter
+		{
+			std::coroutine_handle<> handle {nullptr};
+			Reactor::TimerId timer {0};
+			Status result {Status::GOOD};
+		};
+
+		// Lives on the heap so the reactor handler survives moves.
+		struct State
+		{
+			Reactor* reactor;
+			std::chrono::milliseconds timeout {0};
+			Waiter reader;
+			Waiter writer;
+
+			/**
+			 * Disarms `waiter` and returns the coroutine to resume.
+			 */
+			auto release(Waiter&, Status) -> std::coroutine_handle<>;
+		};
+
+		struct Wait
+		{
+			State& state;
+			Waiter& waiter;
+
+			auto await_ready() const noexcept -> bool
+			{
+				return false;
+			}
+
+			auto await_suspend(std::coroutine_handle<>) -> void;
+
+			auto await_resume() const noexcept -> Status
+			{
+				return waiter.result;
+			}
+		};
+
+		AsyncSocket(Reactor&, sock::Socket&&, Status);
+
+		auto attach() -> void;
+		auto detach() -> void;
+		auto reopen(int family, int type, int protocol) -> void;
+
+		Status m_status {Status::GOOD};
+		sock::Socket m_sock;
+		std::unique_ptr<State> m_state;
+	};
+} // namespace sock
+
+#endif // SOCK_ASYNC_SOCKET_H_
@@ -0,0 +1,186 @@
+#ifndef SOCK_BACKEND_BALANCER_H_
+#define SOCK_BACKEND_BALANCER_H_
+
+#include "sock/connection_pool.hpp"
+#include "sock/endpoint.hpp"
+#include "sock/socket.hpp"
+#include "sock/utils.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace sock
+{
+	struct BackendOptions
+	{
+		/* Points every backend gets on the hash ring. More spread keys
+		 * more evenly. */
+		size_t replicas {160};
+
+		/* No backend takes more than this many times the mean of
+		 * outstanding requests from `by_key()`, the rest spill over to
+		 * the next backends on the ring. */
+		double load_factor {1.25};
+
+		/* Connections to every backend. */
+		PoolOptions pool {};
+	};
+
+	struct BackendStats
+	{
+		/* Requests started and not finished yet. */
+		std::atomic<uint64_t> outstanding {0};
+		std::atomic<uint64_t> completed {0};
+		std::atomic<uint64_t> failed {0};
+		/* Moving average of request latency, weighing the latest 1/8. */
+		std::atomic<uint64_t> latency_ns {0};
+	};
+
+	/**
+	 * Spreads client requests over a fixed set of backends, with a pooled
+	 * connection set per backend. Two ways of picking one:
+	 *
+	 *  - `by_key()`: consistent hashing with bounded loads, requests for
+	 *    the same key go to the same backend, for cache affinity, unless
+	 *    that one is already overloaded;
+	 *  - `least_loaded()`: the power of two choices, the backend with
+	 *    fewer outstanding requests out of two picked at random, the
+	 *    faster one on a tie.
+	 *
+	 * Thread safe.
+	 */
+	class BackendBalancer
+	{
+	public:
+		/**
+		 * A request in flight on a pooled connection to one backend.
+		 * Finishes when destroyed, if not before.
+		 */
+		class Request
+		{
+		public:
+			Request(Request&&);
+			Request& operator=(Request&&) = delete;
+			~Request();
+
+			auto status() const -> Status
+			{
+				return m_lease.status();
+			}
+
+			auto backend() const -> size_t
+			{
+				return m_backend;
+			}
+
+			auto socket() -> sock::Socket&
+			{
+				return m_lease.socket();
+			}
+
+			auto operator->() -> sock::Socket*
+			{
+				return &m_lease.socket();
+			}
+
+			/**
+			 * Records the latency and releases the connection. A failed
+			 * request closes it. Without a call, success is judged by the
+			 * socket's status.
+			 */
+			auto finish(bool ok) -> void;
+
+		private:
+			friend class BackendBalancer;
+
+			Request(BackendBalancer&, size_t backend, ConnectionPool::Lease&&);
+
+			BackendBalancer* m_balancer;
+			size_t m_backend;
+			std::chrono::steady_clock::time_point m_start;
+			ConnectionPool::Lease m_lease;
+			bool m_finished {false};
+		};
+
+		/**
+		 * Connects with the `type`, `protocol` and `flags` of `args`.
+		 */
+		BackendBalancer(
+		    CtorArgs args,
+		    std::vector<Endpoint> backends,
+		    BackendOptions = {}
+		);
+
+		BackendBalancer(const BackendBalancer&) = delete;
+		BackendBalancer& operator=(const BackendBalancer&) = delete;
+
+		/**
+		 * Starts a request on the backend `key` hashes to.
+		 */
+		auto by_key(std::string_view key) -> Request
+		{
+			return start(pick(key));
+		}
+
+		/**
+		 * Starts a request on a lightly loaded backend.
+		 */
+		auto least_loaded() -> Request
+		{
+			return start(pick());
+		}
+
+		/**
+		 * Starts a request on `backend`.
+		 */
+		auto start(size_t backend) -> Request;
+
+		/**
+		 * Index of the backend `by_key()` would use now.
+		 */
+		auto pick(std::string_view key) const -> size_t;
+
+		/**
+		 * Index of the backend `least_loaded()` would use now.
+		 */
+		auto pick() const -> size_t;
+
+		auto size() const -> size_t
+		{
+			return m_endpoints.size();
+		}
+
+		auto endpoint(size_t backend) const -> const Endpoint&
+		{
+			return m_endpoints[backend];
+		}
+
+		auto stats(size_t backend) const -> const BackendStats&
+		{
+			return m_stats[backend];
+		}
+
+		auto pool() -> ConnectionPool&
+		{
+			return m_pool;
+		}
+
+	private:
+		std::vector<Endpoint> m_endpoints;
+		std::unique_ptr<BackendStats[]> m_stats;
+		BackendOptions m_options;
+
+		// Sorted points of the hash ring and their backends.
+		std::vector<std::pair<uint64_t, size_t>> m_ring;
+		std::atomic<uint64_t> m_outstanding {0};
+
+		ConnectionPool m_pool;
+	};
+} // namespace sock
+
+#endif // SOCK_BACKEND_BALANCER_H_
@@ -0,0 +1,75 @@
+#ifndef SOCK_BALANCER_H_
+#define SOCK_BALANCER_H_
+
+#include "sock/runtime.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sock
+{
+	struct BalancerOptions
+	{
+		/* How often loads are sampled. */
+		std::chrono::milliseconds interval {100};
+
+		/* Busiest core must carry this many times the mean load. */
+		double threshold {1.5};
+
+		/* Samples below this many bytes are not worth a migration. */
+		uint64_t min_load {64 * 1024};
+	};
+
+	/**
+	 * Watches per-core load of a `sock::Runtime` and migrates connections
+	 * from the busiest to the idlest core when they drift apart.
+	 */
+	class Balancer
+	{
+	public:
+		explicit Balancer(Runtime&, BalancerOptions = {});
+
+		/**
+		 * Stops sampling.
+		 */
+		~Balancer();
+
+		Balancer(const Balancer&) = delete;
+		Balancer& operator=(const Balancer&) = delete;
+
+		/**
+		 * Samples the load of every core since the previous call and, if
+		 * it is unbalanced, asks the busiest core to shed a connection to
+		 * the idlest. Returns whether a migration was requested.
+		 */
+		auto rebalance() -> bool;
+
+		/**
+		 * Calls `rebalance()` every `BalancerOptions::interval` on a
+		 * background thread until destroyed.
+		 */
+		auto start() -> Balancer&;
+
+		auto decisions() const -> uint64_t
+		{
+			return m_decisions.load(std::memory_order_relaxed);
+		}
+
+	private:
+		Runtime& m_runtime;
+		BalancerOptions m_options;
+		std::vector<uint64_t> m_previous;
+		std::atomic<uint64_t> m_decisions {0};
+
+		std::mutex m_mutex;
+		std::condition_variable m_wakeup;
+		bool m_stopping {false};
+		std::thread m_thread;
+	};
+} // namespace sock
+
+#endif // SOCK_BALANCER_H_
@@ -0,0 +1,6 @@
+#ifndef SOCK_CMAKE_VARS_H_
+#define SOCK_CMAKE_VARS_H_
+
+#define SOCK_BUFFER_MAX_SIZE 10240
+
+#endif // SOCK_CMAKE_VARS_H_
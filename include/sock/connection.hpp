@@ -0,0 +1,179 @@
+#ifndef SOCK_CONNECTION_H_
+#define SOCK_CONNECTION_H_
+
+#include "sock/send_queue.hpp"
+#include "sock/socket.hpp"
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace sock
+{
+	class Core;
+
+	/**
+	 * Output limits of a `sock::Connection`. Once more than `high` bytes
+	 * wait for the socket the connection is congested: it stops reading
+	 * its own socket until the queue has drained to `low`.
+	 */
+	struct Watermarks
+	{
+		size_t high {1 << 20};
+		size_t low {256 << 10};
+
+		/* Unsent bytes the kernel holds before the socket stops being
+		 * writable (`TCP_NOTSENT_LOWAT`), 0 keeps the system default. A
+		 * small value keeps the backlog in the queue, where it is
+		 * measured, instead of in the socket's send buffer. */
+		int not_sent_lowat {0};
+	};
+
+	/**
+	 * An established connection owned by one `sock::Core`. Received bytes
+	 * are appended to `input()` and the handler is called; it consumes what
+	 * it can and replies with `write()`. Output that the socket does not
+	 * take right away is buffered.
+	 *
+	 * Since all of its state lives in the object, a connection can be
+	 * moved to another core with `Core::migrate()`.
+	 */
+	class Connection
+	{
+	public:
+		using Handler = std::function<void(Connection&)>;
+
+		Connection(sock::Socket&&, Handler, Watermarks = {});
+
+		Connection(const Connection&) = delete;
+		Connection& operator=(const Connection&) = delete;
+
+		/**
+		 * Received bytes not consumed by the handler yet.
+		 */
+		auto input() -> std::string&
+		{
+			return m_input;
+		}
+
+		/**
+		 * Owning core only.
+		 */
+		auto write(std::string_view) -> Connection&;
+
+		/**
+		 * Owning core only. Writes `payloads` with one vectored write,
+		 * e.g. a response's headers and its body.
+		 */
+		auto write(std::span<const std::string_view> payloads) -> Connection&;
+
+		/**
+		 * Queues `payload` for the owning core to write. Thread safe and
+		 * lock free, may be called while the connection migrates.
+		 */
+		auto post(std::string payload) -> void
+		{
+			m_output.push(std::move(payload));
+		}
+
+		/**
+		 * Closes the connection once the current handler returns.
+		 */
+		auto close() -> void
+		{
+			m_closed = true;
+		}
+
+		/**
+		 * Stops reading and closes the connection once everything written
+		 * so far has been sent.
+		 */
+		auto finish() -> void
+		{
+			m_finishing = true;
+		}
+
+		/**
+		 * The core running this connection, null while it migrates.
+		 */
+		auto core() const -> Core*
+		{
+			return m_core;
+		}
+
+		/**
+		 * Owning core only. Bytes waiting for the socket.
+		 */
+		auto pending_output() const -> size_t
+		{
+			return m_output.pending_bytes();
+		}
+
+		auto watermarks(Watermarks) -> Connection&;
+
+		/**
+		 * Whether the output went above the high watermark and has not
+		 * drained to the low one yet. Producers feeding this connection,
+		 * e.g. the upstream of a proxy, should pause meanwhile.
+		 */
+		auto congested() const -> bool
+		{
+			return m_congested;
+		}
+
+		/**
+		 * Called on the owning core when the output of a congested
+		 * connection has drained to the low watermark.
+		 */
+		auto on_drained(Handler handler) -> Connection&
+		{
+			m_on_drained = std::move(handler);
+
+			return *this;
+		}
+
+		/**
+		 * Owning core only. Stops reading from the socket, e.g. while the
+		 * connection it feeds is congested, until `resume_input()`.
+		 */
+		auto pause_input() -> Connection&;
+		auto resume_input() -> Connection&;
+
+		auto native_handle() const
+		{
+			return m_sock.native_handle();
+		}
+
+	private:
+		friend class Core;
+
+		auto attach(Core&) -> void;
+		auto detach() -> void;
+		auto on_events(uint32_t) -> void;
+		auto settle(Core&, uint64_t load_before) -> void;
+		auto refresh() -> void;
+		auto events() -> uint32_t;
+
+		sock::Socket m_sock;
+		Handler m_handler;
+		std::string m_input;
+		SendQueue m_output;
+		Watermarks m_watermarks;
+		Handler m_on_drained;
+		Core* m_core {nullptr};
+		bool m_closed {false};
+		bool m_finishing {false};
+		bool m_congested {false};
+		bool m_input_paused {false};
+		uint32_t m_armed {0};
+
+		/* Output depth last added to the owning core's metrics. */
+		size_t m_queued {0};
+
+		/* Bytes moved since the owning core last sampled it. */
+		uint64_t m_load {0};
+	};
+} // namespace sock
+
+#endif // SOCK_CONNECTION_H_
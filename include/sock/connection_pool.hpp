@@ -0,0 +1,173 @@
+#ifndef SOCK_CONNECTION_POOL_H_
+#define SOCK_CONNECTION_POOL_H_
+
+#include "sock/endpoint.hpp"
+#include "sock/socket.hpp"
+#include "sock/utils.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace sock
+{
+	namespace internal
+	{
+		struct PoolState;
+	} // namespace internal
+
+	struct PoolOptions
+	{
+		/* Idle connections per endpoint that `evict_idle()` keeps and
+		 * `warm()` opens. */
+		size_t min_idle {0};
+		/* Connections per endpoint, idle and checked out together. */
+		size_t max_size {64};
+		/* Idle connections older than this are closed. */
+		std::chrono::milliseconds idle_timeout {std::chrono::seconds {60}};
+		/* How long `acquire()` waits for a connection to be released
+		 * once `max_size` are checked out. */
+		std::chrono::milliseconds wait_timeout {std::chrono::seconds {1}};
+		/* Idle connections every thread keeps to itself, taken and put
+		 * back without locking. */
+		size_t thread_cache {4};
+	};
+
+	struct PoolMetrics
+	{
+		/* Checkouts that reused an idle connection. */
+		std::atomic<uint64_t> hits {0};
+		/* Checkouts that had to connect. */
+		std::atomic<uint64_t> misses {0};
+		/* Checkouts that waited for a connection to be released, and
+		 * the total time they waited. */
+		std::atomic<uint64_t> waits {0};
+		std::atomic<uint64_t> wait_ns {0};
+		/* Checkouts that gave up waiting. */
+		std::atomic<uint64_t> timeouts {0};
+		/* Idle connections found closed or with unexpected input. */
+		std::atomic<uint64_t> broken {0};
+		/* Idle connections closed for being idle too long. */
+		std::atomic<uint64_t> evicted {0};
+
+		auto hit_rate() const -> double
+		{
+			const auto total = hits + misses;
+
+			return total == 0 ? 0.0 : static_cast<double>(hits) / total;
+		}
+	};
+
+	/**
+	 * Keeps client connections open between requests, per endpoint. An
+	 * idle connection is checked before reuse with a non-blocking
+	 * `MSG_PEEK`: one that was closed by the peer, or has unread input,
+	 * is replaced by a new one.
+	 *
+	 * Thread safe. Every thread first looks into its own small cache of
+	 * idle connections, which needs no lock; connections in there are
+	 * only evicted when that thread next uses the pool.
+	 */
+	class ConnectionPool
+	{
+	public:
+		/**
+		 * A checked out connection, put back into the pool when
+		 * destroyed. Check `status()` first.
+		 */
+		class Lease
+		{
+		public:
+			Lease(Lease&&);
+			Lease& operator=(Lease&&);
+			~Lease();
+
+			auto status() const -> Status
+			{
+				return m_status;
+			}
+
+			auto socket() -> sock::Socket&
+			{
+				return m_socket;
+			}
+
+			auto operator->() -> sock::Socket*
+			{
+				return &m_socket;
+			}
+
+			/**
+			 * Closes the connection instead of putting it back, e.g.
+			 * after a protocol error. Done automatically when the socket's
+			 * status is not `Status::GOOD`.
+			 */
+			auto discard() -> void
+			{
+				m_reuse = false;
+			}
+
+		private:
+			friend class ConnectionPool;
+
+			Lease(
+			    std::shared_ptr<internal::PoolState>,
+			    Endpoint,
+			    sock::Socket&&,
+			    Status
+			);
+
+			auto release() -> void;
+
+			std::shared_ptr<internal::PoolState> m_state;
+			Endpoint m_endpoint;
+			sock::Socket m_socket;
+			Status m_status;
+			bool m_reuse {true};
+		};
+
+		/**
+		 * Connections are opened with the `type`, `protocol` and `flags`
+		 * of `args`, in the family of their endpoint.
+		 */
+		explicit ConnectionPool(CtorArgs args, PoolOptions = {});
+
+		ConnectionPool(const ConnectionPool&) = delete;
+		ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+		~ConnectionPool();
+
+		/**
+		 * Checks out a connection to `endpoint`, reusing an idle one when
+		 * possible. Waits up to `wait_timeout` if `max_size` are checked
+		 * out, then fails with `Status::TIMED_OUT`.
+		 */
+		auto acquire(const Endpoint&) -> Lease;
+
+		/**
+		 * Opens connections to `endpoint` until `min_idle` are idle.
+		 */
+		auto warm(const Endpoint&) -> Status;
+
+		/**
+		 * Closes shared idle connections past `idle_timeout`, keeping
+		 * `min_idle` per endpoint. Returns how many were closed.
+		 */
+		auto evict_idle() -> size_t;
+
+		/**
+		 * Shared idle connections to `endpoint`, not counting thread
+		 * caches.
+		 */
+		auto idle(const Endpoint&) const -> size_t;
+
+		auto metrics() const -> const PoolMetrics&;
+
+	private:
+		std::shared_ptr<internal::PoolState> m_state;
+	};
+} // namespace sock
+
+#endif // SOCK_CONNECTION_POOL_H_
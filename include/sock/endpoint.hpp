@@ -0,0 +1,149 @@
+#ifndef SOCK_ENDPOINT_H_
+#define SOCK_ENDPOINT_H_
+
+#include "sock/utils.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sock
+{
+	/**
+	 * A resolved socket address. Binding or connecting to it involves no
+	 * lookup, so resolve once and reuse it for every connection.
+	 */
+	class Endpoint
+	{
+	public:
+		Endpoint() = default;
+		Endpoint(const sockaddr* address, socklen_t size);
+
+		/**
+		 * Parses numeric IPv4 and IPv6 hosts and numeric ports without any
+		 * lookup. Empty for anything else.
+		 */
+		static auto parse(sock::Address) -> std::optional<Endpoint>;
+
+		auto data() const -> const sockaddr*
+		{
+			return reinterpret_cast<const sockaddr*>(&m_storage);
+		}
+
+		auto size() const -> socklen_t
+		{
+			return m_size;
+		}
+
+		auto family() const -> int
+		{
+			return m_storage.ss_family;
+		}
+
+		auto port() const -> uint16_t;
+
+		/**
+		 * How a socket of `socket_family` addresses this endpoint: IPv4
+		 * endpoints become v4-mapped for IPv6 sockets, which reach them
+		 * when dual-stack. Anything else is returned as is.
+		 */
+		auto for_family(int socket_family) const -> Endpoint;
+
+		/**
+		 * "host:port", IPv6 hosts in brackets.
+		 */
+		auto to_string() const -> std::string;
+
+		auto operator==(const Endpoint&) const -> bool;
+
+		/**
+		 * Hashes the address bytes, for keying containers by endpoint.
+		 */
+		auto hash() const -> size_t;
+
+	private:
+		sockaddr_storage m_storage {};
+		socklen_t m_size {0};
+	};
+
+	struct Resolution
+	{
+		Status status {Status::GOOD};
+		std::vector<Endpoint> endpoints {};
+	};
+
+	namespace internal
+	{
+		/**
+		 * Resolves `address` for sockets described by `hints`, in the
+		 * order getaddrinfo() returns them. Numeric hosts and ports are
+		 * parsed without it.
+		 */
+		auto resolve(const addrinfo& hints, sock::Address) -> Resolution;
+	} // namespace internal
+
+	/**
+	 * Resolves `address` for sockets created with `args`. Blocks while
+	 * looking the host up, unless it is numeric.
+	 */
+	auto resolve(CtorArgs args, sock::Address address) -> Resolution;
+
+	/**
+	 * Caches successful resolutions for `ttl`, so repeated connects to
+	 * the same host do not each wait for a lookup. Numeric hosts bypass
+	 * the cache. Thread safe.
+	 */
+	class ResolverCache
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		explicit ResolverCache(
+		    std::chrono::milliseconds ttl = std::chrono::seconds {30},
+		    size_t capacity = 1024
+		);
+
+		auto resolve(CtorArgs, sock::Address) -> Resolution;
+
+		/**
+		 * Drops every cached resolution.
+		 */
+		auto clear() -> void;
+
+		auto size() const -> size_t;
+
+		auto hits() const -> uint64_t;
+		auto misses() const -> uint64_t;
+
+	private:
+		struct Entry
+		{
+			Clock::time_point expires;
+			std::vector<Endpoint> endpoints;
+		};
+
+		std::chrono::milliseconds m_ttl;
+		size_t m_capacity;
+
+		mutable std::mutex m_mutex;
+		std::unordered_map<std::string, Entry> m_entries;
+		uint64_t m_hits {0};
+		uint64_t m_misses {0};
+	};
+} // namespace sock
+
+template<>
+struct std::hash<sock::Endpoint>
+{
+	auto operator()(const sock::Endpoint& endpoint) const noexcept -> size_t
+	{
+		return endpoint.hash();
+	}
+};
+
+#endif // SOCK_ENDPOINT_H_
@@ -0,0 +1,96 @@
+#ifndef SOCK_EXECUTOR_H_
+#define SOCK_EXECUTOR_H_
+
+#include "sock/internal/work_stealing_deque.hpp"
+#include "sock/reactor.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sock
+{
+	/**
+	 * Work-stealing thread pool. Every worker has its own deque, jobs
+	 * submitted from outside of the pool go to a shared injection queue.
+	 * An idle worker takes jobs from the injection queue or steals them
+	 * from a busy worker, so one slow job does not hold up the jobs queued
+	 * behind it.
+	 */
+	class Executor
+	{
+	public:
+		using Job = std::function<void()>;
+
+		/**
+		 * Starts `workers` threads, one per available CPU if 0.
+		 */
+		explicit Executor(size_t workers = 0);
+
+		/**
+		 * Runs the jobs that are still queued and joins the workers.
+		 */
+		~Executor();
+
+		Executor(const Executor&) = delete;
+		Executor& operator=(const Executor&) = delete;
+
+		/**
+		 * Queues `job`. Called from a worker it goes to that worker's own
+		 * deque, otherwise to the injection queue. Thread safe.
+		 */
+		auto submit(Job job) -> void;
+
+		/**
+		 * Adapts `handler` of `fd` registered in `reactor` with
+		 * `Events::ONE_SHOT`: the handler runs on the executor, after which
+		 * `fd` is re-armed for `events` on the reactor thread.
+		 */
+		auto offload(Reactor& reactor, int fd, uint32_t events, Reactor::Handler)
+		    -> Reactor::Handler;
+
+		auto size() const -> size_t
+		{
+			return m_workers.size();
+		}
+
+		/**
+		 * Amount of jobs taken from another worker's deque.
+		 */
+		auto steals() const -> uint64_t
+		{
+			return m_steals.load(std::memory_order_relaxed);
+		}
+
+	private:
+		struct Worker
+		{
+			internal::WorkStealingDeque<Job*> deque;
+			std::thread thread;
+		};
+
+		auto run(size_t index) -> void;
+		auto find(size_t index) -> Job*;
+		auto wait() -> bool;
+
+		std::vector<std::unique_ptr<Worker>> m_workers;
+
+		std::mutex m_injected_mutex;
+		std::deque<Job*> m_injected;
+
+		std::mutex m_sleep_mutex;
+		std::condition_variable m_sleep;
+		std::atomic<size_t> m_sleeping {0};
+
+		std::atomic<size_t> m_pending {0};
+		std::atomic<uint64_t> m_steals {0};
+		std::atomic<bool> m_stopping {false};
+	};
+} // namespace sock
+
+#endif // SOCK_EXECUTOR_H_
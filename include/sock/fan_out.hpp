@@ -0,0 +1,113 @@
+#ifndef SOCK_FAN_OUT_H_
+#define SOCK_FAN_OUT_H_
+
+#include "sock/async_socket.hpp"
+#include "sock/reactor.hpp"
+#include "sock/task.hpp"
+#include "sock/utils.hpp"
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace sock
+{
+	/**
+	 * Connects to many addresses at once and hands out the outcomes in
+	 * the order they complete, so the first backend to answer is usable
+	 * right away while dead ones are still timing out. Every address
+	 * yields exactly one result.
+	 *
+	 * Must be used on the reactor thread only.
+	 */
+	class FanOut
+	{
+	public:
+		struct Result
+		{
+			/**
+			 * Position of the address passed to the constructor.
+			 */
+			size_t index;
+			Status status;
+			AsyncSocket socket;
+		};
+
+		/**
+		 * Starts connecting to all `addresses`, each attempt limited by
+		 * `timeout` (zero for none). The addresses only need to outlive
+		 * the constructor.
+		 */
+		FanOut(
+		    Reactor&,
+		    CtorArgs,
+		    std::span<const Address> addresses,
+		    std::chrono::milliseconds timeout = std::chrono::milliseconds {0}
+		);
+
+		FanOut(const FanOut&) = delete;
+		FanOut& operator=(const FanOut&) = delete;
+
+		/**
+		 * Cancels connects still in flight.
+		 */
+		~FanOut();
+
+		/**
+		 * Waits for the next completed connect. Empty once every address
+		 * has been reported.
+		 */
+		auto next() -> Task<std::optional<Result>>;
+
+		/**
+		 * Amount of results not handed out yet.
+		 */
+		auto remaining() const -> size_t
+		{
+			return m_shared->remaining + m_shared->ready.size();
+		}
+
+	private:
+		struct Shared
+		{
+			std::deque<Result> ready;
+			std::vector<AsyncSocket*> in_flight;
+			std::coroutine_handle<> waiter {nullptr};
+			size_t remaining {0};
+		};
+
+		struct Wait
+		{
+			Shared& shared;
+
+			auto await_ready() const noexcept -> bool
+			{
+				return !shared.ready.empty() || shared.remaining == 0;
+			}
+
+			auto await_suspend(std::coroutine_handle<> handle) noexcept
+			    -> void
+			{
+				shared.waiter = handle;
+			}
+
+			auto await_resume() const noexcept -> void
+			{}
+		};
+
+		static auto attempt(
+		    std::shared_ptr<Shared>,
+		    AsyncSocket,
+		    Address,
+		    size_t index
+		) -> Task<>;
+
+		std::shared_ptr<Shared> m_shared;
+	};
+} // namespace sock
+
+#endif // SOCK_FAN_OUT_H_
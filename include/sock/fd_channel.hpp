@@ -0,0 +1,88 @@
+#ifndef SOCK_FD_CHANNEL_H_
+#define SOCK_FD_CHANNEL_H_
+
+#include "sock/socket.hpp"
+#include "sock/utils.hpp"
+#include <cstddef>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sock
+{
+	/**
+	 * A connection passed between processes, with bytes already read
+	 * from it that its new owner has to process first.
+	 */
+	struct Handoff
+	{
+		sock::Socket socket;
+		std::string data {};
+	};
+
+	/**
+	 * Control channel passing sockets to another process, `SCM_RIGHTS`
+	 * over an `AF_UNIX` `SOCK_SEQPACKET` socket. Handoffs travel in
+	 * batches, one message carries up to `MAX_BATCH` descriptors.
+	 */
+	class FdChannel
+	{
+	public:
+		static constexpr size_t MAX_BATCH = 64;
+
+		/**
+		 * Connected ends, e.g. to be split across `fork()`.
+		 */
+		static auto pair() -> std::pair<FdChannel, FdChannel>;
+
+		explicit FdChannel(int fd = -1) : m_fd {fd} {}
+
+		FdChannel(const FdChannel&) = delete;
+		FdChannel& operator=(const FdChannel&) = delete;
+
+		FdChannel(FdChannel&& other) :
+		    m_status {other.m_status},
+		    m_fd {std::exchange(other.m_fd, -1)}
+		{}
+
+		FdChannel& operator=(FdChannel&&);
+
+		~FdChannel();
+
+		/**
+		 * Passes `handoffs` to the other end. Sockets that were sent are
+		 * released here without shutting their connections down.
+		 * Returns the amount sent, fewer on error or when a non-blocking
+		 * channel is full.
+		 */
+		auto send(std::span<Handoff> handoffs) -> size_t;
+
+		/**
+		 * Receives one batch, appending it to `out`. Returns the amount
+		 * received; zero when the other end closed, the channel is
+		 * non-blocking and empty, or on error.
+		 */
+		auto receive(std::vector<Handoff>& out) -> size_t;
+
+		auto non_blocking(bool) -> FdChannel&;
+
+		auto close() -> void;
+
+		auto native_handle() const -> int
+		{
+			return m_fd;
+		}
+
+		auto status() const -> Status
+		{
+			return m_status;
+		}
+
+	private:
+		Status m_status {Status::GOOD};
+		int m_fd {-1};
+	};
+} // namespace sock
+
+#endif // SOCK_FD_CHANNEL_H_
@@ -0,0 +1,132 @@
+#ifndef SOCK_FRAMING_H_
+#define SOCK_FRAMING_H_
+
+#include "sock/utils.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace sock
+{
+	/**
+	 * How the length of a frame's payload precedes it.
+	 */
+	enum class Prefix
+	{
+		/* 2 bytes, big-endian. */
+		U16,
+		/* 4 bytes, big-endian. */
+		U32,
+		/* 1 to 10 bytes, unsigned LEB128 as in Protocol Buffers. */
+		VARINT,
+	};
+
+	/**
+	 * Writes length-prefixed frames.
+	 */
+	class FrameEncoder
+	{
+	public:
+		static constexpr size_t MAX_HEADER = 10;
+
+		explicit FrameEncoder(Prefix prefix = Prefix::U32) : m_prefix {prefix}
+		{}
+
+		/**
+		 * Writes the prefix of a `size` bytes payload to `out`, for
+		 * sending it along with the payload in one vectored write.
+		 * Returns the length of the prefix, 0 if `size` does not fit it.
+		 */
+		auto header(size_t size, char* out) const -> size_t;
+
+		/**
+		 * Appends a frame carrying `payload` to `out`.
+		 * Yields `Status::FRAME_ERROR` if `payload` does not fit the prefix.
+		 */
+		auto encode(std::string_view payload, std::string& out) const -> Status;
+
+	private:
+		Prefix m_prefix;
+	};
+
+	/**
+	 * Splits received bytes into length-prefixed frames, whatever the
+	 * reads they came in.
+	 *
+	 * Frames received whole are handed out as views into the fed bytes,
+	 * no copies made. Only a frame split across reads is gathered in an
+	 * inner buffer, and so is a trailing partial frame as soon as
+	 * `next()` runs out of frames, so the receive buffer may be reused
+	 * then. Views stay valid until the next `feed()`.
+	 *
+	 * A frame above `max_frame` bytes, or a malformed prefix, stops
+	 * decoding with `Status::FRAME_ERROR`: the stream can not be trusted
+	 * after that.
+	 */
+	class FrameDecoder
+	{
+	public:
+		explicit FrameDecoder(
+		    Prefix prefix = Prefix::U32,
+		    size_t max_frame = 16 * 1024 * 1024
+		) :
+		    m_prefix {prefix},
+		    m_max_frame {max_frame}
+		{}
+
+		/**
+		 * Adds freshly received `bytes`. They must stay untouched until
+		 * `next()` returns nothing.
+		 */
+		auto feed(std::string_view bytes) -> FrameDecoder&;
+
+		/**
+		 * The payload of the next complete frame.
+		 */
+		auto next() -> std::optional<std::string_view>;
+
+		/**
+		 * Bytes of a partial frame waiting for more.
+		 */
+		auto buffered() const -> size_t
+		{
+			return m_partial.size();
+		}
+
+		auto status() const -> Status
+		{
+			return m_status;
+		}
+
+		/**
+		 * Drops partial frames and errors, e.g. for a new connection.
+		 */
+		auto reset() -> void;
+
+	private:
+		/**
+		 * Size of the header and of the payload at the front of `bytes`.
+		 * No value while the header is incomplete.
+		 */
+		auto measure(std::string_view bytes)
+		    -> std::optional<std::pair<size_t, size_t>>;
+
+		Prefix m_prefix;
+		size_t m_max_frame;
+		Status m_status {Status::GOOD};
+
+		std::string_view m_input;
+		size_t m_offset {0};
+
+		// A frame being gathered across reads, and the last one gathered.
+		std::string m_partial;
+		std::string m_assembled;
+		bool m_assembled_ready {false};
+		size_t m_assembled_header {0};
+	};
+} // namespace sock
+
+#endif // SOCK_FRAMING_H_
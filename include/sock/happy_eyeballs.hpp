@@ -0,0 +1,72 @@
+#ifndef SOCK_HAPPY_EYEBALLS_H_
+#define SOCK_HAPPY_EYEBALLS_H_
+
+#include "sock/async_socket.hpp"
+#include "sock/endpoint.hpp"
+#include "sock/reactor.hpp"
+#include "sock/resolver.hpp"
+#include "sock/task.hpp"
+#include "sock/utils.hpp"
+#include <chrono>
+#include <vector>
+
+namespace sock
+{
+	struct HappyEyeballsOptions
+	{
+		/**
+		 * Head start of an attempt before the next one is started
+		 * alongside it. RFC 8305 recommends 250ms.
+		 */
+		std::chrono::milliseconds attempt_delay {250};
+
+		/**
+		 * Limit of every single attempt, zero for none.
+		 */
+		std::chrono::milliseconds timeout {0};
+	};
+
+	struct Connected
+	{
+		Status status;
+		AsyncSocket socket;
+
+		/**
+		 * Where `socket` is connected to.
+		 */
+		Endpoint endpoint;
+	};
+
+	/**
+	 * RFC 8305 connect: tries `endpoints` with address families
+	 * alternating, starting with the first endpoint's, and starts the next
+	 * attempt every `attempt_delay` or as soon as one fails, without
+	 * abandoning those still in flight. The first socket to connect wins,
+	 * the other attempts are cancelled. A broken IPv6 path then costs one
+	 * `attempt_delay` instead of a full connect timeout.
+	 *
+	 * Only `type`, `protocol` and `flags` of `args` are used, every
+	 * attempt gets a socket of its endpoint's family.
+	 */
+	auto happy_eyeballs(
+	    Reactor&,
+	    CtorArgs args,
+	    std::vector<Endpoint> endpoints,
+	    HappyEyeballsOptions = {}
+	) -> Task<Connected>;
+
+	/**
+	 * Resolves `address` on `resolver` for `args`, then races the results.
+	 * Pass `Domain::UNSPEC` to get both address families. The views of
+	 * `address` only need to outlive the call.
+	 */
+	auto happy_eyeballs(
+	    Reactor&,
+	    Resolver&,
+	    CtorArgs args,
+	    Address address,
+	    HappyEyeballsOptions = {}
+	) -> Task<Connected>;
+} // namespace sock
+
+#endif // SOCK_HAPPY_EYEBALLS_H_
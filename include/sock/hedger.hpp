@@ -0,0 +1,123 @@
+#ifndef SOCK_HEDGER_H_
+#define SOCK_HEDGER_H_
+
+#include "sock/async_socket.hpp"
+#include "sock/reactor.hpp"
+#include "sock/task.hpp"
+#include "sock/utils.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sock
+{
+	struct HedgeOptions
+	{
+		/* Latency percentile of past replies after which a request is
+		 * duplicated. */
+		double percentile {0.95};
+
+		/* Used until `min_samples` replies were timed. */
+		std::chrono::milliseconds initial_delay {10};
+		size_t min_samples {32};
+
+		/* Never hedge sooner than this. */
+		std::chrono::milliseconds min_delay {1};
+
+		/* Share of requests that may be hedged, so a slow backend does
+		 * not get its load multiplied. */
+		double budget {0.05};
+
+		/* Replies the percentile is taken over. */
+		size_t window {1024};
+	};
+
+	struct HedgeMetrics
+	{
+		uint64_t requests {0};
+		/* Requests duplicated on the backup connection. */
+		uint64_t hedged {0};
+		/* Hedged requests the backup answered first. */
+		uint64_t backup_wins {0};
+		/* Hedges skipped for lack of budget. */
+		uint64_t denied {0};
+	};
+
+	struct Hedged
+	{
+		Status status;
+		std::string reply;
+
+		/**
+		 * 0 if the primary connection answered, 1 for the backup.
+		 */
+		size_t winner;
+		bool hedged;
+	};
+
+	/**
+	 * Cuts tail latency of request/reply exchanges: a request is sent on
+	 * a primary connection and, if no reply came within a percentile of
+	 * recent reply times, once more on a backup connection. The first
+	 * reply is kept, the other exchange is cancelled.
+	 *
+	 * A cancelled exchange still gets its reply later, so the losing
+	 * connection must be closed, or have one reply read and discarded,
+	 * before it is used again. Must be used on the reactor thread only.
+	 */
+	class Hedger
+	{
+	public:
+		explicit Hedger(Reactor&, HedgeOptions = {});
+
+		Hedger(const Hedger&) = delete;
+		Hedger& operator=(const Hedger&) = delete;
+
+		/**
+		 * Sends `payload` on `primary`, then on `backup` if need be, and
+		 * yields the first reply, as received by one `async_receive()`.
+		 * Both sockets must outlive the returned task.
+		 */
+		auto request(
+		    AsyncSocket& primary,
+		    AsyncSocket& backup,
+		    std::string_view payload
+		) -> Task<Hedged>;
+
+		/**
+		 * How long the next request waits before it is hedged.
+		 */
+		auto delay() -> std::chrono::milliseconds;
+
+		auto metrics() const -> const HedgeMetrics&
+		{
+			return m_metrics;
+		}
+
+	private:
+		auto exchange(
+		    AsyncSocket& primary,
+		    AsyncSocket& backup,
+		    std::string payload
+		) -> Task<Hedged>;
+
+		auto record(std::chrono::microseconds latency) -> void;
+
+		Reactor& m_reactor;
+		HedgeOptions m_options;
+		HedgeMetrics m_metrics;
+
+		// Hedges still allowed, earned with every request.
+		double m_tokens {0};
+
+		std::vector<std::chrono::microseconds> m_samples;
+		size_t m_next_sample {0};
+		size_t m_since_update {0};
+		std::chrono::milliseconds m_delay;
+	};
+} // namespace sock
+
+#endif // SOCK_HEDGER_H_
@@ -0,0 +1,191 @@
+#ifndef SOCK_HTTP_H_
+#define SOCK_HTTP_H_
+
+#include "sock/connection.hpp"
+#include "sock/runtime.hpp"
+#include "sock/socket.hpp"
+#include "sock/utils.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sock
+{
+	struct HttpHeader
+	{
+		std::string_view name;
+		std::string_view value;
+	};
+
+	/**
+	 * A parsed request. Every view points into the received bytes, except
+	 * a chunked body, which is gathered by the parser. Views stay valid
+	 * until the next request is parsed.
+	 */
+	struct HttpRequest
+	{
+		std::string_view method;
+		std::string_view target;
+		/* 0 for HTTP/1.0, 1 for HTTP/1.1. */
+		int minor_version {1};
+		std::vector<HttpHeader> headers;
+		std::string_view body;
+		/* Whether the connection stays open after the response. */
+		bool keep_alive {true};
+
+		/**
+		 * Value of the first header called `name`, compared case
+		 * insensitively.
+		 */
+		auto header(std::string_view name) const
+		    -> std::optional<std::string_view>;
+	};
+
+	struct HttpResponse
+	{
+		int status {200};
+		/* Extra header lines, `Content-Length` and `Connection` are
+		 * added on sending. */
+		std::string headers;
+		std::string body;
+
+		auto header(std::string_view name, std::string_view value)
+		    -> HttpResponse&
+		{
+			headers.append(name).append(": ").append(value).append("\r\n");
+
+			return *this;
+		}
+	};
+
+	struct HttpLimits
+	{
+		/* Request line and headers, larger ones get 431. */
+		size_t max_head {16 * 1024};
+		size_t max_headers {64};
+		/* Larger bodies get 413. */
+		size_t max_body {1024 * 1024};
+	};
+
+	/**
+	 * Parses HTTP/1.1 requests out of received bytes without copying
+	 * them. Lines are found with `sock::find_delimiter()`, 64 bytes at a
+	 * time, and tokens are checked against a table. Bodies are delimited
+	 * by `Content-Length` or by chunked transfer coding.
+	 */
+	class HttpParser
+	{
+	public:
+		explicit HttpParser(HttpLimits limits = {}) :
+		    m_limits {limits}
+		{}
+
+		/**
+		 * Parses the request at the front of `bytes` into `request`.
+		 * Returns its size, or 0 while it is incomplete or malformed.
+		 */
+		auto parse(std::string_view bytes, HttpRequest& request) -> size_t;
+
+		/**
+		 * Whether the last incomplete request has its head and waits for
+		 * its body after asking for `100 Continue`.
+		 */
+		auto expects_continue() const -> bool
+		{
+			return m_expects_continue;
+		}
+
+		/**
+		 * `Status::FRAME_ERROR` once a request was malformed or too large.
+		 */
+		auto status() const -> Status
+		{
+			return m_error == 0 ? Status::GOOD : Status::FRAME_ERROR;
+		}
+
+		/**
+		 * The response status to reject such a request with.
+		 */
+		auto error() const -> int
+		{
+			return m_error;
+		}
+
+	private:
+		auto fail(int error) -> size_t;
+		auto parse_head(std::string_view head, HttpRequest&) -> bool;
+		auto parse_chunks(std::string_view bytes, bool gather) -> size_t;
+
+		HttpLimits m_limits;
+		int m_error {0};
+		bool m_expects_continue {false};
+		std::string m_body;
+	};
+
+	struct HttpMetrics
+	{
+		std::atomic<uint64_t> requests {0};
+		/* Requests answered with 4xx by the parser. */
+		std::atomic<uint64_t> rejected {0};
+		/* Vectored writes, each carrying one or more responses. */
+		std::atomic<uint64_t> writes {0};
+	};
+
+	/**
+	 * HTTP/1.1 server on the connections of a `sock::Runtime`.
+	 *
+	 * Connections are kept alive unless a request says otherwise, and
+	 * pipelined requests are answered in order: all requests of one read
+	 * are handled before their responses leave, headers and bodies
+	 * together, in one vectored write. Reading pauses while a
+	 * connection's output is above its high watermark.
+	 *
+	 * Handlers run on the core owning the connection. The server must
+	 * outlive the runtime's connections.
+	 */
+	class HttpServer
+	{
+	public:
+		using Handler = std::function<void(const HttpRequest&, HttpResponse&)>;
+
+		explicit HttpServer(Handler, HttpLimits = {});
+
+		HttpServer(const HttpServer&) = delete;
+		HttpServer& operator=(const HttpServer&) = delete;
+
+		/**
+		 * Serves `accepted` on `core`, e.g. from a `Runtime::Acceptor`.
+		 */
+		auto serve(Core& core, sock::Socket&& accepted) -> void;
+
+		auto acceptor() -> Runtime::Acceptor
+		{
+			return [this](Core& core, sock::Socket&& accepted)
+			{
+				serve(core, std::move(accepted));
+			};
+		}
+
+		auto metrics() const -> const HttpMetrics&
+		{
+			return m_metrics;
+		}
+
+	private:
+		struct Session;
+
+		auto on_input(Session&, Connection&) -> void;
+
+		Handler m_handler;
+		HttpLimits m_limits;
+		HttpMetrics m_metrics;
+	};
+} // namespace sock
+
+#endif // SOCK_HTTP_H_
@@ -0,0 +1,95 @@
+#ifndef SOCK_INTERNAL_EPOLL_ENGINE_H_
+#define SOCK_INTERNAL_EPOLL_ENGINE_H_
+
+#include "sock/io_engine.hpp"
+#include "sock/reactor.hpp"
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+namespace sock::internal
+{
+	/**
+	 * Readiness based `sock::IoEngine` built on `sock::Reactor`. Used where
+	 * io_uring is not available. Descriptors handed to it are switched to
+	 * non-blocking mode.
+	 */
+	class EpollEngine : public sock::IoEngine
+	{
+	public:
+		EpollEngine(EngineOptions);
+
+		auto kind() const -> Engine override
+		{
+			return Engine::EPOLL;
+		}
+
+		auto accept(int fd, CompletionHandler) -> IoEngine& override;
+		auto connect(int fd, const sockaddr*, socklen_t, CompletionHandler)
+		    -> IoEngine& override;
+		auto receive(int fd, CompletionHandler) -> IoEngine& override;
+		auto send(int fd, std::string_view, CompletionHandler, bool link)
+		    -> IoEngine& override;
+		auto send_fixed(
+		    int fd,
+		    unsigned buffer,
+		    std::string_view,
+		    CompletionHandler,
+		    bool link
+		) -> IoEngine& override;
+		auto shutdown(int fd, CompletionHandler, bool link)
+		    -> IoEngine& override;
+		auto close(int fd, CompletionHandler) -> IoEngine& override;
+		auto cancel(int fd) -> IoEngine& override;
+		auto register_files(std::span<const int>) -> bool override;
+		auto register_buffers(std::span<const std::span<char>>)
+		    -> bool override;
+		auto submit() -> size_t override;
+		auto run_once(std::chrono::milliseconds) -> size_t override;
+
+	private:
+		enum class Kind
+		{
+			CONNECT,
+			SEND,
+			SHUTDOWN,
+			CLOSE,
+		};
+
+		struct Operation
+		{
+			Kind kind;
+			CompletionHandler handler;
+			std::string_view payload {};
+			size_t sent {0};
+			bool link {false};
+			bool started {false};
+			sockaddr_storage address {};
+			socklen_t address_size {0};
+		};
+
+		struct State
+		{
+			CompletionHandler on_accept;
+			CompletionHandler on_receive;
+			std::deque<Operation> queue;
+			uint32_t events {0};
+			bool blocked {false};
+		};
+
+		auto state(int fd) -> State&;
+		auto update(int fd) -> void;
+		auto on_ready(int fd, uint32_t events) -> void;
+		auto flush(int fd) -> void;
+		auto complete(int fd, int result) -> void;
+
+		EngineOptions m_options;
+		sock::Reactor m_reactor;
+		std::vector<char> m_buffer;
+		std::unordered_map<int, State> m_states;
+		std::vector<int> m_pending;
+		size_t m_dispatched {0};
+	};
+} // namespace sock::internal
+
+#endif // SOCK_INTERNAL_EPOLL_ENGINE_H_
@@ -0,0 +1,111 @@
+#ifndef SOCK_INTERNAL_FRAME_POOL_H_
+#define SOCK_INTERNAL_FRAME_POOL_H_
+
+#include <array>
+#include <cstddef>
+#include <new>
+
+namespace sock::internal
+{
+	/**
+	 * Per-thread cache of coroutine frames. Freed frames are kept in
+	 * size-class free lists and handed out again, so spawning a coroutine
+	 * does not reach `malloc` once the pool is warm.
+	 *
+	 * A frame may be freed on a different thread than it was allocated
+	 * on, it then joins that thread's cache.
+	 */
+	class FramePool
+	{
+	public:
+		static constexpr size_t GRANULARITY = 64;
+		static constexpr size_t CLASSES = 32;
+		static constexpr size_t MAX_CACHED = 1024;
+
+		static auto allocate(size_t size) -> void*
+		{
+			const auto index = size_class(size);
+
+			if (index >= CLASSES)
+			{
+				return ::operator new(size);
+			}
+
+			auto& list = lists()[index];
+
+			if (list.head == nullptr)
+			{
+				misses()++;
+				return ::operator new((index + 1) * GRANULARITY);
+			}
+
+			auto block = list.head;
+			list.head = block->next;
+			list.size--;
+
+			return block;
+		}
+
+		static auto deallocate(void* ptr, size_t size) -> void
+		{
+			const auto index = size_class(size);
+
+			if (index >= CLASSES || lists()[index].size >= MAX_CACHED)
+			{
+				::operator delete(ptr);
+				return;
+			}
+
+			auto& list = lists()[index];
+			list.head = new (ptr) Block {list.head};
+			list.size++;
+		}
+
+		/**
+		 * Amount of allocations on this thread that the cache could not
+		 * serve.
+		 */
+		static auto misses() -> size_t&
+		{
+			thread_local size_t count = 0;
+
+			return count;
+		}
+
+	private:
+		struct Block
+		{
+			Block* next;
+		};
+
+		struct List
+		{
+			Block* head {nullptr};
+			size_t size {0};
+
+			~List()
+			{
+				while (head != nullptr)
+				{
+					auto next = head->next;
+					::operator delete(head);
+					head = next;
+				}
+			}
+		};
+
+		static constexpr auto size_class(size_t size) -> size_t
+		{
+			return (size + GRANULARITY - 1) / GRANULARITY - 1;
+		}
+
+		static auto lists() -> std::array<List, CLASSES>&
+		{
+			thread_local std::array<List, CLASSES> instance;
+
+			return instance;
+		}
+	};
+} // namespace sock::internal
+
+#endif // SOCK_INTERNAL_FRAME_POOL_H_
@@ -0,0 +1,45 @@
+#ifndef SOCK_INTERNAL_LOCAL_ADDRESS_H_
+#define SOCK_INTERNAL_LOCAL_ADDRESS_H_
+
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+namespace sock::internal
+{
+	/**
+	 * Fills `address` with `AF_UNIX` path `path`. A leading '@' selects
+	 * Linux's abstract namespace, which needs no file and vanishes with
+	 * the last socket. Returns the length to pass along with `address`,
+	 * 0 if `path` does not fit.
+	 */
+	inline auto local_address(std::string_view path, sockaddr_un& address)
+	    -> socklen_t
+	{
+		address = {};
+		address.sun_family = AF_UNIX;
+
+		// Abstract names are not NUL-terminated, the length delimits them.
+		const bool abstract = path.starts_with('@');
+
+		if (path.empty() || path.size() + !abstract > sizeof(address.sun_path))
+		{
+			return 0;
+		}
+
+		std::memcpy(address.sun_path, path.data(), path.size());
+
+		if (abstract)
+		{
+			address.sun_path[0] = '\0';
+
+			return offsetof(sockaddr_un, sun_path) + path.size();
+		}
+
+		return offsetof(sockaddr_un, sun_path) + path.size() + 1;
+	}
+} // namespace sock::internal
+
+#endif // SOCK_INTERNAL_LOCAL_ADDRESS_H_
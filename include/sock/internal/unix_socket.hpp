@@ -2,19 +2,28 @@
 #define SOCK_UNIX_SOCKET_H_
 
 #include "sock/buffer.hpp"
+#include "sock/endpoint.hpp"
 #include "sock/utils.hpp"
 #include <chrono>
 #include <functional>
+#include <utility>
 
 namespace sock::internal
 {
 	class UnixSocket
 	{
 	public:
-		UnixSocket();
+		UnixSocket() {};
 		UnixSocket(int fd) : m_fd {fd} {};
 		UnixSocket(CtorArgs);
 		UnixSocket(const UnixSocket&) = delete;
+
+		/**
+		 * Two connected `AF_UNIX` sockets of `args.type`, the other
+		 * fields of `args` do not matter.
+		 */
+		static auto pair(CtorArgs args) -> std::pair<UnixSocket, UnixSocket>;
+
 		UnixSocket(UnixSocket&& other)
 		{
 			*this = std::move(other);
@@ -29,8 +38,21 @@ namespace sock::internal
 		{
 			if (this != &other)
 			{
+				if (m_fd >= 0)
+				{
+					shutdown();
+					close(m_fd);
+				}
+
 				m_status = other.m_status;
 				m_fd = other.m_fd;
+				m_domain = other.m_domain;
+				m_socket_type = other.m_socket_type;
+				m_protocol = other.m_protocol;
+				m_flags = other.m_flags;
+				m_dual_stack = other.m_dual_stack;
+
+				other.m_fd = -1;
 			}
 
 			return *this;
@@ -39,24 +61,66 @@ namespace sock::internal
 		auto option(sock::Option, std::chrono::milliseconds) -> UnixSocket&;
 		auto option(sock::Option, int) -> UnixSocket&;
 		auto bind(sock::Address) -> UnixSocket&;
+
+		/**
+		 * Binds to an already resolved address, no lookup involved.
+		 */
+		auto bind(const sock::Endpoint&) -> UnixSocket&;
 		auto listen(size_t backlog) -> UnixSocket&;
 		auto connect(sock::Address) -> UnixSocket&;
+
+		/**
+		 * Connects to an already resolved address, no lookup involved.
+		 */
+		auto connect(const sock::Endpoint&) -> UnixSocket&;
+
+		/**
+		 * Like `connect(sock::Address)`, but gives up on each resolved
+		 * address after `timeout` instead of waiting out the kernel's SYN
+		 * retries, and moves on to the next one. Zero waits as long as
+		 * the kernel does. Ends with `Status::TIMED_OUT` if the last
+		 * address did not answer in time.
+		 * Every attempt after the first uses a fresh descriptor, so
+		 * options set beforehand only hold for the first one.
+		 */
+		auto connect(sock::Address, std::chrono::milliseconds timeout)
+		    -> UnixSocket&;
 		auto accept() -> UnixSocket;
 		auto receive(sock::Buffer&, int flags = 0) -> void;
 		auto send(std::string_view) -> UnixSocket&;
 		auto shutdown() -> void;
 
+		/**
+		 * Switches `O_NONBLOCK` on or off. Required for sockets that are
+		 * driven by `sock::Reactor`.
+		 */
+		auto non_blocking(bool) -> UnixSocket&;
+
 		constexpr auto is_valid() const -> bool { return m_status != Status::GOOD; }
 		constexpr auto status() const -> Status { return m_status; }
 
+		/**
+		 * Returns underlying file descriptor.
+		 */
+		constexpr auto native_handle() const -> int { return m_fd; }
+
+		/**
+		 * Gives up ownership of the descriptor without shutting the
+		 * connection down, e.g. once it was handed to another process.
+		 */
+		auto release() -> int { return std::exchange(m_fd, -1); }
+
 	private:
+		auto hints() const -> addrinfo;
+
 		Status m_status {Status::GOOD};
 
-		int m_fd;
-		int m_domain;
-		int m_socket_type;
-		int m_protocol;
-		int m_flags;
+		int m_fd {-1};
+		int m_domain {0};
+		int m_socket_type {0};
+		int m_protocol {0};
+		int m_flags {0};
+		bool m_dual_stack {false};
 	};
 } // namespace sock
 
@@ -0,0 +1,115 @@
+#ifndef SOCK_INTERNAL_URING_ENGINE_H_
+#define SOCK_INTERNAL_URING_ENGINE_H_
+
+#include "sock/io_engine.hpp"
+#include <linux/io_uring.h>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace sock::internal
+{
+	/**
+	 * io_uring backed `sock::IoEngine`. Uses multishot accept and receive,
+	 * a provided buffer ring the kernel picks receive buffers from, and
+	 * fixed files and buffers when registered.
+	 */
+	class UringEngine : public sock::IoEngine
+	{
+	public:
+		UringEngine(EngineOptions);
+		~UringEngine();
+
+		UringEngine(const UringEngine&) = delete;
+		UringEngine& operator=(const UringEngine&) = delete;
+
+		auto kind() const -> Engine override
+		{
+			return Engine::IO_URING;
+		}
+
+		auto accept(int fd, CompletionHandler) -> IoEngine& override;
+		auto connect(int fd, const sockaddr*, socklen_t, CompletionHandler)
+		    -> IoEngine& override;
+		auto receive(int fd, CompletionHandler) -> IoEngine& override;
+		auto send(int fd, std::string_view, CompletionHandler, bool link)
+		    -> IoEngine& override;
+		auto send_fixed(
+		    int fd,
+		    unsigned buffer,
+		    std::string_view,
+		    CompletionHandler,
+		    bool link
+		) -> IoEngine& override;
+		auto shutdown(int fd, CompletionHandler, bool link)
+		    -> IoEngine& override;
+		auto close(int fd, CompletionHandler) -> IoEngine& override;
+		auto cancel(int fd) -> IoEngine& override;
+		auto register_files(std::span<const int>) -> bool override;
+		auto register_buffers(std::span<const std::span<char>>)
+		    -> bool override;
+		auto submit() -> size_t override;
+		auto run_once(std::chrono::milliseconds) -> size_t override;
+
+	private:
+		struct Operation
+		{
+			uint8_t opcode;
+			int fd;
+			CompletionHandler handler;
+			std::string_view payload {};
+			unsigned buffer {0};
+			int sent {0};
+			bool cancelled {false};
+			sockaddr_storage address {};
+			socklen_t address_size {0};
+		};
+
+		auto next_sqe() -> io_uring_sqe*;
+		auto prepare(uint64_t id, Operation&, bool link) -> void;
+		auto start(std::unique_ptr<Operation>, bool link = false) -> void;
+		auto dispatch(const io_uring_cqe&) -> void;
+		auto recycle(uint16_t buffer_id) -> void;
+		auto enter(
+		    unsigned submit,
+		    unsigned wait,
+		    unsigned flags,
+		    void* arg,
+		    size_t arg_size
+		) -> int;
+
+		EngineOptions m_options;
+		int m_ring_fd {-1};
+
+		void* m_sq_ring {nullptr};
+		size_t m_sq_ring_size {0};
+		void* m_cq_ring {nullptr};
+		size_t m_cq_ring_size {0};
+		io_uring_sqe* m_sqes {nullptr};
+		size_t m_sqes_size {0};
+
+		unsigned* m_sq_head {nullptr};
+		unsigned* m_sq_tail {nullptr};
+		unsigned* m_sq_array {nullptr};
+		unsigned m_sq_mask {0};
+		unsigned m_sq_entries {0};
+		unsigned m_sq_local_tail {0};
+		unsigned m_to_submit {0};
+
+		unsigned* m_cq_head {nullptr};
+		unsigned* m_cq_tail {nullptr};
+		unsigned m_cq_mask {0};
+		io_uring_cqe* m_cqes {nullptr};
+
+		io_uring_buf_ring* m_buf_ring {nullptr};
+		size_t m_buf_ring_size {0};
+		std::vector<char> m_buffers;
+
+		uint64_t m_next_id {1};
+		std::unordered_map<uint64_t, std::unique_ptr<Operation>> m_operations;
+		std::unordered_map<int, int> m_fixed_files;
+		bool m_buffers_registered {false};
+	};
+} // namespace sock::internal
+
+#endif // SOCK_INTERNAL_URING_ENGINE_H_
@@ -2,8 +2,10 @@
 #define SOCK_WINDOWS_SOCKET_H_
 
 #include "sock/buffer.hpp"
+#include "sock/endpoint.hpp"
 #include "sock/utils.hpp"
 #include <chrono>
+#include <utility>
 
 namespace sock::internal
 {
@@ -44,12 +46,23 @@ namespace sock::internal
 		auto option(sock::Option, int value) -> WindowsSocket&;
 		auto option(sock::Option, std::chrono::milliseconds) -> WindowsSocket&;
 		auto bind(sock::Address) -> WindowsSocket&;
+		auto bind(const sock::Endpoint&) -> WindowsSocket&;
 		auto listen(size_t backlog) -> WindowsSocket&;
 		auto connect(sock::Address) -> WindowsSocket&;
+		auto connect(const sock::Endpoint&) -> WindowsSocket&;
+
+		/**
+		 * Gives up on each resolved address after `timeout`, zero waits
+		 * as long as the system does.
+		 * @see sock::internal::UnixSocket::connect()
+		 */
+		auto connect(sock::Address, std::chrono::milliseconds timeout)
+		    -> WindowsSocket&;
 		auto accept() -> WindowsSocket;
 		auto receive(sock::Buffer&, int flags = 0) -> void;
 		auto send(std::string_view) -> WindowsSocket&;
 		auto shutdown() -> void;
+		auto non_blocking(bool) -> WindowsSocket&;
 
 		auto is_valid() const -> bool
 		{
@@ -61,6 +74,19 @@ namespace sock::internal
 			return m_status;
 		};
 
+		auto native_handle() const -> SOCKET
+		{
+			return m_sock;
+		};
+
+		/**
+		 * Gives up ownership of the socket without closing it.
+		 */
+		auto release() -> SOCKET
+		{
+			return std::exchange(m_sock, INVALID_SOCKET);
+		};
+
 	private:
 		Status m_status {Status::GOOD};
 		SOCKET m_sock {INVALID_SOCKET};
@@ -0,0 +1,177 @@
+#ifndef SOCK_INTERNAL_WORK_STEALING_DEQUE_H_
+#define SOCK_INTERNAL_WORK_STEALING_DEQUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace sock::internal
+{
+	/**
+	 * Chase-Lev deque: the owning thread pushes and pops at the bottom,
+	 * any other thread may steal from the top.
+	 *
+	 * Follows "Correct and Efficient Work-Stealing for Weak Memory Models"
+	 * (Lê et al., 2013). `T` must be trivially copyable, in practice a
+	 * pointer.
+	 */
+	template<class T>
+	class WorkStealingDeque
+	{
+	public:
+		/**
+		 * `capacity` must be a power of two.
+		 */
+		explicit WorkStealingDeque(size_t capacity = 256) :
+		    m_array {new Array(capacity)}
+		{}
+
+		WorkStealingDeque(const WorkStealingDeque&) = delete;
+		WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+		~WorkStealingDeque()
+		{
+			delete m_array.load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * Owner only.
+		 */
+		auto push(T item) -> void
+		{
+			const auto b = m_bottom.load(std::memory_order_relaxed);
+			const auto t = m_top.load(std::memory_order_acquire);
+			auto array = m_array.load(std::memory_order_relaxed);
+
+			if (b - t > static_cast<int64_t>(array->capacity) - 1)
+			{
+				array = grow(array, t, b);
+			}
+
+			array->put(b, item);
+			std::atomic_thread_fence(std::memory_order_release);
+			m_bottom.store(b + 1, std::memory_order_relaxed);
+		}
+
+		/**
+		 * Owner only. Returns false when empty.
+		 */
+		auto pop(T& item) -> bool
+		{
+			const auto b = m_bottom.load(std::memory_order_relaxed) - 1;
+			const auto array = m_array.load(std::memory_order_relaxed);
+			m_bottom.store(b, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			auto t = m_top.load(std::memory_order_relaxed);
+
+			if (t > b)
+			{
+				m_bottom.store(b + 1, std::memory_order_relaxed);
+				return false;
+			}
+
+			item = array->get(b);
+
+			if (t == b)
+			{
+				// Last item, race thieves for it.
+				const auto won = m_top.compare_exchange_strong(
+				    t,
+				    t + 1,
+				    std::memory_order_seq_cst,
+				    std::memory_order_relaxed
+				);
+				m_bottom.store(b + 1, std::memory_order_relaxed);
+
+				return won;
+			}
+
+			return true;
+		}
+
+		/**
+		 * Any thread. Returns false when empty or when another thread won
+		 * the race for the top item.
+		 */
+		auto steal(T& item) -> bool
+		{
+			auto t = m_top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			const auto b = m_bottom.load(std::memory_order_acquire);
+
+			if (t >= b)
+			{
+				return false;
+			}
+
+			const auto array = m_array.load(std::memory_order_acquire);
+			item = array->get(t);
+
+			return m_top.compare_exchange_strong(
+			    t,
+			    t + 1,
+			    std::memory_order_seq_cst,
+			    std::memory_order_relaxed
+			);
+		}
+
+		/**
+		 * Approximate amount of items.
+		 */
+		auto size() const -> size_t
+		{
+			const auto b = m_bottom.load(std::memory_order_relaxed);
+			const auto t = m_top.load(std::memory_order_relaxed);
+
+			return b > t ? static_cast<size_t>(b - t) : 0;
+		}
+
+	private:
+		struct Array
+		{
+			explicit Array(size_t c) :
+			    capacity {c},
+			    items {std::make_unique<std::atomic<T>[]>(c)}
+			{}
+
+			auto get(int64_t i) const -> T
+			{
+				return items[i & (capacity - 1)].load(std::memory_order_relaxed);
+			}
+
+			auto put(int64_t i, T item) -> void
+			{
+				items[i & (capacity - 1)].store(item, std::memory_order_relaxed);
+			}
+
+			size_t capacity;
+			std::unique_ptr<std::atomic<T>[]> items;
+		};
+
+		auto grow(Array* array, int64_t top, int64_t bottom) -> Array*
+		{
+			auto bigger = new Array(array->capacity * 2);
+
+			for (auto i = top; i < bottom; i++)
+			{
+				bigger->put(i, array->get(i));
+			}
+
+			// Thieves may still read from the old array, so it is kept
+			// until the deque is destroyed.
+			m_retired.emplace_back(array);
+			m_array.store(bigger, std::memory_order_release);
+
+			return bigger;
+		}
+
+		alignas(64) std::atomic<int64_t> m_top {0};
+		alignas(64) std::atomic<int64_t> m_bottom {0};
+		alignas(64) std::atomic<Array*> m_array;
+		std::vector<std::unique_ptr<Array>> m_retired;
+	};
+} // namespace sock::internal
+
+#endif // SOCK_INTERNAL_WORK_STEALING_DEQUE_H_
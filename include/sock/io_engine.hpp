@@ -0,0 +1,178 @@
+#ifndef SOCK_IO_ENGINE_H_
+#define SOCK_IO_ENGINE_H_
+
+#include "sock/utils.hpp"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <sys/socket.h>
+
+namespace sock
+{
+	enum class Engine
+	{
+		/* io_uring when the kernel supports it, epoll otherwise. */
+		AUTO,
+		IO_URING,
+		EPOLL,
+	};
+
+	constexpr std::string_view str_engine(sock::Engine engine)
+	{
+		switch (engine)
+		{
+			case sock::Engine::AUTO:
+				return "auto";
+			case sock::Engine::IO_URING:
+				return "io_uring";
+			case sock::Engine::EPOLL:
+				return "epoll";
+		}
+
+		return "UNKNOWN ENGINE";
+	}
+
+	struct EngineOptions
+	{
+		/* Submission queue size. */
+		unsigned queue_depth {256};
+		/* Amount of receive buffers, must be a power of two. */
+		unsigned buffer_count {256};
+		/* Size of each receive buffer. */
+		unsigned buffer_size {4096};
+	};
+
+	struct Completion
+	{
+		/* Non-negative on success, `-errno` on failure. */
+		int result;
+		/*
+		 * Received bytes of a `receive()` completion. Only valid during the
+		 * handler call, the buffer is handed back to the kernel afterwards.
+		 */
+		std::string_view data {};
+		/* Operation stays armed and will complete again. */
+		bool more {false};
+	};
+
+	using CompletionHandler = std::function<void(const Completion&)>;
+
+	/**
+	 * Completion based I/O. Operations are queued and handed to the kernel
+	 * in batches by `submit()` or `run_once()`; handlers are called from
+	 * `run_once()`.
+	 *
+	 * Payloads of `send()` must stay alive until their completion.
+	 */
+	class IoEngine
+	{
+	public:
+		virtual ~IoEngine() = default;
+
+		virtual auto kind() const -> Engine = 0;
+
+		/**
+		 * Accepts connections on `fd` until cancelled. `result` is a
+		 * descriptor of an accepted connection.
+		 */
+		virtual auto accept(int fd, CompletionHandler) -> IoEngine& = 0;
+
+		virtual auto connect(
+		    int fd,
+		    const sockaddr* address,
+		    socklen_t address_size,
+		    CompletionHandler
+		) -> IoEngine& = 0;
+
+		/**
+		 * Receives from `fd` until end of stream, an error or cancellation.
+		 * The buffer is picked by the engine.
+		 */
+		virtual auto receive(int fd, CompletionHandler) -> IoEngine& = 0;
+
+		/**
+		 * Sends whole `payload`. When `link` is set the next operation
+		 * queued on this engine starts only after this one succeeds and is
+		 * cancelled otherwise.
+		 */
+		virtual auto send(
+		    int fd,
+		    std::string_view payload,
+		    CompletionHandler,
+		    bool link = false
+		) -> IoEngine& = 0;
+
+		/**
+		 * Sends `payload`, which must lie in registered buffer `buffer`.
+		 */
+		virtual auto send_fixed(
+		    int fd,
+		    unsigned buffer,
+		    std::string_view payload,
+		    CompletionHandler,
+		    bool link = false
+		) -> IoEngine& = 0;
+
+		virtual auto shutdown(int fd, CompletionHandler, bool link = false)
+		    -> IoEngine& = 0;
+
+		virtual auto close(int fd, CompletionHandler) -> IoEngine& = 0;
+
+		/**
+		 * Cancels armed `accept()` and `receive()` operations of `fd`.
+		 * Their handlers are called with `-ECANCELED`.
+		 */
+		virtual auto cancel(int fd) -> IoEngine& = 0;
+
+		/**
+		 * Registers descriptors with the kernel so operations on them skip
+		 * per-call file lookup. Replaces previously registered ones.
+		 */
+		virtual auto register_files(std::span<const int> fds) -> bool = 0;
+
+		/**
+		 * Registers (pins) memory for `send_fixed()`.
+		 */
+		virtual auto register_buffers(std::span<const std::span<char>>)
+		    -> bool = 0;
+
+		/**
+		 * Hands queued operations to the kernel. Returns their amount.
+		 */
+		virtual auto submit() -> size_t = 0;
+
+		/**
+		 * Submits queued operations, waits for at most `timeout` (forever
+		 * if negative) and dispatches completions. Returns the amount of
+		 * dispatched completions.
+		 */
+		virtual auto run_once(
+		    std::chrono::milliseconds timeout = std::chrono::milliseconds {-1}
+		) -> size_t = 0;
+
+		auto is_valid() const -> bool
+		{
+			return m_status != Status::GOOD;
+		}
+
+		auto status() const -> Status
+		{
+			return m_status;
+		}
+
+	protected:
+		Status m_status {Status::GOOD};
+	};
+
+	/**
+	 * Creates an I/O engine. With `Engine::AUTO` the `SOCK_IO_ENGINE`
+	 * environment variable (`io_uring` or `epoll`) is honoured, otherwise
+	 * io_uring is tried first and epoll is used if it is unavailable.
+	 */
+	auto make_io_engine(Engine = Engine::AUTO, EngineOptions = {})
+	    -> std::unique_ptr<IoEngine>;
+} // namespace sock
+
+#endif // SOCK_IO_ENGINE_H_
@@ -0,0 +1,80 @@
+#ifndef SOCK_LISTENER_GROUP_H_
+#define SOCK_LISTENER_GROUP_H_
+
+#include "sock/socket.hpp"
+#include "sock/utils.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace sock
+{
+	struct ListenerGroupOptions
+	{
+		size_t backlog {SOMAXCONN};
+
+		/**
+		 * Attach a classic BPF program that hands each connection to
+		 * listener `cpu % size()`, where `cpu` is the CPU that received
+		 * the connection's packets.
+		 */
+		bool steer_by_cpu {false};
+	};
+
+	/**
+	 * Several `SO_REUSEPORT` listeners bound to the same address, one per
+	 * worker thread. The kernel spreads incoming connections between them,
+	 * so no accept thread or lock is shared.
+	 *
+	 * With `steer_by_cpu` a worker pinned to CPU `i` that accepts on
+	 * `listener(i)` handles only connections whose packets arrived on its
+	 * own CPU.
+	 */
+	class ListenerGroup
+	{
+	public:
+		ListenerGroup(
+		    CtorArgs,
+		    sock::Address,
+		    size_t size,
+		    ListenerGroupOptions = {}
+		);
+
+		ListenerGroup(const ListenerGroup&) = delete;
+		ListenerGroup& operator=(const ListenerGroup&) = delete;
+		ListenerGroup(ListenerGroup&&) = default;
+		ListenerGroup& operator=(ListenerGroup&&) = default;
+
+		auto size() const -> size_t
+		{
+			return m_listeners.size();
+		}
+
+		auto listener(size_t index) -> sock::Socket&
+		{
+			return m_listeners[index];
+		}
+
+		auto begin()
+		{
+			return m_listeners.begin();
+		}
+
+		auto end()
+		{
+			return m_listeners.end();
+		}
+
+		auto status() const -> Status
+		{
+			return m_status;
+		}
+
+	private:
+		auto steer_by_cpu() -> void;
+
+		Status m_status {Status::GOOD};
+		std::vector<sock::Socket> m_listeners;
+	};
+} // namespace sock
+
+#endif // SOCK_LISTENER_GROUP_H_
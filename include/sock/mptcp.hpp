@@ -0,0 +1,52 @@
+#ifndef SOCK_MPTCP_H_
+#define SOCK_MPTCP_H_
+
+#include "sock/endpoint.hpp"
+#include "sock/socket.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace sock
+{
+	struct Subflow
+	{
+		Endpoint local;
+		Endpoint remote;
+	};
+
+	/**
+	 * State of a Multipath TCP connection.
+	 *
+	 * Which extra subflows get opened is up to the kernel's path manager,
+	 * e.g. after `ip mptcp endpoint add 127.0.0.2 dev lo subflow` and
+	 * `ip mptcp limits set subflows 2` a connection between loopback
+	 * addresses also goes over 127.0.0.2.
+	 */
+	struct MptcpInfo
+	{
+		/* False for plain TCP sockets and for MPTCP connections that fell
+		 * back to TCP, e.g. because the peer does not speak MPTCP. */
+		bool active {false};
+		/* Subflows besides the initial one, and their limit. */
+		uint8_t extra_subflows {0};
+		uint8_t max_subflows {0};
+		/* Addresses announced to, and accepted from, the peer. */
+		uint8_t addresses_signalled {0};
+		uint8_t addresses_accepted {0};
+		/* One per established path. */
+		std::vector<Subflow> subflows;
+	};
+
+	/**
+	 * Whether `socket` was created with `Protocol::MPTCP` and the kernel
+	 * did not fall back to plain TCP sockets.
+	 */
+	auto is_mptcp(const sock::Socket& socket) -> bool;
+
+	/**
+	 * Reports the subflows of a connected `Protocol::MPTCP` socket.
+	 */
+	auto mptcp_status(const sock::Socket& socket) -> MptcpInfo;
+} // namespace sock
+
+#endif // SOCK_MPTCP_H_
@@ -0,0 +1,142 @@
+#ifndef SOCK_MULTIPLEXER_H_
+#define SOCK_MULTIPLEXER_H_
+
+#include "sock/framing.hpp"
+#include "sock/reactor.hpp"
+#include "sock/send_queue.hpp"
+#include "sock/socket.hpp"
+#include "sock/utils.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace sock
+{
+	/**
+	 * How `sock::Multiplexer` tells which request a response answers.
+	 */
+	enum class Matching
+	{
+		/* Responses carry the correlation id of their request and may
+		 * come in any order. Both directions use frames of a 4 byte
+		 * length of the rest, a 4 byte id and the payload, big-endian. */
+		ID,
+		/* Responses come in the order of requests, as with pipelined
+		 * HTTP/1.1 or Redis. Requests are written as they are. */
+		ORDER,
+	};
+
+	struct Reply
+	{
+		Status status;
+		std::string payload;
+	};
+
+	struct MultiplexerMetrics
+	{
+		std::atomic<uint64_t> requests {0};
+		std::atomic<uint64_t> responses {0};
+		/* Writes to the socket, each carrying one or more requests. */
+		std::atomic<uint64_t> flushes {0};
+	};
+
+	/**
+	 * Keeps many requests in flight on one client connection instead of
+	 * waiting a round trip for every reply.
+	 *
+	 * Any thread may `call()`. Requests are queued without touching the
+	 * socket and written out by the reactor thread in batches, one
+	 * `writev()` for all queued so far. Replies complete callbacks on the
+	 * reactor thread, or futures.
+	 *
+	 * Once the connection fails, every outstanding and later request
+	 * completes with the error. Must be destroyed on the reactor thread,
+	 * outstanding requests then complete with `Status::CANCELLED`.
+	 */
+	class Multiplexer
+	{
+	public:
+		using Callback = std::function<void(Reply)>;
+
+		/**
+		 * For `Matching::ORDER`: the size of the response at the front
+		 * of `bytes`, or 0 while it is incomplete.
+		 */
+		using Framer = std::function<size_t(std::string_view bytes)>;
+
+		Multiplexer(
+		    Reactor&,
+		    sock::Socket&& connected,
+		    Matching = Matching::ID,
+		    Framer = {}
+		);
+		~Multiplexer();
+
+		Multiplexer(const Multiplexer&) = delete;
+		Multiplexer& operator=(const Multiplexer&) = delete;
+
+		/**
+		 * Sends `payload` and calls `callback` with the response. Thread
+		 * safe. On a failed connection `callback` is called right away,
+		 * on this thread.
+		 */
+		auto call(std::string_view payload, Callback callback) -> void;
+
+		auto call(std::string_view payload) -> std::future<Reply>;
+
+		/**
+		 * Requests not answered yet.
+		 */
+		auto in_flight() -> size_t;
+
+		auto status() const -> Status
+		{
+			return m_status.load(std::memory_order_acquire);
+		}
+
+		auto metrics() const -> const MultiplexerMetrics&
+		{
+			return m_metrics;
+		}
+
+	private:
+		auto on_events(uint32_t events) -> void;
+		auto flush() -> void;
+		auto receive() -> void;
+		auto decode(std::string_view bytes) -> void;
+		auto split() -> void;
+		auto complete(uint32_t id, std::string_view payload) -> void;
+		auto fail(Status) -> void;
+
+		Reactor& m_reactor;
+		sock::Socket m_sock;
+		Matching m_matching;
+		Framer m_framer;
+		std::atomic<Status> m_status {Status::GOOD};
+		MultiplexerMetrics m_metrics;
+
+		// Registering a request and queueing it happen together, so
+		// that `m_ordered` is in the order of the wire.
+		std::mutex m_lock;
+		uint32_t m_next_id {0};
+		std::unordered_map<uint32_t, Callback> m_by_id;
+		std::deque<Callback> m_ordered;
+		SendQueue m_output;
+
+		// Reactor thread only, responses to ids are framed by
+		// `m_frames`, those in order are gathered in `m_input`.
+		FrameDecoder m_frames;
+		std::string m_input;
+		size_t m_input_offset {0};
+		bool m_writing {false};
+	};
+} // namespace sock
+
+#endif // SOCK_MULTIPLEXER_H_
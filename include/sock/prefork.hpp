@@ -0,0 +1,121 @@
+#ifndef SOCK_PREFORK_H_
+#define SOCK_PREFORK_H_
+
+#include "sock/fd_channel.hpp"
+#include "sock/reactor.hpp"
+#include "sock/socket.hpp"
+#include "sock/utils.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <sys/types.h>
+#include <vector>
+
+namespace sock
+{
+	struct PreforkOptions
+	{
+		/* Amount of worker processes, 0 means one per available CPU. */
+		size_t workers {0};
+		int backlog {SOMAXCONN};
+	};
+
+	/**
+	 * Pre-fork model: this process owns the listener and accepts, worker
+	 * processes get the connections in batches over a `sock::FdChannel`,
+	 * round-robin. Workers do not share the listener, so one can be
+	 * restarted while the others keep serving.
+	 *
+	 * A worker is `worker(index, channel)` run in a forked child, which
+	 * exits once it returns. It should serve whatever
+	 * `channel.receive()` yields until that returns zero.
+	 */
+	class Prefork
+	{
+	public:
+		using Worker = std::function<void(size_t index, FdChannel&)>;
+
+		Prefork(CtorArgs, sock::Address, Worker, PreforkOptions = {});
+
+		Prefork(const Prefork&) = delete;
+		Prefork& operator=(const Prefork&) = delete;
+
+		/**
+		 * Stops the workers and waits for them.
+		 */
+		~Prefork();
+
+		/**
+		 * Forks the workers.
+		 */
+		auto start() -> Prefork&;
+
+		/**
+		 * Accepts and hands connections off until `stop()`.
+		 */
+		auto run() -> void;
+
+		/**
+		 * Makes `run()` return. Thread safe.
+		 */
+		auto stop() -> void;
+
+		/**
+		 * Replaces worker `index` with a fresh process. The old one sees
+		 * its channel close, so it may finish what it has. Call it on the
+		 * thread running `run()`, e.g. through `reactor().post()`, or
+		 * while `run()` is not running.
+		 */
+		auto restart(size_t index) -> void;
+
+		auto size() const -> size_t
+		{
+			return m_workers.size();
+		}
+
+		auto pid(size_t index) const -> pid_t
+		{
+			return m_workers[index].pid;
+		}
+
+		auto reactor() -> Reactor&
+		{
+			return m_reactor;
+		}
+
+		/**
+		 * Amount of connections handed to workers.
+		 */
+		auto handed_off() const -> uint64_t
+		{
+			return m_handed_off;
+		}
+
+		auto status() const -> Status
+		{
+			return m_status;
+		}
+
+	private:
+		struct Process
+		{
+			pid_t pid {-1};
+			FdChannel channel;
+		};
+
+		auto spawn(size_t index) -> void;
+		auto accept() -> void;
+		auto reap(bool wait) -> void;
+
+		Status m_status {Status::GOOD};
+		sock::Socket m_listener;
+		Worker m_worker;
+		Reactor m_reactor;
+		std::vector<Process> m_workers;
+		std::vector<pid_t> m_retired;
+		size_t m_next {0};
+		uint64_t m_handed_off {0};
+	};
+} // namespace sock
+
+#endif // SOCK_PREFORK_H_
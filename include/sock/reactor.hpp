@@ -0,0 +1,297 @@
+#ifndef SOCK_REACTOR_H_
+#define SOCK_REACTOR_H_
+
+#include "sock/socket.hpp"
+#include "sock/socket_wrapper.hpp"
+#include "sock/utils.hpp"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <sys/epoll.h>
+#include <unordered_map>
+#include <vector>
+
+namespace sock
+{
+	/**
+	 * Readiness events a file descriptor can be registered for.
+	 * Values may be combined.
+	 */
+	enum Events : uint32_t
+	{
+		READABLE = EPOLLIN,
+		WRITABLE = EPOLLOUT,
+		PRIORITY = EPOLLPRI,
+		PEER_CLOSED = EPOLLRDHUP,
+		HANGUP = EPOLLHUP,
+		FAILURE = EPOLLERR,
+		/* Report readiness only on state change (EPOLLET). */
+		EDGE_TRIGGERED = EPOLLET,
+		/* Disarm descriptor after the first event (EPOLLONESHOT). */
+		ONE_SHOT = EPOLLONESHOT,
+	};
+
+	/**
+	 * How `sock::Reactor::run_once()` waits for events: poll without
+	 * blocking for `spin`, keep polling but yield the CPU between polls for
+	 * `yield`, then block in `epoll_wait`. Spinning trades CPU time for
+	 * not paying the wakeup latency of a blocked thread.
+	 */
+	struct WaitStrategy
+	{
+		std::chrono::microseconds spin {0};
+		std::chrono::microseconds yield {0};
+
+		/**
+		 * Shrink the spin phase while it keeps coming up empty, grow it
+		 * back up to `spin` while events arrive soon after blocking.
+		 */
+		bool adaptive {false};
+
+		/**
+		 * Block right away. The default.
+		 */
+		static constexpr auto blocking() -> WaitStrategy
+		{
+			return {};
+		}
+
+		/**
+		 * Never block, burn the core.
+		 */
+		static constexpr auto busy_polling() -> WaitStrategy
+		{
+			return {.spin = std::chrono::microseconds::max()};
+		}
+
+		static constexpr auto hybrid(
+		    std::chrono::microseconds spin = std::chrono::microseconds {50},
+		    std::chrono::microseconds yield = std::chrono::microseconds {50}
+		) -> WaitStrategy
+		{
+			return {.spin = spin, .yield = yield, .adaptive = true};
+		}
+	};
+
+	/**
+	 * Where a `sock::Reactor` spent its waiting time.
+	 */
+	struct WaitStats
+	{
+		/* Time spent polling in the spin and yield phases. */
+		std::chrono::nanoseconds spinning {0};
+		/* Time spent blocked in `epoll_wait`. */
+		std::chrono::nanoseconds blocked {0};
+		/* Waits that found events while polling. */
+		uint64_t spin_hits {0};
+		/* Waits that had to block. */
+		uint64_t blocks {0};
+	};
+
+	/**
+	 * An epoll based event loop. Multiplexes many sockets on one thread,
+	 * dispatches readiness handlers and timers.
+	 *
+	 * Every member function except `post()`, `wakeup()` and `stop()` must be
+	 * called from the thread that runs the loop.
+	 */
+	class Reactor
+	{
+	public:
+		using Handler = std::function<void(uint32_t events)>;
+		using Callback = std::function<void()>;
+		using TimerId = uint64_t;
+		using Clock = std::chrono::steady_clock;
+
+		Reactor();
+		~Reactor();
+
+		Reactor(const Reactor&) = delete;
+		Reactor& operator=(const Reactor&) = delete;
+
+		/**
+		 * Registers `fd` for `events`. Level-triggered unless
+		 * `Events::EDGE_TRIGGERED` is set.
+		 */
+		auto add(int fd, uint32_t events, Handler handler) -> Reactor&;
+
+		auto add(sock::Socket& socket, uint32_t events, Handler handler)
+		    -> Reactor&
+		{
+			return add(socket.native_handle(), events, std::move(handler));
+		}
+
+		/**
+		 * Registers a wrapped socket. `wrapper` must outlive its
+		 * registration.
+		 */
+		auto add(
+		    sock::SocketWrapper& wrapper,
+		    uint32_t events,
+		    std::function<void(sock::SocketWrapper&, uint32_t)> handler
+		) -> Reactor&
+		{
+			return add(
+			    wrapper.native_handle(),
+			    events,
+			    [&wrapper, h = std::move(handler)](uint32_t e)
+			    {
+				    h(wrapper, e);
+			    }
+			);
+		}
+
+		/**
+		 * Changes the set of events `fd` is registered for. Re-arms
+		 * descriptors registered with `Events::ONE_SHOT`.
+		 */
+		auto modify(int fd, uint32_t events) -> Reactor&;
+
+		/**
+		 * Unregisters `fd`. Safe to call from inside of fd's own handler.
+		 */
+		auto remove(int fd) -> Reactor&;
+
+		/**
+		 * Calls `callback` once after `delay`.
+		 */
+		auto after(std::chrono::milliseconds delay, Callback callback)
+		    -> TimerId;
+
+		/**
+		 * Calls `callback` every `period` until cancelled.
+		 */
+		auto every(std::chrono::milliseconds period, Callback callback)
+		    -> TimerId;
+
+		auto cancel(TimerId id) -> bool;
+
+		/**
+		 * Queues `callback` to be called on the loop thread and wakes the
+		 * loop up. Thread safe.
+		 */
+		auto post(Callback callback) -> void;
+
+		/**
+		 * Interrupts a blocking `run_once()`. Thread safe.
+		 */
+		auto wakeup() -> void;
+
+		/**
+		 * Waits for at most `timeout` (forever if negative) and dispatches
+		 * ready handlers, expired timers and posted callbacks.
+		 * Returns the number of dispatched handlers.
+		 */
+		auto run_once(
+		    std::chrono::milliseconds timeout = std::chrono::milliseconds {-1}
+		) -> size_t;
+
+		/**
+		 * Runs the loop until `stop()` is called.
+		 */
+		auto run() -> void;
+
+		/**
+		 * Makes `run()` return. Thread safe.
+		 */
+		auto stop() -> void;
+
+		auto wait_strategy(WaitStrategy strategy) -> Reactor&
+		{
+			m_strategy = strategy;
+			m_spin = strategy.spin;
+
+			return *this;
+		}
+
+		auto wait_stats() const -> const WaitStats&
+		{
+			return m_stats;
+		}
+
+		/**
+		 * Tells whether `fd` is registered.
+		 */
+		auto contains(int fd) const -> bool
+		{
+			return m_entries.contains(fd);
+		}
+
+		/**
+		 * Returns amount of registered descriptors.
+		 */
+		auto size() const -> size_t
+		{
+			return m_entries.size();
+		}
+
+		auto is_valid() const -> bool
+		{
+			return m_status != Status::GOOD;
+		}
+
+		auto status() const -> Status
+		{
+			return m_status;
+		}
+
+	private:
+		struct Entry
+		{
+			uint32_t generation;
+			Handler handler;
+		};
+
+		struct Timer
+		{
+			Clock::time_point deadline;
+			TimerId id;
+
+			auto operator>(const Timer& other) const -> bool
+			{
+				return deadline > other.deadline;
+			}
+		};
+
+		struct TimerCallback
+		{
+			Clock::duration period;
+			Callback callback;
+		};
+
+		auto schedule(Clock::duration delay, Clock::duration period, Callback)
+		    -> TimerId;
+		auto next_timeout(std::chrono::milliseconds) const -> int;
+		auto wait(int timeout) -> int;
+		auto poll(int timeout) -> int;
+		auto run_timers() -> size_t;
+		auto run_posted() -> size_t;
+
+		Status m_status {Status::GOOD};
+		int m_epoll_fd {-1};
+		int m_wakeup_fd {-1};
+		bool m_stopped {false};
+		uint32_t m_generation {0};
+
+		std::unordered_map<int, std::shared_ptr<Entry>> m_entries;
+		std::vector<epoll_event> m_events;
+
+		TimerId m_next_timer {1};
+		std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>>
+		    m_timers;
+		std::unordered_map<TimerId, TimerCallback> m_timer_callbacks;
+
+		std::mutex m_posted_mutex;
+		std::vector<Callback> m_posted;
+
+		WaitStrategy m_strategy;
+		WaitStats m_stats;
+		/* Current spin phase, below `m_strategy.spin` when adapting. */
+		std::chrono::microseconds m_spin {0};
+	};
+} // namespace sock
+
+#endif // SOCK_REACTOR_H_
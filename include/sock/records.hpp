@@ -0,0 +1,125 @@
+#ifndef SOCK_RECORDS_H_
+#define SOCK_RECORDS_H_
+
+#include "sock/utils.hpp"
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace sock
+{
+	/**
+	 * Instruction sets delimiters are searched with.
+	 */
+	enum class Isa
+	{
+		/* `memchr()`, vectorised by the C library if anything. */
+		PORTABLE,
+		SSE2,
+		AVX2,
+	};
+
+	/**
+	 * The widest one the CPU supports, checked once.
+	 */
+	auto best_isa() -> Isa;
+
+	constexpr std::string_view str_isa(Isa isa)
+	{
+		switch (isa)
+		{
+			case Isa::PORTABLE:
+				return "portable";
+			case Isa::SSE2:
+				return "sse2";
+			case Isa::AVX2:
+				return "avx2";
+		}
+
+		return "unknown";
+	}
+
+	/**
+	 * Position of the first `delimiter` in `bytes`, `npos` if there is
+	 * none. Compares 64 positions at a time against the first two bytes
+	 * of `delimiter`. An `isa` the CPU lacks is replaced by the best
+	 * one it has.
+	 */
+	auto find_delimiter(
+	    std::string_view bytes,
+	    std::string_view delimiter,
+	    Isa isa = best_isa()
+	) -> size_t;
+
+	/**
+	 * Splits received bytes into records ending in a delimiter, e.g.
+	 * `"\r\n"` terminated lines or NUL separated records, whatever the
+	 * reads they came in.
+	 *
+	 * Same contract as `sock::FrameDecoder`: records received whole are
+	 * views into the fed bytes, only a record split across reads is
+	 * gathered in an inner buffer, and so is a trailing partial record as
+	 * soon as `next()` runs out of records. Views stay valid until the
+	 * next `feed()`. A record above `max_record` bytes stops reading with
+	 * `Status::FRAME_ERROR`.
+	 */
+	class RecordReader
+	{
+	public:
+		explicit RecordReader(
+		    std::string delimiter = "\r\n",
+		    size_t max_record = 64 * 1024
+		) :
+		    m_delimiter {std::move(delimiter)},
+		    m_max_record {max_record}
+		{}
+
+		/**
+		 * Adds freshly received `bytes`. They must stay untouched until
+		 * `next()` returns nothing.
+		 */
+		auto feed(std::string_view bytes) -> RecordReader&;
+
+		/**
+		 * The next complete record, without its delimiter.
+		 */
+		auto next() -> std::optional<std::string_view>;
+
+		/**
+		 * Bytes of a partial record waiting for more.
+		 */
+		auto buffered() const -> size_t
+		{
+			return m_partial.size();
+		}
+
+		auto status() const -> Status
+		{
+			return m_status;
+		}
+
+		/**
+		 * Drops partial records and errors, e.g. for a new connection.
+		 */
+		auto reset() -> void;
+
+	private:
+		auto keep(std::string_view bytes) -> void;
+
+		std::string m_delimiter;
+		size_t m_max_record;
+		Status m_status {Status::GOOD};
+
+		std::string_view m_input;
+		size_t m_offset {0};
+
+		// A record being gathered across reads, and the last one gathered.
+		std::string m_partial;
+		std::string m_assembled;
+		bool m_assembled_ready {false};
+	};
+} // namespace sock
+
+#endif // SOCK_RECORDS_H_
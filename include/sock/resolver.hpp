@@ -0,0 +1,56 @@
+#ifndef SOCK_RESOLVER_H_
+#define SOCK_RESOLVER_H_
+
+#include "sock/endpoint.hpp"
+#include "sock/executor.hpp"
+#include "sock/reactor.hpp"
+#include "sock/task.hpp"
+#include "sock/utils.hpp"
+#include <cstddef>
+#include <string>
+
+namespace sock
+{
+	/**
+	 * Resolves addresses on a small thread pool, so a slow lookup does
+	 * not stall the reactor. Numeric hosts are parsed right away, without
+	 * a trip to the pool.
+	 *
+	 * Must be used on the reactor thread only, and destroyed before the
+	 * reactor is.
+	 */
+	class Resolver
+	{
+	public:
+		/**
+		 * Looks addresses up on `threads` threads, going through `cache`
+		 * when given one.
+		 */
+		explicit Resolver(
+		    Reactor&,
+		    size_t threads = 2,
+		    ResolverCache* cache = nullptr
+		);
+
+		Resolver(const Resolver&) = delete;
+		Resolver& operator=(const Resolver&) = delete;
+
+		/**
+		 * Resolves `address` for sockets created with `args`. The views
+		 * of `address` only need to outlive the call.
+		 */
+		auto resolve(CtorArgs args, sock::Address address) -> Task<Resolution>;
+
+	private:
+		struct Pending;
+
+		auto lookup(CtorArgs, std::string host, std::string port)
+		    -> Task<Resolution>;
+
+		Reactor& m_reactor;
+		ResolverCache* m_cache;
+		Executor m_pool;
+	};
+} // namespace sock
+
+#endif // SOCK_RESOLVER_H_
@@ -0,0 +1,239 @@
+#ifndef SOCK_RUNTIME_H_
+#define SOCK_RUNTIME_H_
+
+#include "sock/buffer.hpp"
+#include "sock/connection.hpp"
+#include "sock/listener_group.hpp"
+#include "sock/reactor.hpp"
+#include "sock/socket.hpp"
+#include "sock/utils.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace sock
+{
+	class Runtime;
+
+	/**
+	 * Recycles `sock::Buffer`s of a single thread.
+	 */
+	class BufferPool
+	{
+	public:
+		struct Release
+		{
+			BufferPool* pool;
+
+			auto operator()(Buffer* buffer) const -> void
+			{
+				pool->release(buffer);
+			}
+		};
+
+		using Handle = std::unique_ptr<Buffer, Release>;
+
+		auto acquire() -> Handle;
+
+		/**
+		 * Returns amount of buffers waiting for reuse.
+		 */
+		auto available() const -> size_t
+		{
+			return m_free.size();
+		}
+
+	private:
+		auto release(Buffer*) -> void;
+
+		std::vector<std::unique_ptr<Buffer>> m_free;
+	};
+
+	/**
+	 * Counters of one core. Written only by the owning thread, may be read
+	 * from any.
+	 */
+	struct CoreMetrics
+	{
+		/* Connections accepted from the core's listener. */
+		std::atomic<uint64_t> accepted {0};
+		/* Messages received from other cores. */
+		std::atomic<uint64_t> messages {0};
+		/* Handlers, timers and messages run by the core's reactor. */
+		std::atomic<uint64_t> dispatched {0};
+		/* Connections currently owned by the core. */
+		std::atomic<uint64_t> connections {0};
+		/* Bytes received and sent by the core's connections. */
+		std::atomic<uint64_t> load {0};
+		/* Connections that migrated away from the core. */
+		std::atomic<uint64_t> migrated {0};
+		/* Bytes waiting in output queues of the core's connections. */
+		std::atomic<uint64_t> queued {0};
+		/* Times a connection's output went above its high watermark. */
+		std::atomic<uint64_t> congestions {0};
+	};
+
+	/**
+	 * State owned by one event-loop thread of a `sock::Runtime`. Apart from
+	 * `send()` and `metrics()` it must only be touched from that thread.
+	 */
+	class Core
+	{
+	public:
+		using Message = std::function<void(Core&)>;
+
+		Core(Runtime&, size_t index);
+
+		auto index() const -> size_t
+		{
+			return m_index;
+		}
+
+		auto runtime() -> Runtime&
+		{
+			return m_runtime;
+		}
+
+		auto reactor() -> Reactor&
+		{
+			return m_reactor;
+		}
+
+		auto buffers() -> BufferPool&
+		{
+			return m_buffers;
+		}
+
+		auto metrics() -> CoreMetrics&
+		{
+			return m_metrics;
+		}
+
+		/**
+		 * Runs `message` on core `target`. Thread safe.
+		 */
+		auto send(size_t target, Message message) -> void;
+
+		/**
+		 * Takes ownership of `connection` and starts serving it.
+		 */
+		auto adopt(std::shared_ptr<Connection> connection) -> void;
+
+		/**
+		 * Moves `connection`, with its buffered input, output and handler,
+		 * to core `target`. The move happens once the current dispatch
+		 * round is over, so it is safe to call from the connection's own
+		 * handler.
+		 */
+		auto migrate(Connection& connection, size_t target) -> void;
+
+		/**
+		 * Migrates the busiest connection whose recent load does not exceed
+		 * `budget` bytes to core `target`, unless this core owns a single
+		 * connection. Restarts load sampling of every connection.
+		 */
+		auto shed(size_t target, uint64_t budget) -> void;
+
+		auto connections() const -> size_t
+		{
+			return m_connections.size();
+		}
+
+	private:
+		friend class Runtime;
+		friend class Connection;
+
+		auto drop(Connection&) -> void;
+
+		Runtime& m_runtime;
+		size_t m_index;
+		Reactor m_reactor;
+		BufferPool m_buffers;
+		CoreMetrics m_metrics;
+		std::unordered_map<int, std::shared_ptr<Connection>> m_connections;
+	};
+
+	struct RuntimeOptions
+	{
+		/* Amount of event-loop threads, 0 means one per available CPU. */
+		size_t cores {0};
+
+		/* Pin each thread to its own CPU. */
+		bool pin {true};
+	};
+
+	/**
+	 * Shared-nothing runtime: one pinned event-loop thread per core, each
+	 * with its own reactor, listener, buffers, timers and metrics. Cores
+	 * only communicate through `Core::send()`.
+	 */
+	class Runtime
+	{
+	public:
+		using Acceptor = std::function<void(Core&, sock::Socket&&)>;
+
+		explicit Runtime(RuntimeOptions = {});
+		~Runtime();
+
+		Runtime(const Runtime&) = delete;
+		Runtime& operator=(const Runtime&) = delete;
+
+		auto size() const -> size_t
+		{
+			return m_cores.size();
+		}
+
+		auto core(size_t index) -> Core&
+		{
+			return *m_cores[index];
+		}
+
+		/**
+		 * Gives every core its own `SO_REUSEPORT` listener on `address`,
+		 * steered so a connection is accepted by the core that received its
+		 * packets. Accepted sockets are non-blocking and handed to
+		 * `acceptor` on that core. Must be called before `start()`.
+		 */
+		auto listen(CtorArgs, sock::Address, Acceptor) -> Runtime&;
+
+		/**
+		 * Runs `message` on every core. Thread safe.
+		 */
+		auto broadcast(Core::Message message) -> void;
+
+		/**
+		 * Starts the event-loop threads.
+		 */
+		auto start() -> Runtime&;
+
+		/**
+		 * Stops every event loop and waits for the threads. Thread safe,
+		 * but must not be called from a core.
+		 */
+		auto stop() -> void;
+
+		auto status() const -> Status
+		{
+			return m_status;
+		}
+
+	private:
+		auto accept(Core&, sock::Socket& listener) -> void;
+
+		Status m_status {Status::GOOD};
+		std::atomic<bool> m_stopping {false};
+		RuntimeOptions m_options;
+		std::vector<int> m_cpus;
+		std::vector<std::unique_ptr<Core>> m_cores;
+		std::optional<ListenerGroup> m_listeners;
+		Acceptor m_acceptor;
+		std::vector<std::thread> m_threads;
+	};
+} // namespace sock
+
+#endif // SOCK_RUNTIME_H_
@@ -0,0 +1,117 @@
+#ifndef SOCK_SEND_QUEUE_H_
+#define SOCK_SEND_QUEUE_H_
+
+#include "sock/utils.hpp"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace sock
+{
+	/**
+	 * Outbound queue of one socket. Any thread may `push()` payloads
+	 * without locking and without touching the socket. The thread owning
+	 * the socket drains the queue with one `writev()`.
+	 *
+	 * Producers wake the owner through an eventfd, `notifier()`, which the
+	 * owner registers for `Events::READABLE`. It is written once per
+	 * batch: only the first push after the owner has drained signals it.
+	 */
+	class SendQueue
+	{
+	public:
+		SendQueue();
+		~SendQueue();
+
+		SendQueue(const SendQueue&) = delete;
+		SendQueue& operator=(const SendQueue&) = delete;
+
+		/**
+		 * Queues `payload`. Thread safe, lock free.
+		 */
+		auto push(std::string payload) -> void;
+
+		/**
+		 * Owner only. Sends `payload` after everything queued so far,
+		 * directly if nothing is queued.
+		 * Returns amount of bytes written or -1 on socket error.
+		 */
+		auto write(int fd, std::string_view payload) -> int64_t;
+
+		/**
+		 * Owner only. Sends `payloads` one after another with a single
+		 * `writev()`, copying only what the socket does not take.
+		 */
+		auto write(int fd, std::span<const std::string_view> payloads)
+		    -> int64_t;
+
+		/**
+		 * Owner only. Writes out as much of the queue as the socket takes.
+		 * What is left waits for `fd` to become writable.
+		 * Returns amount of bytes written or -1 on socket error.
+		 */
+		auto flush(int fd) -> int64_t;
+
+		/**
+		 * Owner only. Tells whether there are payloads not yet written.
+		 */
+		auto pending() -> bool;
+
+		/**
+		 * Owner only. Amount of collected bytes waiting for the socket.
+		 */
+		auto pending_bytes() const -> size_t
+		{
+			return m_ready_bytes;
+		}
+
+		auto notifier() const -> int
+		{
+			return m_notifier;
+		}
+
+		/**
+		 * Amount of times producers signalled `notifier()`.
+		 */
+		auto wakeups() const -> uint64_t
+		{
+			return m_wakeups.load(std::memory_order_relaxed);
+		}
+
+		auto status() const -> Status
+		{
+			return m_status;
+		}
+
+	private:
+		struct Node
+		{
+			std::atomic<Node*> next {nullptr};
+			std::string payload;
+		};
+
+		auto enqueue(Node*) -> void;
+		auto dequeue() -> Node*;
+		auto collect(bool drain = false) -> void;
+
+		Status m_status {Status::GOOD};
+		int m_notifier {-1};
+
+		// Producers' end of Vyukov's intrusive MPSC queue.
+		alignas(64) std::atomic<Node*> m_head;
+		alignas(64) std::atomic<bool> m_signalled {false};
+		std::atomic<uint64_t> m_wakeups {0};
+
+		// Owner's end.
+		alignas(64) Node* m_tail;
+		Node m_stub;
+		std::deque<std::string> m_ready;
+		size_t m_ready_offset {0};
+		size_t m_ready_bytes {0};
+	};
+} // namespace sock
+
+#endif // SOCK_SEND_QUEUE_H_
@@ -0,0 +1,145 @@
+#ifndef SOCK_SHM_SOCKET_H_
+#define SOCK_SHM_SOCKET_H_
+
+#include "sock/buffer.hpp"
+#include "sock/socket.hpp"
+#include "sock/utils.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace sock
+{
+	/**
+	 * Byte stream between co-located processes over shared memory: a
+	 * lock-free single-producer single-consumer ring per direction in a
+	 * `memfd` mapped by both peers. Sending and receiving are plain
+	 * memory copies; a futex syscall is only made when a peer sleeps on
+	 * an empty, or full, ring.
+	 *
+	 * Connections are set up over a `Domain::LOCAL` socket at
+	 * `Address::host`, which then only serves to notice a peer that went
+	 * away. Satisfies `sock::internal::is_socket`, each end must be used
+	 * by one thread at a time.
+	 */
+	class ShmSocket
+	{
+	public:
+		static constexpr size_t DEFAULT_CAPACITY = 1 << 20;
+
+		/**
+		 * `capacity` of each direction's ring, rounded up to a power of
+		 * two, is picked by the connecting side. The domain, type and
+		 * protocol of `args` are ignored.
+		 */
+		ShmSocket(CtorArgs args, size_t capacity = DEFAULT_CAPACITY);
+
+		ShmSocket(const ShmSocket&) = delete;
+		ShmSocket& operator=(const ShmSocket&) = delete;
+
+		ShmSocket(ShmSocket&&);
+		ShmSocket& operator=(ShmSocket&&);
+
+		~ShmSocket();
+
+		/**
+		 * `Option::RCVTIMEO` and `Option::SNDTIMEO` limit how long
+		 * `receive()` and `send()` wait for the peer.
+		 */
+		auto option(sock::Option, std::chrono::milliseconds) -> ShmSocket&;
+
+		/**
+		 * Applies to the underlying local socket.
+		 */
+		auto option(sock::Option, int) -> ShmSocket&;
+
+		auto bind(sock::Address) -> ShmSocket&;
+		auto listen(size_t backlog) -> ShmSocket&;
+		auto connect(sock::Address) -> ShmSocket&;
+		auto accept() -> ShmSocket;
+
+		/**
+		 * Receives what is available, waiting until something is. A zero
+		 * `received_size()` means the peer closed its end. Pass
+		 * `MSG_DONTWAIT` not to wait.
+		 */
+		auto receive(sock::Buffer&, int flags = 0) -> void;
+
+		/**
+		 * Sends whole `payload`, waiting for room as needed.
+		 */
+		auto send(std::string_view payload) -> ShmSocket&;
+
+		/**
+		 * Closes both directions, waking a waiting peer.
+		 */
+		auto shutdown() -> void;
+
+		auto is_valid() const -> bool
+		{
+			return m_status != Status::GOOD;
+		}
+
+		auto status() const -> Status
+		{
+			return m_status;
+		}
+
+		/**
+		 * The local socket used for the setup.
+		 */
+		auto native_handle() const -> int
+		{
+			return m_control.native_handle();
+		}
+
+	private:
+		struct Ring
+		{
+			// Consumer's and producer's positions, on their own lines.
+			alignas(64) std::atomic<uint64_t> head {0};
+			alignas(64) std::atomic<uint64_t> tail {0};
+
+			// Futex words, bumped to wake a sleeping side.
+			alignas(64) std::atomic<uint32_t> readable {0};
+			std::atomic<uint32_t> reader_sleeping {0};
+			alignas(64) std::atomic<uint32_t> writable {0};
+			std::atomic<uint32_t> writer_sleeping {0};
+
+			std::atomic<uint32_t> closed {0};
+		};
+
+		struct Region;
+
+		ShmSocket() = default;
+
+		auto map(int memfd, bool initialize) -> bool;
+		auto unmap() -> void;
+		auto peer_gone() const -> bool;
+		auto wait(
+		    std::atomic<uint32_t>& word,
+		    std::atomic<uint32_t>& sleeping,
+		    const std::atomic<uint64_t>& position,
+		    uint64_t seen,
+		    Ring& ring,
+		    std::chrono::milliseconds timeout
+		) -> bool;
+
+		Status m_status {Status::GOOD};
+		sock::Socket m_control;
+		size_t m_capacity {DEFAULT_CAPACITY};
+		std::chrono::milliseconds m_receive_timeout {0};
+		std::chrono::milliseconds m_send_timeout {0};
+
+		Region* m_region {nullptr};
+		size_t m_region_size {0};
+		Ring* m_tx {nullptr};
+		Ring* m_rx {nullptr};
+		char* m_tx_data {nullptr};
+		char* m_rx_data {nullptr};
+	};
+} // namespace sock
+
+#endif // SOCK_SHM_SOCKET_H_
@@ -80,6 +80,17 @@ namespace sock
 			return sock::internal::Socket(std::move(args));
 		}
 
+#if !(defined(WIN32) || defined(_WIN32) || \
+    defined(__WIN32) && !defined(__CYGWIN__))
+		/**
+		 * Creates two connected `Domain::LOCAL` sockets of `args.type`.
+		 */
+		auto pair(const CtorArgs args) const -> std::pair<Socket, Socket>
+		{
+			return sock::internal::Socket::pair(std::move(args));
+		}
+#endif
+
 	private:
 		SocketFactory();
 		SocketFactory(const SocketFactory&);
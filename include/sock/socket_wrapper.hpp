@@ -1,6 +1,7 @@
 #ifndef SOCK_INTERNAL_SOCKET_WRAPPER_H_
 #define SOCK_INTERNAL_SOCKET_WRAPPER_H_
 
+#include "sock/endpoint.hpp"
 #include "sock/socket.hpp"
 #include "sock/utils.hpp"
 #include <chrono>
@@ -101,6 +102,17 @@ namespace sock
 			return *this;
 		}
 
+		auto bind(const sock::Endpoint& endpoint) -> SocketWrapper&
+		{
+			m_sock.bind(endpoint);
+			if (m_callback)
+			{
+				m_callback(m_sock);
+			}
+
+			return *this;
+		}
+
 		auto listen(size_t max_connections) -> SocketWrapper&
 		{
 			m_sock.listen(max_connections);
@@ -123,6 +135,17 @@ namespace sock
 			return *this;
 		}
 
+		auto connect(const sock::Endpoint& endpoint) -> SocketWrapper&
+		{
+			m_sock.connect(endpoint);
+			if (m_callback)
+			{
+				m_callback(m_sock);
+			}
+
+			return *this;
+		}
+
 		auto accept() -> SocketWrapper
 		{
 			SocketWrapper result {m_sock.accept(), m_callback};
@@ -163,6 +186,17 @@ namespace sock
 			}
 		}
 
+		auto non_blocking(bool enable) -> SocketWrapper&
+		{
+			m_sock.non_blocking(enable);
+			if (m_callback)
+			{
+				m_callback(m_sock);
+			}
+
+			return *this;
+		}
+
 		auto callback(std::function<void(sock::Socket&)> callback)
 		    -> SocketWrapper&
 		{
@@ -181,6 +215,20 @@ namespace sock
 			return m_sock.status();
 		}
 
+		auto native_handle() const
+		{
+			return m_sock.native_handle();
+		}
+
+		/**
+		 * Returns wrapped socket. Calls made through the returned reference
+		 * do not trigger the callback.
+		 */
+		auto socket() -> sock::Socket&
+		{
+			return m_sock;
+		}
+
 	private:
 		sock::internal::Socket m_sock;
 		std::function<void(sock::Socket&)> m_callback {nullptr};
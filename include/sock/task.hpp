@@ -0,0 +1,324 @@
+#ifndef SOCK_TASK_H_
+#define SOCK_TASK_H_
+
+#include "sock/internal/frame_pool.hpp"
+#include "sock/reactor.hpp"
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace sock
+{
+	template<class T>
+	class Task;
+
+	namespace internal
+	{
+		struct PooledFrame
+		{
+			static auto operator new(size_t size) -> void*
+			{
+				return FramePool::allocate(size);
+			}
+
+			static auto operator delete(void* ptr, size_t size) -> void
+			{
+				FramePool::deallocate(ptr, size);
+			}
+		};
+
+		struct TaskPromiseBase : PooledFrame
+		{
+			struct FinalAwaiter
+			{
+				auto await_ready() noexcept -> bool
+				{
+					return false;
+				}
+
+				template<class P>
+				auto await_suspend(std::coroutine_handle<P> handle) noexcept
+				    -> std::coroutine_handle<>
+				{
+					auto continuation = handle.promise().continuation;
+
+					return continuation ? continuation
+					                    : std::noop_coroutine();
+				}
+
+				auto await_resume() noexcept -> void
+				{}
+			};
+
+			auto initial_suspend() noexcept -> std::suspend_always
+			{
+				return {};
+			}
+
+			auto final_suspend() noexcept -> FinalAwaiter
+			{
+				return {};
+			}
+
+			auto unhandled_exception() -> void
+			{
+				exception = std::current_exception();
+			}
+
+			std::coroutine_handle<> continuation {nullptr};
+			std::exception_ptr exception {nullptr};
+		};
+
+		template<class T>
+		struct TaskPromise : TaskPromiseBase
+		{
+			auto get_return_object() -> Task<T>;
+
+			auto return_value(T v) -> void
+			{
+				value.emplace(std::move(v));
+			}
+
+			auto result() -> T
+			{
+				if (exception)
+				{
+					std::rethrow_exception(exception);
+				}
+
+				return std::move(*value);
+			}
+
+			std::optional<T> value;
+		};
+
+		template<>
+		struct TaskPromise<void> : TaskPromiseBase
+		{
+			auto get_return_object() -> Task<void>;
+
+			auto return_void() -> void
+			{}
+
+			auto result() -> void
+			{
+				if (exception)
+				{
+					std::rethrow_exception(exception);
+				}
+			}
+		};
+
+		/**
+		 * Fire-and-forget coroutine that frees itself when done.
+		 */
+		struct Detached
+		{
+			struct promise_type : PooledFrame
+			{
+				auto get_return_object() -> Detached
+				{
+					return {};
+				}
+
+				auto initial_suspend() noexcept -> std::suspend_never
+				{
+					return {};
+				}
+
+				auto final_suspend() noexcept -> std::suspend_never
+				{
+					return {};
+				}
+
+				auto return_void() -> void
+				{}
+
+				auto unhandled_exception() -> void
+				{
+					std::terminate();
+				}
+			};
+		};
+	} // namespace internal
+
+	/**
+	 * Lazily started coroutine producing a `T`. Runs when awaited and
+	 * resumes the awaiting coroutine once it completes.
+	 * Frames are allocated from `sock::internal::FramePool`.
+	 */
+	template<class T = void>
+	class Task
+	{
+	public:
+		using promise_type = internal::TaskPromise<T>;
+		using handle_type = std::coroutine_handle<promise_type>;
+
+		Task(handle_type handle) : m_handle {handle} {};
+
+		Task(const Task&) = delete;
+		Task& operator=(const Task&) = delete;
+
+		Task(Task&& other) : m_handle {std::exchange(other.m_handle, nullptr)}
+		{}
+
+		Task& operator=(Task&& other)
+		{
+			if (this != &other)
+			{
+				if (m_handle)
+				{
+					m_handle.destroy();
+				}
+
+				m_handle = std::exchange(other.m_handle, nullptr);
+			}
+
+			return *this;
+		}
+
+		~Task()
+		{
+			if (m_handle)
+			{
+				m_handle.destroy();
+			}
+		}
+
+		auto done() const -> bool
+		{
+			return !m_handle || m_handle.done();
+		}
+
+		auto operator co_await() && noexcept
+		{
+			struct Awaiter
+			{
+				handle_type handle;
+
+				auto await_ready() noexcept -> bool
+				{
+					return !handle || handle.done();
+				}
+
+				auto await_suspend(std::coroutine_handle<> awaiting) noexcept
+				    -> std::coroutine_handle<>
+				{
+					handle.promise().continuation = awaiting;
+
+					return handle;
+				}
+
+				auto await_resume() -> T
+				{
+					return handle.promise().result();
+				}
+			};
+
+			return Awaiter {m_handle};
+		}
+
+	private:
+		handle_type m_handle;
+	};
+
+	template<class T>
+	auto internal::TaskPromise<T>::get_return_object() -> Task<T>
+	{
+		return Task<T> {
+		    std::coroutine_handle<TaskPromise<T>>::from_promise(*this)};
+	}
+
+	inline auto internal::TaskPromise<void>::get_return_object() -> Task<void>
+	{
+		return Task<void> {
+		    std::coroutine_handle<TaskPromise<void>>::from_promise(*this)};
+	}
+
+	/**
+	 * Starts `task` without waiting for it. The task runs until its first
+	 * suspension point before `spawn()` returns.
+	 */
+	inline auto spawn(Task<void> task) -> void
+	{
+		[](Task<void> t) -> internal::Detached
+		{
+			co_await std::move(t);
+		}(std::move(task));
+	}
+
+	/**
+	 * Runs `reactor` until `task` completes and returns its result.
+	 */
+	template<class T>
+	auto block_on(Reactor& reactor, Task<T> task) -> T
+	{
+		std::optional<T> result;
+		bool done = false;
+
+		[](Task<T> t, std::optional<T>& out, bool& flag) -> internal::Detached
+		{
+			out.emplace(co_await std::move(t));
+			flag = true;
+		}(std::move(task), result, done);
+
+		while (!done)
+		{
+			reactor.run_once();
+		}
+
+		return std::move(*result);
+	}
+
+	inline auto block_on(Reactor& reactor, Task<void> task) -> void
+	{
+		bool done = false;
+
+		[](Task<void> t, bool& flag) -> internal::Detached
+		{
+			co_await std::move(t);
+			flag = true;
+		}(std::move(task), done);
+
+		while (!done)
+		{
+			reactor.run_once();
+		}
+	}
+
+	/**
+	 * Suspends the awaiting coroutine for `delay`.
+	 */
+	inline auto sleep_for(Reactor& reactor, std::chrono::milliseconds delay)
+	{
+		struct Awaiter
+		{
+			Reactor& reactor;
+			std::chrono::milliseconds delay;
+
+			auto await_ready() const noexcept -> bool
+			{
+				return delay.count() <= 0;
+			}
+
+			auto await_suspend(std::coroutine_handle<> handle) -> void
+			{
+				reactor.after(
+				    delay,
+				    [handle]()
+				    {
+					    handle.resume();
+				    }
+				);
+			}
+
+			auto await_resume() const noexcept -> void
+			{}
+		};
+
+		return Awaiter {reactor, delay};
+	}
+} // namespace sock
+
+#endif // SOCK_TASK_H_
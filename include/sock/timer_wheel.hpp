@@ -0,0 +1,159 @@
+#ifndef SOCK_TIMER_WHEEL_H_
+#define SOCK_TIMER_WHEEL_H_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace sock
+{
+	class TimerWheel;
+
+	/**
+	 * A deadline scheduled on a `sock::TimerWheel`. Meant to be embedded
+	 * into per-socket state, e.g. one for idle, one for read and one for
+	 * write deadlines: arming, re-arming and cancelling neither allocate
+	 * nor make a syscall. Cancels itself when destroyed.
+	 */
+	class WheelTimer
+	{
+	public:
+		using Callback = std::function<void()>;
+
+		WheelTimer() = default;
+		explicit WheelTimer(Callback callback) :
+		    m_callback {std::move(callback)}
+		{}
+
+		WheelTimer(const WheelTimer&) = delete;
+		WheelTimer& operator=(const WheelTimer&) = delete;
+
+		~WheelTimer();
+
+		auto callback(Callback callback) -> WheelTimer&
+		{
+			m_callback = std::move(callback);
+
+			return *this;
+		}
+
+		auto armed() const -> bool
+		{
+			return m_next != nullptr;
+		}
+
+	private:
+		friend class TimerWheel;
+
+		auto unlink() -> void
+		{
+			if (m_next != nullptr)
+			{
+				m_prev->m_next = m_next;
+				m_next->m_prev = m_prev;
+				m_prev = nullptr;
+				m_next = nullptr;
+			}
+		}
+
+		// Slots are circular lists with a sentinel, so unlinking needs
+		// neither the wheel nor the slot.
+		WheelTimer* m_prev {nullptr};
+		WheelTimer* m_next {nullptr};
+		TimerWheel* m_wheel {nullptr};
+		uint64_t m_expiry {0};
+		Callback m_callback;
+	};
+
+	/**
+	 * Hierarchical timing wheel (Varghese & Lauck) for large amounts of
+	 * socket deadlines. Scheduling and cancelling are O(1); timers far in
+	 * the future sit in coarse outer wheels and cascade inwards as time
+	 * advances.
+	 *
+	 * Not thread safe. Drive it from the thread owning the timers, e.g.
+	 * `reactor.every(wheel.tick(), [&wheel] { wheel.advance(); })`.
+	 */
+	class TimerWheel
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		explicit TimerWheel(
+		    std::chrono::milliseconds tick = std::chrono::milliseconds {1}
+		);
+
+		TimerWheel(const TimerWheel&) = delete;
+		TimerWheel& operator=(const TimerWheel&) = delete;
+
+		/**
+		 * Disarms every timer still scheduled.
+		 */
+		~TimerWheel();
+
+		/**
+		 * Arms `timer` to fire `delay` from now, re-arming it if it already
+		 * is. Delays beyond the wheel's range (about 18 hours at 1 ms
+		 * ticks) are clamped.
+		 */
+		auto schedule(WheelTimer& timer, std::chrono::milliseconds delay)
+		    -> void;
+
+		auto cancel(WheelTimer& timer) -> void
+		{
+			if (timer.armed())
+			{
+				timer.unlink();
+				m_size--;
+			}
+		}
+
+		/**
+		 * Fires every timer that expired by `now`. Returns the amount
+		 * fired.
+		 */
+		auto advance(Clock::time_point now = Clock::now()) -> size_t;
+
+		auto tick() const -> std::chrono::milliseconds
+		{
+			return m_tick;
+		}
+
+		/**
+		 * Amount of armed timers.
+		 */
+		auto size() const -> size_t
+		{
+			return m_size;
+		}
+
+	private:
+		static constexpr size_t INNER_BITS = 8;
+		static constexpr size_t OUTER_BITS = 6;
+		static constexpr size_t OUTER_LEVELS = 3;
+		static constexpr size_t INNER_SLOTS = 1 << INNER_BITS;
+		static constexpr size_t OUTER_SLOTS = 1 << OUTER_BITS;
+		static constexpr uint64_t RANGE =
+		    uint64_t {1} << (INNER_BITS + OUTER_BITS * OUTER_LEVELS);
+
+		using Slot = WheelTimer;
+
+		auto ticks(Clock::time_point) const -> uint64_t;
+		auto place(WheelTimer&) -> void;
+		auto cascade(size_t level) -> size_t;
+
+		static auto append(Slot& slot, WheelTimer& timer) -> void;
+
+		std::chrono::milliseconds m_tick;
+		Clock::time_point m_start;
+		uint64_t m_current {0};
+		size_t m_size {0};
+
+		std::array<Slot, INNER_SLOTS> m_inner;
+		std::array<std::array<Slot, OUTER_SLOTS>, OUTER_LEVELS> m_outer;
+	};
+} // namespace sock
+
+#endif // SOCK_TIMER_WHEEL_H_
@@ -23,17 +23,32 @@ namespace sock
 	enum class Domain
 	{
 		INET,
+		/* A dual-stack IPv6 socket where available, which also reaches
+		 * IPv4 peers through v4-mapped addresses. Plain IPv4 otherwise. */
 		UNSPEC,
+		/* Same-host `AF_UNIX` sockets. `Address::host` is a filesystem
+		 * path, or a name in the abstract namespace when it starts with
+		 * '@'. `Address::port` is ignored. */
+		LOCAL,
+		INET6,
 	};
 
 	enum class Type
 	{
 		STREAM,
+		/* Connection-oriented, keeps message boundaries. */
+		SEQPACKET,
 	};
 
 	enum class Protocol
 	{
 		TCP,
+		/* Whatever the domain and type imply, e.g. for `Domain::LOCAL`. */
+		DEFAULT,
+		/* Multipath TCP: one connection over several paths, see
+		 * `sock::mptcp_status()`. Plain TCP where the kernel has no
+		 * MPTCP, or on Windows. */
+		MPTCP,
 	};
 
 	enum class Status
@@ -49,6 +64,12 @@ namespace sock
 		CONNECT_ERROR = 8,
 		OPTION_SET_ERROR = 9,
 		RECEIVE_ERROR = 10,
+		REACTOR_ERROR = 11,
+		IO_ENGINE_ERROR = 12,
+		TIMED_OUT = 13,
+		CANCELLED = 14,
+		/* Malformed or oversized frame, see `sock::FrameDecoder`. */
+		FRAME_ERROR = 15,
 	};
 
 	enum Flags
@@ -101,7 +122,10 @@ namespace sock
 		/* Send timeout */
 		SNDTIMEO,
 		/* Socket type.*/
-		TYPE
+		TYPE,
+		/* Several sockets may bind the same address, incoming connections
+		 * are spread between them. */
+		REUSEPORT,
 	};
 
 	struct CtorArgs
@@ -144,6 +168,16 @@ namespace sock
 				return "OPTION_SET_ERROR";
 			case Status::RECEIVE_ERROR:
 				return "RECEIVE_ERROR";
+			case Status::REACTOR_ERROR:
+				return "REACTOR_ERROR";
+			case Status::IO_ENGINE_ERROR:
+				return "IO_ENGINE_ERROR";
+			case Status::TIMED_OUT:
+				return "TIMED_OUT";
+			case Status::CANCELLED:
+				return "CANCELLED";
+			case Status::FRAME_ERROR:
+				return "FRAME_ERROR";
 		}
 
 		return "UNKNOWN STATUS";
@@ -0,0 +1,381 @@
+#include "sock/async_socket.hpp"
+#include <cerrno>
+#include <memory>
+#include <netdb.h>
+#include <string>
+#include <sys/socket.h>
+
+sock::AsyncSocket::AsyncSocket(Reactor& reactor, sock::Socket&& socket) :
+    AsyncSocket(reactor, std::move(socket), sock::Status::GOOD)
+{}
+
+sock::AsyncSocket::AsyncSocket(Reactor& reactor, CtorArgs args) :
+    AsyncSocket(reactor, sock::Socket {std::move(args)}, sock::Status::GOOD)
+{}
+
+sock::AsyncSocket::AsyncSocket(
+    Reactor& reactor,
+    sock::Socket&& socket,
+    Status status
+) :
+    m_status {status},
+    m_sock {std::move(socket)},
+    m_state {std::make_unique<State>(State {.reactor = &reactor})}
+{
+	attach();
+}
+
+sock::AsyncSocket& sock::AsyncSocket::operator=(AsyncSocket&& other)
+{
+	if (this != &other)
+	{
+		detach();
+
+		m_status = other.m_status;
+		m_sock = std::move(other.m_sock);
+		m_state = std::move(other.m_state);
+	}
+
+	return *this;
+}
+
+sock::AsyncSocket::~AsyncSocket()
+{
+	detach();
+}
+
+void sock::AsyncSocket::detach()
+{
+	if (!m_state)
+	{
+		return;
+	}
+
+	for (auto waiter : {&m_state->reader, &m_state->writer})
+	{
+		if (waiter->timer != 0)
+		{
+			m_state->reactor->cancel(waiter->timer);
+		}
+	}
+
+	if (m_sock.native_handle() >= 0)
+	{
+		m_state->reactor->remove(m_sock.native_handle());
+	}
+
+	m_state.reset();
+}
+
+void sock::AsyncSocket::attach()
+{
+	if (m_sock.native_handle() < 0)
+	{
+		return;
+	}
+
+	m_sock.non_blocking(true);
+
+	// Registered once, edge-triggered for both directions: operations
+	// then cost no epoll_ctl calls, only the syscall itself.
+	m_state->reactor->add(
+	    m_sock.native_handle(),
+	    sock::Events::READABLE | sock::Events::WRITABLE
+	        | sock::Events::PEER_CLOSED | sock::Events::EDGE_TRIGGERED,
+	    [state = m_state.get()](uint32_t events)
+	    {
+		    constexpr uint32_t broken =
+		        sock::Events::HANGUP | sock::Events::FAILURE;
+		    std::coroutine_handle<> reader {nullptr};
+		    std::coroutine_handle<> writer {nullptr};
+
+		    if (events
+		        & (sock::Events::READABLE | sock::Events::PEER_CLOSED | broken))
+		    {
+			    reader = state->release(state->reader, sock::Status::GOOD);
+		    }
+
+		    if (events & (sock::Events::WRITABLE | broken))
+		    {
+			    writer = state->release(state->writer, sock::Status::GOOD);
+		    }
+
+		    // `state` may be gone once a coroutine has been resumed.
+		    if (reader)
+		    {
+			    reader.resume();
+		    }
+
+		    if (writer)
+		    {
+			    writer.resume();
+		    }
+	    }
+	);
+}
+
+std::coroutine_handle<>
+    sock::AsyncSocket::State::release(Waiter& waiter, Status status)
+{
+	auto handle = std::exchange(waiter.handle, nullptr);
+
+	if (handle)
+	{
+		if (waiter.timer != 0)
+		{
+			reactor->cancel(waiter.timer);
+			waiter.timer = 0;
+		}
+
+		waiter.result = status;
+	}
+
+	return handle;
+}
+
+void sock::AsyncSocket::Wait::await_suspend(std::coroutine_handle<> handle)
+{
+	waiter.handle = handle;
+	waiter.result = sock::Status::GOOD;
+
+	if (state.timeout.count() > 0)
+	{
+		waiter.timer = state.reactor->after(
+		    state.timeout,
+		    [state = &state, waiter = &waiter]()
+		    {
+			    waiter->timer = 0;
+
+			    if (auto h = state->release(*waiter, sock::Status::TIMED_OUT))
+			    {
+				    h.resume();
+			    }
+		    }
+		);
+	}
+}
+
+sock::AsyncSocket& sock::AsyncSocket::timeout(std::chrono::milliseconds t)
+{
+	m_state->timeout = t;
+
+	return *this;
+}
+
+void sock::AsyncSocket::cancel()
+{
+	auto reader = m_state->release(m_state->reader, sock::Status::CANCELLED);
+	auto writer = m_state->release(m_state->writer, sock::Status::CANCELLED);
+
+	if (reader)
+	{
+		reader.resume();
+	}
+
+	if (writer)
+	{
+		writer.resume();
+	}
+}
+
+sock::Task<sock::AsyncSocket> sock::AsyncSocket::async_accept()
+{
+	while (true)
+	{
+		const auto fd = accept4(
+		    m_sock.native_handle(),
+		    nullptr,
+		    nullptr,
+		    SOCK_NONBLOCK | SOCK_CLOEXEC
+		);
+
+		if (fd >= 0)
+		{
+			co_return AsyncSocket {*m_state->reactor, sock::Socket {fd}};
+		}
+
+		if (errno != EAGAIN)
+		{
+			co_return AsyncSocket {
+			    *m_state->reactor,
+			    sock::Socket {-1},
+			    sock::Status::ACCEPT_FAILED};
+		}
+
+		const auto status = co_await Wait {*m_state, m_state->reader};
+
+		if (status != sock::Status::GOOD)
+		{
+			co_return AsyncSocket {*m_state->reactor, sock::Socket {-1}, status};
+		}
+	}
+}
+
+void sock::AsyncSocket::reopen(int family, int type, int protocol)
+{
+	m_state->reactor->remove(m_sock.native_handle());
+	m_sock = sock::Socket {
+	    ::socket(family, type | SOCK_NONBLOCK | SOCK_CLOEXEC, protocol)};
+	m_status = m_sock.native_handle() < 0 ? sock::Status::SOCKET_CREATE_ERROR
+	                                      : sock::Status::GOOD;
+	attach();
+}
+
+sock::Task<sock::Status> sock::AsyncSocket::async_connect(sock::Address address)
+{
+	addrinfo hints {};
+	socklen_t size = sizeof(int);
+
+	{
+		const auto fd = m_sock.native_handle();
+		getsockopt(fd, SOL_SOCKET, SO_DOMAIN, &hints.ai_family, &size);
+		getsockopt(fd, SOL_SOCKET, SO_TYPE, &hints.ai_socktype, &size);
+		getsockopt(fd, SOL_SOCKET, SO_PROTOCOL, &hints.ai_protocol, &size);
+	}
+
+	const auto family = hints.ai_family;
+	int v6_only = 1;
+
+	// Dual-stack sockets reach IPv4 peers too, see `Domain::UNSPEC`.
+	if (family == AF_INET6)
+	{
+		getsockopt(m_sock.native_handle(), IPPROTO_IPV6, IPV6_V6ONLY, &v6_only, &size);
+		hints.ai_family = v6_only ? AF_INET6 : AF_UNSPEC;
+	}
+
+	const auto resolution = internal::resolve(hints, address);
+
+	if (resolution.status != sock::Status::GOOD)
+	{
+		co_return hints.ai_family == AF_UNIX ? sock::Status::CONNECT_ERROR
+		                                     : resolution.status;
+	}
+
+	auto status = sock::Status::CONNECT_ERROR;
+
+	for (size_t i = 0; i < resolution.endpoints.size(); i++)
+	{
+		// A socket whose connect failed or was abandoned cannot be
+		// reused, later attempts get a fresh one.
+		if (i > 0)
+		{
+			reopen(family, hints.ai_socktype, hints.ai_protocol);
+
+			if (m_status != sock::Status::GOOD)
+			{
+				co_return m_status;
+			}
+
+			if (family == AF_INET6)
+			{
+				setsockopt(m_sock.native_handle(), IPPROTO_IPV6, IPV6_V6ONLY, &v6_only, size);
+			}
+		}
+
+		status = co_await async_connect(resolution.endpoints[i]);
+
+		if (status == sock::Status::GOOD || status == sock::Status::CANCELLED)
+		{
+			co_return status;
+		}
+	}
+
+	co_return status;
+}
+
+sock::Task<sock::Status> sock::AsyncSocket::async_connect(sock::Endpoint endpoint)
+{
+	const auto fd = m_sock.native_handle();
+	int family = AF_UNSPEC;
+	socklen_t size = sizeof(family);
+	getsockopt(fd, SOL_SOCKET, SO_DOMAIN, &family, &size);
+
+	const auto target = endpoint.for_family(family);
+
+	if (::connect(fd, target.data(), target.size()) == 0)
+	{
+		co_return sock::Status::GOOD;
+	}
+
+	// Local connects complete or fail right away.
+	if (errno != EINPROGRESS)
+	{
+		co_return sock::Status::CONNECT_ERROR;
+	}
+
+	const auto status = co_await Wait {*m_state, m_state->writer};
+
+	if (status != sock::Status::GOOD)
+	{
+		co_return status;
+	}
+
+	int error = 0;
+	size = sizeof(error);
+	getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &size);
+
+	co_return error == 0 ? sock::Status::GOOD : sock::Status::CONNECT_ERROR;
+}
+
+sock::Task<sock::Status> sock::AsyncSocket::async_receive(sock::Buffer& buff)
+{
+	while (true)
+	{
+		const auto n =
+		    recv(m_sock.native_handle(), buff.buffer(), buff.max_size() - 1, 0);
+
+		if (n >= 0)
+		{
+			buff.buffer()[n] = '\0';
+			buff.received_size(n);
+			co_return sock::Status::GOOD;
+		}
+
+		buff.received_size(0);
+
+		if (errno != EAGAIN)
+		{
+			co_return sock::Status::RECEIVE_ERROR;
+		}
+
+		const auto status = co_await Wait {*m_state, m_state->reader};
+
+		if (status != sock::Status::GOOD)
+		{
+			co_return status;
+		}
+	}
+}
+
+sock::Task<sock::Status> sock::AsyncSocket::async_send(std::string_view payload)
+{
+	while (!payload.empty())
+	{
+		const auto n = ::send(
+		    m_sock.native_handle(),
+		    payload.data(),
+		    payload.size(),
+		    MSG_NOSIGNAL
+		);
+
+		if (n >= 0)
+		{
+			payload.remove_prefix(n);
+			continue;
+		}
+
+		if (errno != EAGAIN)
+		{
+			co_return sock::Status::SEND_ERROR;
+		}
+
+		const auto status = co_await Wait {*m_state, m_state->writer};
+
+		if (status != sock::Status::GOOD)
+		{
+			co_return status;
+		}
+	}
+
+	co_return sock::Status::GOOD;
+}
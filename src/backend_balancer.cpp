@@ -0,0 +1,193 @@
+#include "sock/backend_balancer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+
+/**
+ * 64-bit FNV-1a, finished with splitmix64's mixer so that similar keys
+ * land far apart. Unlike `std::hash`, the same on every platform.
+ */
+static auto hash(std::string_view bytes) -> uint64_t
+{
+	uint64_t h = 0xcbf29ce484222325;
+
+	for (const auto c : bytes)
+	{
+		h = (h ^ static_cast<uint8_t>(c)) * 0x100000001b3;
+	}
+
+	h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9;
+	h = (h ^ (h >> 27)) * 0x94d049bb133111eb;
+
+	return h ^ (h >> 31);
+}
+
+static auto random_below(size_t bound) -> size_t
+{
+	thread_local std::minstd_rand engine {std::random_device {}()};
+
+	return std::uniform_int_distribution<size_t> {0, bound - 1}(engine);
+}
+
+sock::BackendBalancer::Request::Request(
+    BackendBalancer& balancer,
+    size_t backend,
+    ConnectionPool::Lease&& lease
+) :
+    m_balancer {&balancer},
+    m_backend {backend},
+    m_start {std::chrono::steady_clock::now()},
+    m_lease {std::move(lease)}
+{}
+
+sock::BackendBalancer::Request::Request(Request&& other) :
+    m_balancer {other.m_balancer},
+    m_backend {other.m_backend},
+    m_start {other.m_start},
+    m_lease {std::move(other.m_lease)},
+    m_finished {std::exchange(other.m_finished, true)}
+{}
+
+sock::BackendBalancer::Request::~Request()
+{
+	if (!m_finished)
+	{
+		finish(m_lease.status() == Status::GOOD
+		       && m_lease.socket().status() == Status::GOOD);
+	}
+}
+
+auto sock::BackendBalancer::Request::finish(bool ok) -> void
+{
+	if (std::exchange(m_finished, true))
+	{
+		return;
+	}
+
+	auto& stats = m_balancer->m_stats[m_backend];
+	const std::chrono::nanoseconds took =
+	    std::chrono::steady_clock::now() - m_start;
+
+	if (ok)
+	{
+		const auto sample = static_cast<uint64_t>(took.count());
+		const auto average = stats.latency_ns.load(std::memory_order_relaxed);
+
+		// Racing updates may lose a sample, which an average can afford.
+		stats.latency_ns.store(
+		    average == 0 ? sample : average - average / 8 + sample / 8,
+		    std::memory_order_relaxed
+		);
+		stats.completed++;
+	}
+	else
+	{
+		stats.failed++;
+		m_lease.discard();
+	}
+
+	stats.outstanding--;
+	m_balancer->m_outstanding--;
+
+	// Puts the connection back, or closes it, right away.
+	auto released = std::move(m_lease);
+}
+
+sock::BackendBalancer::BackendBalancer(
+    CtorArgs args,
+    std::vector<Endpoint> backends,
+    BackendOptions options
+) :
+    m_endpoints {std::move(backends)},
+    m_stats {std::make_unique<BackendStats[]>(m_endpoints.size())},
+    m_options {options},
+    m_pool {args, options.pool}
+{
+	m_ring.reserve(m_endpoints.size() * m_options.replicas);
+
+	for (size_t i = 0; i < m_endpoints.size(); i++)
+	{
+		const auto name = m_endpoints[i].to_string();
+
+		for (size_t replica = 0; replica < m_options.replicas; replica++)
+		{
+			m_ring.emplace_back(hash(name + "#" + std::to_string(replica)), i);
+		}
+	}
+
+	std::sort(m_ring.begin(), m_ring.end());
+}
+
+auto sock::BackendBalancer::start(size_t backend) -> Request
+{
+	m_stats[backend].outstanding++;
+	m_outstanding++;
+
+	return Request {*this, backend, m_pool.acquire(m_endpoints[backend])};
+}
+
+auto sock::BackendBalancer::pick(std::string_view key) const -> size_t
+{
+	if (m_ring.empty())
+	{
+		return 0;
+	}
+
+	// "Consistent Hashing with Bounded Loads": counting the request about
+	// to start, nobody may go above `load_factor` times the mean.
+	const auto total = m_outstanding.load(std::memory_order_relaxed) + 1;
+	const auto capacity = static_cast<uint64_t>(std::ceil(
+	    m_options.load_factor * static_cast<double>(total) / m_endpoints.size()
+	));
+
+	const auto point = hash(key);
+	auto it = std::lower_bound(
+	    m_ring.begin(),
+	    m_ring.end(),
+	    std::pair<uint64_t, size_t> {point, 0}
+	);
+
+	// Every backend is on the ring, so one lap finds one below capacity.
+	for (size_t step = 0; step < m_ring.size(); step++, it++)
+	{
+		if (it == m_ring.end())
+		{
+			it = m_ring.begin();
+		}
+
+		if (m_stats[it->second].outstanding.load(std::memory_order_relaxed)
+		    < capacity)
+		{
+			return it->second;
+		}
+	}
+
+	return it == m_ring.end() ? m_ring.front().second : it->second;
+}
+
+auto sock::BackendBalancer::pick() const -> size_t
+{
+	const auto n = m_endpoints.size();
+
+	if (n < 2)
+	{
+		return 0;
+	}
+
+	const auto a = random_below(n);
+	const auto b = (a + 1 + random_below(n - 1)) % n;
+
+	const auto load_a = m_stats[a].outstanding.load(std::memory_order_relaxed);
+	const auto load_b = m_stats[b].outstanding.load(std::memory_order_relaxed);
+
+	if (load_a != load_b)
+	{
+		return load_a < load_b ? a : b;
+	}
+
+	return m_stats[a].latency_ns.load(std::memory_order_relaxed)
+	        <= m_stats[b].latency_ns.load(std::memory_order_relaxed)
+	    ? a
+	    : b;
+}
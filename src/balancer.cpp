@@ -0,0 +1,93 @@
+#include "sock/balancer.hpp"
+
+sock::Balancer::Balancer(Runtime& runtime, BalancerOptions options) :
+    m_runtime {runtime},
+    m_options {options},
+    m_previous(runtime.size(), 0)
+{}
+
+sock::Balancer::~Balancer()
+{
+	{
+		std::lock_guard lock {m_mutex};
+		m_stopping = true;
+	}
+	m_wakeup.notify_all();
+
+	if (m_thread.joinable())
+	{
+		m_thread.join();
+	}
+}
+
+bool sock::Balancer::rebalance()
+{
+	const auto cores = m_runtime.size();
+
+	if (cores < 2)
+	{
+		return false;
+	}
+
+	size_t busiest = 0;
+	size_t idlest = 0;
+	uint64_t total = 0;
+	std::vector<uint64_t> loads(cores);
+
+	for (size_t i = 0; i < cores; i++)
+	{
+		const auto load =
+		    m_runtime.core(i).metrics().load.load(std::memory_order_relaxed);
+		loads[i] = load - m_previous[i];
+		m_previous[i] = load;
+		total += loads[i];
+
+		busiest = loads[i] > loads[busiest] ? i : busiest;
+		idlest = loads[i] < loads[idlest] ? i : idlest;
+	}
+
+	const auto mean = static_cast<double>(total) / cores;
+
+	if (loads[busiest] < m_options.min_load
+	    || loads[busiest] < mean * m_options.threshold)
+	{
+		return false;
+	}
+
+	// Moving more than half the gap would just swap the roles.
+	const auto budget = (loads[busiest] - loads[idlest]) / 2;
+
+	m_runtime.core(busiest).send(
+	    busiest,
+	    [idlest, budget](Core& core)
+	    {
+		    core.shed(idlest, budget);
+	    }
+	);
+	m_decisions.fetch_add(1, std::memory_order_relaxed);
+
+	return true;
+}
+
+sock::Balancer& sock::Balancer::start()
+{
+	m_thread = std::thread {
+	    [this]()
+	    {
+		    std::unique_lock lock {m_mutex};
+
+		    while (!m_wakeup.wait_for(
+		        lock,
+		        m_options.interval,
+		        [this]()
+		        {
+			        return m_stopping;
+		        }
+		    ))
+		    {
+			    rebalance();
+		    }
+	    }};
+
+	return *this;
+}
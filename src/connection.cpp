@@ -0,0 +1,242 @@
+#include "sock/connection.hpp"
+#include "sock/runtime.hpp"
+#include <cerrno>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+sock::Connection::Connection(
+    sock::Socket&& socket,
+    Handler handler,
+    Watermarks watermarks
+) :
+    m_sock {std::move(socket)},
+    m_handler {std::move(handler)}
+{
+	m_sock.non_blocking(true);
+	this->watermarks(watermarks);
+}
+
+sock::Connection& sock::Connection::watermarks(Watermarks watermarks)
+{
+	m_watermarks = watermarks;
+
+	if (watermarks.not_sent_lowat > 0)
+	{
+		setsockopt(
+		    m_sock.native_handle(),
+		    IPPROTO_TCP,
+		    TCP_NOTSENT_LOWAT,
+		    &watermarks.not_sent_lowat,
+		    sizeof(watermarks.not_sent_lowat)
+		);
+	}
+
+	if (m_core != nullptr)
+	{
+		refresh();
+	}
+
+	return *this;
+}
+
+sock::Connection& sock::Connection::pause_input()
+{
+	m_input_paused = true;
+
+	if (m_core != nullptr)
+	{
+		refresh();
+	}
+
+	return *this;
+}
+
+sock::Connection& sock::Connection::resume_input()
+{
+	m_input_paused = false;
+
+	if (m_core != nullptr)
+	{
+		refresh();
+	}
+
+	return *this;
+}
+
+sock::Connection& sock::Connection::write(std::string_view payload)
+{
+	const auto n = m_output.write(m_sock.native_handle(), payload);
+
+	if (n < 0)
+	{
+		m_closed = true;
+	}
+	else
+	{
+		m_load += n;
+	}
+
+	// Writes from other connections' handlers, e.g. a proxy's upstream,
+	// are not followed by a `settle()` of this one.
+	if (m_core != nullptr && !m_closed)
+	{
+		refresh();
+	}
+
+	return *this;
+}
+
+sock::Connection& sock::Connection::write(
+    std::span<const std::string_view> payloads
+)
+{
+	const auto n = m_output.write(m_sock.native_handle(), payloads);
+
+	if (n < 0)
+	{
+		m_closed = true;
+	}
+	else
+	{
+		m_load += n;
+	}
+
+	if (m_core != nullptr && !m_closed)
+	{
+		refresh();
+	}
+
+	return *this;
+}
+
+uint32_t sock::Connection::events()
+{
+	uint32_t events = 0;
+
+	if (!m_input_paused && !m_congested && !m_finishing)
+	{
+		events |= Events::READABLE;
+	}
+
+	// Only wait for writability while there is something to write.
+	if (m_output.pending())
+	{
+		events |= Events::WRITABLE;
+	}
+
+	return events;
+}
+
+void sock::Connection::attach(Core& core)
+{
+	m_core = &core;
+	m_armed = events();
+}
+
+void sock::Connection::detach()
+{
+	m_core->metrics().queued.fetch_sub(m_queued, std::memory_order_relaxed);
+	m_queued = 0;
+	m_core = nullptr;
+}
+
+void sock::Connection::on_events(uint32_t ready)
+{
+	auto& core = *m_core;
+	const auto before = m_load;
+
+	// Wakeups from producers of `post()` come without events. Output
+	// waiting for a socket that is only readable stays where it is.
+	if (ready == 0 || ready & Events::WRITABLE)
+	{
+		const auto n = m_output.flush(m_sock.native_handle());
+
+		if (n < 0)
+		{
+			m_closed = true;
+		}
+		else
+		{
+			m_load += n;
+		}
+	}
+
+	if (ready & (Events::READABLE | Events::HANGUP | Events::FAILURE)
+	    && !m_closed)
+	{
+		auto buff = core.buffers().acquire();
+		const auto received =
+		    recv(m_sock.native_handle(), buff->buffer(), buff->max_size(), 0);
+
+		if (received > 0)
+		{
+			m_load += received;
+			m_input.append(buff->buffer(), received);
+			m_handler(*this);
+		}
+		else if (received == 0 || errno != EAGAIN)
+		{
+			m_closed = true;
+		}
+	}
+
+	settle(core, before);
+}
+
+void sock::Connection::settle(Core& core, uint64_t load_before)
+{
+	core.metrics().load.fetch_add(m_load - load_before, std::memory_order_relaxed);
+
+	if (m_finishing && !m_output.pending())
+	{
+		m_closed = true;
+	}
+
+	if (m_closed)
+	{
+		core.drop(*this);
+		return;
+	}
+
+	refresh();
+}
+
+void sock::Connection::refresh()
+{
+	auto& core = *m_core;
+	const auto depth = m_output.pending_bytes();
+
+	// Unsigned wrap-around makes this a subtraction when the queue shrank.
+	core.metrics().queued.fetch_add(depth - m_queued, std::memory_order_relaxed);
+	m_queued = depth;
+
+	if (!m_congested && depth > m_watermarks.high)
+	{
+		m_congested = true;
+		core.metrics().congestions.fetch_add(1, std::memory_order_relaxed);
+	}
+	else if (m_congested && depth <= m_watermarks.low)
+	{
+		m_congested = false;
+
+		if (m_on_drained)
+		{
+			// May write again, which refreshes on its own.
+			m_on_drained(*this);
+		}
+	}
+
+	if (m_closed || m_core == nullptr)
+	{
+		return;
+	}
+
+	const auto wanted = events();
+
+	if (m_armed != wanted)
+	{
+		m_armed = wanted;
+		core.reactor().modify(m_sock.native_handle(), wanted);
+	}
+}
@@ -0,0 +1,434 @@
+#include "sock/connection_pool.hpp"
+#include <cerrno>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <sys/socket.h>
+#include <unordered_map>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+struct sock::internal::PoolState
+{
+	struct Idle
+	{
+		sock::Socket socket;
+		Clock::time_point since;
+	};
+
+	struct Bucket
+	{
+		// Oldest first, reused from the back.
+		std::deque<Idle> idle;
+		size_t open {0};
+	};
+
+	CtorArgs args;
+	PoolOptions options;
+	uint64_t id;
+
+	std::mutex mutex;
+	std::condition_variable released;
+	std::unordered_map<Endpoint, Bucket> buckets;
+	std::atomic<size_t> waiting {0};
+
+	PoolMetrics metrics;
+
+	auto closed(const Endpoint& endpoint) -> void
+	{
+		{
+			const std::lock_guard lock {mutex};
+			buckets[endpoint].open--;
+		}
+
+		released.notify_one();
+	}
+};
+
+namespace
+{
+	struct Cached
+	{
+		std::weak_ptr<sock::internal::PoolState> pool;
+		uint64_t id;
+		sock::Endpoint endpoint;
+		sock::Socket socket;
+		Clock::time_point since;
+	};
+
+	struct ThreadCache
+	{
+		std::vector<Cached> entries;
+
+		~ThreadCache()
+		{
+			for (auto& entry : entries)
+			{
+				if (auto pool = entry.pool.lock())
+				{
+					entry.socket = sock::Socket {};
+					pool->closed(entry.endpoint);
+				}
+			}
+		}
+	};
+
+	thread_local ThreadCache t_cache;
+	std::atomic<uint64_t> g_next_id {1};
+} // namespace
+
+/**
+ * Whether an idle connection can be reused: nothing to read and not
+ * closed by the peer.
+ */
+static auto alive(const sock::Socket& socket) -> bool
+{
+	char byte;
+	const auto n =
+	    recv(socket.native_handle(), &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+
+	// Zero is an orderly close, data a response nobody asked for.
+	return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+}
+
+static auto domain_of(const sock::Endpoint& endpoint) -> sock::Domain
+{
+	switch (endpoint.family())
+	{
+		case AF_INET6:
+			return sock::Domain::INET6;
+		case AF_UNIX:
+			return sock::Domain::LOCAL;
+		default:
+			return sock::Domain::INET;
+	}
+}
+
+sock::ConnectionPool::Lease::Lease(
+    std::shared_ptr<internal::PoolState> state,
+    Endpoint endpoint,
+    sock::Socket&& socket,
+    Status status
+) :
+    m_state {std::move(state)},
+    m_endpoint {endpoint},
+    m_socket {std::move(socket)},
+    m_status {status}
+{}
+
+sock::ConnectionPool::Lease::Lease(Lease&& other) :
+    m_state {std::move(other.m_state)},
+    m_endpoint {other.m_endpoint},
+    m_socket {std::move(other.m_socket)},
+    m_status {other.m_status},
+    m_reuse {other.m_reuse}
+{}
+
+sock::ConnectionPool::Lease& sock::ConnectionPool::Lease::operator=(Lease&& other)
+{
+	if (this != &other)
+	{
+		release();
+
+		m_state = std::move(other.m_state);
+		m_endpoint = other.m_endpoint;
+		m_socket = std::move(other.m_socket);
+		m_status = other.m_status;
+		m_reuse = other.m_reuse;
+	}
+
+	return *this;
+}
+
+sock::ConnectionPool::Lease::~Lease()
+{
+	release();
+}
+
+auto sock::ConnectionPool::Lease::release() -> void
+{
+	// Failed checkouts and moved-from leases hold no connection.
+	if (!m_state)
+	{
+		return;
+	}
+
+	const auto state = std::move(m_state);
+
+	if (!m_reuse || m_socket.status() != Status::GOOD)
+	{
+		m_socket = sock::Socket {};
+		state->closed(m_endpoint);
+
+		return;
+	}
+
+	const auto now = Clock::now();
+
+	// Kept to this thread unless another one is waiting for it.
+	if (state->waiting.load() == 0)
+	{
+		auto& entries = t_cache.entries;
+		size_t own = 0;
+
+		for (auto it = entries.begin(); it != entries.end();)
+		{
+			if (it->pool.expired())
+			{
+				it = entries.erase(it);
+				continue;
+			}
+
+			own += it->id == state->id;
+			++it;
+		}
+
+		if (own < state->options.thread_cache)
+		{
+			entries.push_back({
+			    .pool = state,
+			    .id = state->id,
+			    .endpoint = m_endpoint,
+			    .socket = std::move(m_socket),
+			    .since = now,
+			});
+
+			return;
+		}
+	}
+
+	{
+		const std::lock_guard lock {state->mutex};
+		state->buckets[m_endpoint].idle.push_back({std::move(m_socket), now});
+	}
+
+	state->released.notify_one();
+}
+
+sock::ConnectionPool::ConnectionPool(CtorArgs args, PoolOptions options) :
+    m_state {std::make_shared<internal::PoolState>()}
+{
+	m_state->args = args;
+	m_state->options = options;
+	m_state->id = g_next_id++;
+}
+
+sock::ConnectionPool::~ConnectionPool()
+{
+	// Other threads drop theirs once they notice the pool is gone.
+	std::erase_if(
+	    t_cache.entries,
+	    [id = m_state->id](const Cached& entry)
+	    {
+		    return entry.id == id;
+	    }
+	);
+}
+
+auto sock::ConnectionPool::acquire(const Endpoint& endpoint) -> Lease
+{
+	auto& state = *m_state;
+	auto& metrics = state.metrics;
+	const auto& options = state.options;
+
+	// Most recently released first, the likeliest to still be open.
+	for (auto i = t_cache.entries.size(); i-- > 0;)
+	{
+		auto& entry = t_cache.entries[i];
+
+		if (entry.id != state.id || !(entry.endpoint == endpoint))
+		{
+			continue;
+		}
+
+		auto socket = std::move(entry.socket);
+		const auto fresh = Clock::now() - entry.since < options.idle_timeout;
+		t_cache.entries.erase(t_cache.entries.begin() + i);
+
+		if (fresh && alive(socket))
+		{
+			metrics.hits++;
+
+			return Lease {m_state, endpoint, std::move(socket), Status::GOOD};
+		}
+
+		(fresh ? metrics.broken : metrics.evicted)++;
+		socket = sock::Socket {};
+		state.closed(endpoint);
+	}
+
+	std::unique_lock lock {state.mutex};
+	auto& bucket = state.buckets[endpoint];
+	std::optional<Clock::time_point> waited_since;
+
+	const auto waited = [&metrics, &waited_since]()
+	{
+		if (waited_since)
+		{
+			const std::chrono::nanoseconds took = Clock::now() - *waited_since;
+			metrics.wait_ns += took.count();
+		}
+	};
+
+	while (true)
+	{
+		while (!bucket.idle.empty())
+		{
+			auto idle = std::move(bucket.idle.back());
+			bucket.idle.pop_back();
+
+			const auto fresh = Clock::now() - idle.since < options.idle_timeout;
+
+			if (fresh && alive(idle.socket))
+			{
+				metrics.hits++;
+				waited();
+
+				return Lease {m_state, endpoint, std::move(idle.socket), Status::GOOD};
+			}
+
+			(fresh ? metrics.broken : metrics.evicted)++;
+			bucket.open--;
+		}
+
+		if (bucket.open < options.max_size)
+		{
+			break;
+		}
+
+		if (!waited_since)
+		{
+			waited_since = Clock::now();
+			metrics.waits++;
+		}
+
+		state.waiting++;
+		const auto available = state.released.wait_until(
+		    lock,
+		    *waited_since + options.wait_timeout,
+		    [&bucket, &options]()
+		    {
+			    return !bucket.idle.empty() || bucket.open < options.max_size;
+		    }
+		);
+		state.waiting--;
+
+		if (!available)
+		{
+			metrics.timeouts++;
+			waited();
+
+			return Lease {nullptr, endpoint, sock::Socket {}, Status::TIMED_OUT};
+		}
+	}
+
+	bucket.open++;
+	lock.unlock();
+	waited();
+	metrics.misses++;
+
+	sock::Socket socket {sock::CtorArgs {
+	    .domain = domain_of(endpoint),
+	    .type = state.args.type,
+	    .protocol = state.args.protocol,
+	    .flags = state.args.flags,
+	}};
+	socket.connect(endpoint);
+
+	if (socket.status() != Status::GOOD)
+	{
+		const auto status = socket.status();
+		state.closed(endpoint);
+
+		return Lease {nullptr, endpoint, std::move(socket), status};
+	}
+
+	return Lease {m_state, endpoint, std::move(socket), Status::GOOD};
+}
+
+auto sock::ConnectionPool::warm(const Endpoint& endpoint) -> Status
+{
+	auto& state = *m_state;
+
+	while (true)
+	{
+		{
+			const std::lock_guard lock {state.mutex};
+			auto& bucket = state.buckets[endpoint];
+
+			if (bucket.idle.size() >= state.options.min_idle
+			    || bucket.open >= state.options.max_size)
+			{
+				return Status::GOOD;
+			}
+
+			bucket.open++;
+		}
+
+		sock::Socket socket {sock::CtorArgs {
+		    .domain = domain_of(endpoint),
+		    .type = state.args.type,
+		    .protocol = state.args.protocol,
+		    .flags = state.args.flags,
+		}};
+		socket.connect(endpoint);
+
+		if (socket.status() != Status::GOOD)
+		{
+			state.closed(endpoint);
+
+			return socket.status();
+		}
+
+		{
+			const std::lock_guard lock {state.mutex};
+			state.buckets[endpoint].idle.push_back({std::move(socket), Clock::now()});
+		}
+
+		state.released.notify_one();
+	}
+}
+
+auto sock::ConnectionPool::evict_idle() -> size_t
+{
+	auto& state = *m_state;
+	const auto now = Clock::now();
+	size_t evicted = 0;
+
+	const std::lock_guard lock {state.mutex};
+
+	for (auto& [endpoint, bucket] : state.buckets)
+	{
+		while (bucket.idle.size() > state.options.min_idle
+		       && now - bucket.idle.front().since >= state.options.idle_timeout)
+		{
+			bucket.idle.pop_front();
+			bucket.open--;
+			evicted++;
+		}
+	}
+
+	state.metrics.evicted += evicted;
+
+	if (evicted > 0)
+	{
+		state.released.notify_all();
+	}
+
+	return evicted;
+}
+
+auto sock::ConnectionPool::idle(const Endpoint& endpoint) const -> size_t
+{
+	const std::lock_guard lock {m_state->mutex};
+	const auto found = m_state->buckets.find(endpoint);
+
+	return found == m_state->buckets.end() ? 0 : found->second.idle.size();
+}
+
+auto sock::ConnectionPool::metrics() const -> const PoolMetrics&
+{
+	return m_state->metrics;
+}
@@ -0,0 +1,370 @@
+#include "sock/endpoint.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <memory>
+
+#if !defined(WIN32) && !defined(_WIN32) \
+    && !(defined(__WIN32) && !defined(__CYGWIN__))
+#include "sock/internal/local_address.hpp"
+#include <arpa/inet.h>
+#define SOCK_ENDPOINT_LOCAL_
+#endif
+
+static constexpr int get_address_family(sock::Domain d)
+{
+	switch (d)
+	{
+		case sock::Domain::INET:
+			return AF_INET;
+		case sock::Domain::UNSPEC:
+			return AF_UNSPEC;
+		case sock::Domain::LOCAL:
+			return AF_UNIX;
+		case sock::Domain::INET6:
+			return AF_INET6;
+	}
+
+	return AF_UNSPEC;
+}
+
+static constexpr int get_socket_type(sock::Type t)
+{
+	switch (t)
+	{
+		case sock::Type::STREAM:
+			return SOCK_STREAM;
+		case sock::Type::SEQPACKET:
+			return SOCK_SEQPACKET;
+	}
+
+	return SOCK_STREAM;
+}
+
+static auto parse_port(std::string_view port, uint16_t& parsed) -> bool
+{
+	if (port.empty())
+	{
+		parsed = 0;
+
+		return true;
+	}
+
+	const auto end = port.data() + port.size();
+	const auto [ptr, error] = std::from_chars(port.data(), end, parsed);
+
+	return error == std::errc {} && ptr == end;
+}
+
+sock::Endpoint::Endpoint(const sockaddr* address, socklen_t size)
+    : m_size {std::min<socklen_t>(size, sizeof(m_storage))}
+{
+	std::memcpy(&m_storage, address, m_size);
+}
+
+auto sock::Endpoint::parse(sock::Address address) -> std::optional<Endpoint>
+{
+	uint16_t port;
+
+	// inet_pton() wants a terminated string, and no literal is longer.
+	if (address.host.empty() || address.host.size() >= INET6_ADDRSTRLEN
+	    || !parse_port(address.port, port))
+	{
+		return std::nullopt;
+	}
+
+	char host[INET6_ADDRSTRLEN] {};
+	std::memcpy(host, address.host.data(), address.host.size());
+
+	sockaddr_in v4 {};
+
+	if (inet_pton(AF_INET, host, &v4.sin_addr) == 1)
+	{
+		v4.sin_family = AF_INET;
+		v4.sin_port = htons(port);
+
+		return Endpoint {reinterpret_cast<sockaddr*>(&v4), sizeof(v4)};
+	}
+
+	sockaddr_in6 v6 {};
+
+	if (inet_pton(AF_INET6, host, &v6.sin6_addr) == 1)
+	{
+		v6.sin6_family = AF_INET6;
+		v6.sin6_port = htons(port);
+
+		return Endpoint {reinterpret_cast<sockaddr*>(&v6), sizeof(v6)};
+	}
+
+	return std::nullopt;
+}
+
+auto sock::Endpoint::port() const -> uint16_t
+{
+	switch (family())
+	{
+		case AF_INET:
+			return ntohs(reinterpret_cast<const sockaddr_in*>(&m_storage)->sin_port);
+		case AF_INET6:
+			return ntohs(reinterpret_cast<const sockaddr_in6*>(&m_storage)->sin6_port);
+		default:
+			return 0;
+	}
+}
+
+auto sock::Endpoint::for_family(int socket_family) const -> Endpoint
+{
+	if (socket_family != AF_INET6 || family() != AF_INET)
+	{
+		return *this;
+	}
+
+	const auto& v4 = *reinterpret_cast<const sockaddr_in*>(&m_storage);
+	sockaddr_in6 mapped {};
+	mapped.sin6_family = AF_INET6;
+	mapped.sin6_port = v4.sin_port;
+	// ::ffff:a.b.c.d
+	mapped.sin6_addr.s6_addr[10] = 0xff;
+	mapped.sin6_addr.s6_addr[11] = 0xff;
+	std::memcpy(&mapped.sin6_addr.s6_addr[12], &v4.sin_addr, sizeof(v4.sin_addr));
+
+	return Endpoint {reinterpret_cast<sockaddr*>(&mapped), sizeof(mapped)};
+}
+
+auto sock::Endpoint::to_string() const -> std::string
+{
+	char host[INET6_ADDRSTRLEN] {};
+
+	switch (family())
+	{
+		case AF_INET:
+			inet_ntop(
+			    AF_INET,
+			    &reinterpret_cast<const sockaddr_in*>(&m_storage)->sin_addr,
+			    host,
+			    sizeof(host)
+			);
+
+			return std::string {host} + ":" + std::to_string(port());
+		case AF_INET6:
+			inet_ntop(
+			    AF_INET6,
+			    &reinterpret_cast<const sockaddr_in6*>(&m_storage)->sin6_addr,
+			    host,
+			    sizeof(host)
+			);
+
+			return "[" + std::string {host} + "]:" + std::to_string(port());
+#ifdef SOCK_ENDPOINT_LOCAL_
+		case AF_UNIX:
+		{
+			const auto path = reinterpret_cast<const sockaddr_un*>(&m_storage)->sun_path;
+			const auto length = m_size - offsetof(sockaddr_un, sun_path);
+
+			// Abstract names start with a NUL and are not terminated.
+			if (length > 0 && path[0] == '\0')
+			{
+				return "@" + std::string {path + 1, length - 1};
+			}
+
+			return std::string {path, strnlen(path, length)};
+		}
+#endif
+		default:
+			return {};
+	}
+}
+
+auto sock::Endpoint::operator==(const Endpoint& other) const -> bool
+{
+	return m_size == other.m_size
+	    && std::memcmp(&m_storage, &other.m_storage, m_size) == 0;
+}
+
+auto sock::Endpoint::hash() const -> size_t
+{
+	return std::hash<std::string_view> {}(
+	    {reinterpret_cast<const char*>(&m_storage), m_size}
+	);
+}
+
+auto sock::internal::resolve(const addrinfo& hints, sock::Address address)
+    -> Resolution
+{
+#ifdef SOCK_ENDPOINT_LOCAL_
+	if (hints.ai_family == AF_UNIX)
+	{
+		sockaddr_un local;
+		const auto size = local_address(address.host, local);
+
+		if (size == 0)
+		{
+			return {.status = Status::GETADDRINFO_ERROR};
+		}
+
+		return {.endpoints = {Endpoint {reinterpret_cast<sockaddr*>(&local), size}}};
+	}
+#endif
+
+	if (const auto literal = Endpoint::parse(address))
+	{
+		if (hints.ai_family != AF_UNSPEC && hints.ai_family != literal->family())
+		{
+			return {.status = Status::GETADDRINFO_ERROR};
+		}
+
+		return {.endpoints = {*literal}};
+	}
+
+	// Views need not be terminated, getaddrinfo() needs them to be.
+	const std::string host {address.host};
+	const std::string port {address.port};
+
+	addrinfo lookup = hints;
+
+#ifdef IPPROTO_MPTCP
+	// Unknown to getaddrinfo(), and its addresses are TCP's anyway.
+	if (lookup.ai_protocol == IPPROTO_MPTCP)
+	{
+		lookup.ai_protocol = IPPROTO_TCP;
+	}
+#endif
+
+	addrinfo* info = nullptr;
+
+	if (getaddrinfo(
+	        host.empty() ? nullptr : host.c_str(),
+	        port.c_str(),
+	        &lookup,
+	        &info
+	    )
+	    != 0)
+	{
+		return {.status = Status::GETADDRINFO_ERROR};
+	}
+
+	const std::unique_ptr<addrinfo, decltype(&freeaddrinfo)> guard {info, freeaddrinfo};
+	Resolution resolution;
+
+	for (auto rp = info; rp != nullptr; rp = rp->ai_next)
+	{
+		resolution.endpoints.emplace_back(rp->ai_addr, static_cast<socklen_t>(rp->ai_addrlen));
+	}
+
+	return resolution;
+}
+
+static auto to_hints(sock::CtorArgs args) -> addrinfo
+{
+	addrinfo hints {};
+	hints.ai_family = get_address_family(args.domain);
+	hints.ai_socktype = get_socket_type(args.type);
+	hints.ai_flags = args.flags;
+
+	return hints;
+}
+
+auto sock::resolve(CtorArgs args, sock::Address address) -> Resolution
+{
+	return internal::resolve(to_hints(args), address);
+}
+
+sock::ResolverCache::ResolverCache(
+    std::chrono::milliseconds ttl,
+    size_t capacity
+)
+    : m_ttl {ttl},
+      m_capacity {std::max<size_t>(capacity, 1)}
+{
+}
+
+auto sock::ResolverCache::resolve(CtorArgs args, sock::Address address)
+    -> Resolution
+{
+	if (args.domain == Domain::LOCAL || Endpoint::parse(address))
+	{
+		return sock::resolve(args, address);
+	}
+
+	std::string key;
+	key.reserve(address.host.size() + address.port.size() + 8);
+	key += static_cast<char>(args.domain);
+	key += static_cast<char>(args.type);
+	key += static_cast<char>(args.flags);
+	key += address.host;
+	key += '\0';
+	key += address.port;
+
+	{
+		const std::lock_guard lock {m_mutex};
+		const auto found = m_entries.find(key);
+
+		if (found != m_entries.end() && found->second.expires > Clock::now())
+		{
+			m_hits++;
+
+			return {.endpoints = found->second.endpoints};
+		}
+
+		m_misses++;
+	}
+
+	// Not holding the lock while the lookup blocks; two threads missing
+	// the same key at once both look it up.
+	auto resolution = sock::resolve(args, address);
+
+	if (resolution.status != Status::GOOD)
+	{
+		return resolution;
+	}
+
+	const auto now = Clock::now();
+	const std::lock_guard lock {m_mutex};
+
+	if (m_entries.size() >= m_capacity && !m_entries.contains(key))
+	{
+		std::erase_if(
+		    m_entries,
+		    [now](const auto& entry)
+		    {
+			    return entry.second.expires <= now;
+		    }
+		);
+
+		if (m_entries.size() >= m_capacity)
+		{
+			m_entries.erase(m_entries.begin());
+		}
+	}
+
+	m_entries[key] = {now + m_ttl, resolution.endpoints};
+
+	return resolution;
+}
+
+auto sock::ResolverCache::clear() -> void
+{
+	const std::lock_guard lock {m_mutex};
+	m_entries.clear();
+}
+
+auto sock::ResolverCache::size() const -> size_t
+{
+	const std::lock_guard lock {m_mutex};
+
+	return m_entries.size();
+}
+
+auto sock::ResolverCache::hits() const -> uint64_t
+{
+	const std::lock_guard lock {m_mutex};
+
+	return m_hits;
+}
+
+auto sock::ResolverCache::misses() const -> uint64_t
+{
+	const std::lock_guard lock {m_mutex};
+
+	return m_misses;
+}
@@ -0,0 +1,456 @@
+#include "sock/internal/epoll_engine.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+sock::internal::EpollEngine::EpollEngine(EngineOptions options) :
+    m_options {options},
+    m_buffer(options.buffer_size)
+{
+	m_status = m_reactor.status();
+}
+
+sock::internal::EpollEngine::State&
+    sock::internal::EpollEngine::state(int fd)
+{
+	const auto [it, inserted] = m_states.try_emplace(fd);
+
+	if (inserted)
+	{
+		const auto flags = fcntl(fd, F_GETFL, 0);
+		fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+	}
+
+	return it->second;
+}
+
+void sock::internal::EpollEngine::update(int fd)
+{
+	const auto it = m_states.find(fd);
+
+	if (it == m_states.end())
+	{
+		return;
+	}
+
+	auto& st = it->second;
+	uint32_t wanted = 0;
+
+	if (st.on_accept || st.on_receive)
+	{
+		wanted |= sock::Events::READABLE;
+	}
+
+	if (st.blocked)
+	{
+		wanted |= sock::Events::WRITABLE;
+	}
+
+	if (wanted == st.events)
+	{
+		return;
+	}
+
+	if (wanted == 0)
+	{
+		m_reactor.remove(fd);
+	}
+	else if (st.events == 0)
+	{
+		m_reactor.add(
+		    fd,
+		    wanted,
+		    [this, fd](uint32_t events)
+		    {
+			    on_ready(fd, events);
+		    }
+		);
+	}
+	else
+	{
+		m_reactor.modify(fd, wanted);
+	}
+
+	st.events = wanted;
+}
+
+sock::IoEngine&
+    sock::internal::EpollEngine::accept(int fd, CompletionHandler handler)
+{
+	state(fd).on_accept = std::move(handler);
+	update(fd);
+
+	return *this;
+}
+
+sock::IoEngine& sock::internal::EpollEngine::connect(
+    int fd,
+    const sockaddr* address,
+    socklen_t address_size,
+    CompletionHandler handler
+)
+{
+	auto& op = state(fd).queue.emplace_back(Operation {
+	    .kind = Kind::CONNECT,
+	    .handler = std::move(handler),
+	    .address_size = address_size,
+	});
+	std::memcpy(&op.address, address, address_size);
+	m_pending.push_back(fd);
+
+	return *this;
+}
+
+sock::IoEngine&
+    sock::internal::EpollEngine::receive(int fd, CompletionHandler handler)
+{
+	state(fd).on_receive = std::move(handler);
+	update(fd);
+
+	return *this;
+}
+
+sock::IoEngine& sock::internal::EpollEngine::send(
+    int fd,
+    std::string_view payload,
+    CompletionHandler handler,
+    bool link
+)
+{
+	state(fd).queue.push_back({
+	    .kind = Kind::SEND,
+	    .handler = std::move(handler),
+	    .payload = payload,
+	    .link = link,
+	});
+	m_pending.push_back(fd);
+
+	return *this;
+}
+
+sock::IoEngine& sock::internal::EpollEngine::send_fixed(
+    int fd,
+    unsigned,
+    std::string_view payload,
+    CompletionHandler handler,
+    bool link
+)
+{
+	// Nothing to gain from pinned memory without io_uring.
+	return send(fd, payload, std::move(handler), link);
+}
+
+sock::IoEngine& sock::internal::EpollEngine::shutdown(
+    int fd,
+    CompletionHandler handler,
+    bool link
+)
+{
+	state(fd).queue.push_back({
+	    .kind = Kind::SHUTDOWN,
+	    .handler = std::move(handler),
+	    .link = link,
+	});
+	m_pending.push_back(fd);
+
+	return *this;
+}
+
+sock::IoEngine&
+    sock::internal::EpollEngine::close(int fd, CompletionHandler handler)
+{
+	state(fd).queue.push_back({
+	    .kind = Kind::CLOSE,
+	    .handler = std::move(handler),
+	});
+	m_pending.push_back(fd);
+
+	return *this;
+}
+
+sock::IoEngine& sock::internal::EpollEngine::cancel(int fd)
+{
+	const auto it = m_states.find(fd);
+
+	if (it == m_states.end())
+	{
+		return *this;
+	}
+
+	auto on_accept = std::move(it->second.on_accept);
+	auto on_receive = std::move(it->second.on_receive);
+	it->second.on_accept = nullptr;
+	it->second.on_receive = nullptr;
+	update(fd);
+
+	if (on_accept)
+	{
+		m_dispatched++;
+		on_accept({.result = -ECANCELED});
+	}
+
+	if (on_receive)
+	{
+		m_dispatched++;
+		on_receive({.result = -ECANCELED});
+	}
+
+	return *this;
+}
+
+bool sock::internal::EpollEngine::register_files(std::span<const int>)
+{
+	return true;
+}
+
+bool sock::internal::EpollEngine::register_buffers(
+    std::span<const std::span<char>>
+)
+{
+	return true;
+}
+
+void sock::internal::EpollEngine::complete(int fd, int result)
+{
+	auto& queue = m_states[fd].queue;
+	auto op = std::move(queue.front());
+	queue.pop_front();
+
+	m_dispatched++;
+	op.handler({.result = result});
+
+	// A failed link cancels the rest of its chain.
+	for (auto link = op.link && result < 0;
+	     link && !m_states[fd].queue.empty();)
+	{
+		auto next = std::move(m_states[fd].queue.front());
+		m_states[fd].queue.pop_front();
+		link = next.link;
+
+		m_dispatched++;
+		next.handler({.result = -ECANCELED});
+	}
+}
+
+void sock::internal::EpollEngine::flush(int fd)
+{
+	while (true)
+	{
+		const auto it = m_states.find(fd);
+
+		if (it == m_states.end() || it->second.blocked
+		    || it->second.queue.empty())
+		{
+			break;
+		}
+
+		auto& st = it->second;
+		auto& op = st.queue.front();
+
+		switch (op.kind)
+		{
+			case Kind::CONNECT:
+			{
+				if (::connect(
+				        fd,
+				        reinterpret_cast<sockaddr*>(&op.address),
+				        op.address_size
+				    )
+				    == 0)
+				{
+					complete(fd, 0);
+				}
+				else if (errno == EINPROGRESS)
+				{
+					op.started = true;
+					st.blocked = true;
+				}
+				else
+				{
+					complete(fd, -errno);
+				}
+
+				break;
+			}
+			case Kind::SEND:
+			{
+				const auto n = ::send(
+				    fd,
+				    op.payload.data() + op.sent,
+				    op.payload.size() - op.sent,
+				    MSG_NOSIGNAL
+				);
+
+				if (n >= 0)
+				{
+					op.sent += n;
+
+					if (op.sent == op.payload.size())
+					{
+						complete(fd, static_cast<int>(op.sent));
+					}
+					else
+					{
+						st.blocked = true;
+					}
+				}
+				else if (errno == EAGAIN)
+				{
+					st.blocked = true;
+				}
+				else
+				{
+					complete(fd, -errno);
+				}
+
+				break;
+			}
+			case Kind::SHUTDOWN:
+			{
+				complete(fd, ::shutdown(fd, SHUT_RDWR) < 0 ? -errno : 0);
+				break;
+			}
+			case Kind::CLOSE:
+			{
+				auto handler = std::move(op.handler);
+
+				if (st.events != 0)
+				{
+					m_reactor.remove(fd);
+				}
+
+				m_states.erase(it);
+
+				const auto result = ::close(fd) < 0 ? -errno : 0;
+				m_dispatched++;
+				handler({.result = result});
+
+				return;
+			}
+		}
+	}
+
+	update(fd);
+}
+
+void sock::internal::EpollEngine::on_ready(int fd, uint32_t events)
+{
+	auto it = m_states.find(fd);
+
+	if (it == m_states.end())
+	{
+		return;
+	}
+
+	constexpr uint32_t broken = sock::Events::HANGUP | sock::Events::FAILURE;
+
+	if (it->second.blocked && (events & (sock::Events::WRITABLE | broken)))
+	{
+		auto& st = it->second;
+		st.blocked = false;
+
+		if (!st.queue.empty() && st.queue.front().kind == Kind::CONNECT)
+		{
+			int error = 0;
+			socklen_t size = sizeof(error);
+			getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &size);
+
+			complete(fd, -error);
+		}
+
+		flush(fd);
+	}
+
+	it = m_states.find(fd);
+
+	if (it != m_states.end() && it->second.on_accept
+	    && (events & (sock::Events::READABLE | broken)))
+	{
+		while (true)
+		{
+			const auto connection =
+			    accept4(fd, nullptr, nullptr, SOCK_CLOEXEC);
+
+			if (connection < 0 && errno == EAGAIN)
+			{
+				break;
+			}
+
+			// Handler may cancel itself.
+			auto handler = m_states[fd].on_accept;
+			m_dispatched++;
+			handler({
+			    .result = connection < 0 ? -errno : connection,
+			    .more = true,
+			});
+
+			if (connection < 0 || !m_states[fd].on_accept)
+			{
+				break;
+			}
+		}
+	}
+
+	it = m_states.find(fd);
+
+	if (it != m_states.end() && it->second.on_receive
+	    && (events & (sock::Events::READABLE | broken)))
+	{
+		const auto n = recv(fd, m_buffer.data(), m_buffer.size(), 0);
+
+		if (n < 0 && errno == EAGAIN)
+		{
+			return;
+		}
+
+		const auto result = n < 0 ? -errno : static_cast<int>(n);
+		const auto size = n > 0 ? static_cast<size_t>(n) : 0;
+		auto handler = it->second.on_receive;
+
+		if (n <= 0)
+		{
+			it->second.on_receive = nullptr;
+			update(fd);
+		}
+
+		m_dispatched++;
+		handler({
+		    .result = result,
+		    .data = std::string_view {m_buffer.data(), size},
+		    .more = n > 0,
+		});
+	}
+}
+
+size_t sock::internal::EpollEngine::submit()
+{
+	std::vector<int> pending;
+	pending.swap(m_pending);
+
+	for (const auto fd : pending)
+	{
+		flush(fd);
+	}
+
+	return pending.size();
+}
+
+size_t sock::internal::EpollEngine::run_once(std::chrono::milliseconds timeout)
+{
+	m_dispatched = 0;
+	submit();
+
+	// Operations completed synchronously, do not block for more.
+	m_reactor.run_once(
+	    m_dispatched > 0 ? std::chrono::milliseconds {0} : timeout
+	);
+	submit();
+
+	if (m_reactor.status() != sock::Status::GOOD)
+	{
+		m_status = m_reactor.status();
+	}
+
+	return m_dispatched;
+}
@@ -0,0 +1,190 @@
+#include "sock/executor.hpp"
+#include <algorithm>
+
+namespace
+{
+	struct Current
+	{
+		sock::Executor* executor {nullptr};
+		size_t index {0};
+	};
+
+	thread_local Current current;
+} // namespace
+
+sock::Executor::Executor(size_t workers)
+{
+	if (workers == 0)
+	{
+		workers = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	m_workers.reserve(workers);
+
+	for (size_t i = 0; i < workers; i++)
+	{
+		m_workers.emplace_back(std::make_unique<Worker>());
+	}
+
+	// Threads start only once every deque exists, they steal from each
+	// other right away.
+	for (size_t i = 0; i < workers; i++)
+	{
+		m_workers[i]->thread = std::thread {&Executor::run, this, i};
+	}
+}
+
+sock::Executor::~Executor()
+{
+	m_stopping = true;
+
+	{
+		std::lock_guard lock {m_sleep_mutex};
+	}
+	m_sleep.notify_all();
+
+	for (auto& worker : m_workers)
+	{
+		worker->thread.join();
+	}
+}
+
+void sock::Executor::submit(Job job)
+{
+	auto item = new Job {std::move(job)};
+
+	m_pending.fetch_add(1, std::memory_order_seq_cst);
+
+	if (current.executor == this)
+	{
+		m_workers[current.index]->deque.push(item);
+	}
+	else
+	{
+		std::lock_guard lock {m_injected_mutex};
+		m_injected.push_back(item);
+	}
+
+	if (m_sleeping.load(std::memory_order_seq_cst) > 0)
+	{
+		{
+			std::lock_guard lock {m_sleep_mutex};
+		}
+		m_sleep.notify_one();
+	}
+}
+
+sock::Reactor::Handler sock::Executor::offload(
+    Reactor& reactor,
+    int fd,
+    uint32_t events,
+    Reactor::Handler handler
+)
+{
+	auto shared = std::make_shared<Reactor::Handler>(std::move(handler));
+
+	return [this, &reactor, fd, events, shared](uint32_t ready)
+	{
+		submit(
+		    [&reactor, fd, events, shared, ready]()
+		    {
+			    (*shared)(ready);
+
+			    reactor.post(
+			        [&reactor, fd, events]()
+			        {
+				        // The handler may have closed the connection.
+				        if (reactor.contains(fd))
+				        {
+					        reactor.modify(fd, events);
+				        }
+			        }
+			    );
+		    }
+		);
+	};
+}
+
+sock::Executor::Job* sock::Executor::find(size_t index)
+{
+	Job* job = nullptr;
+
+	if (m_workers[index]->deque.pop(job))
+	{
+		return job;
+	}
+
+	{
+		std::lock_guard lock {m_injected_mutex};
+
+		if (!m_injected.empty())
+		{
+			job = m_injected.front();
+			m_injected.pop_front();
+
+			return job;
+		}
+	}
+
+	// Start at a different victim per worker so thieves spread out.
+	for (size_t i = 1; i < m_workers.size(); i++)
+	{
+		const auto victim = (index + i) % m_workers.size();
+
+		if (m_workers[victim]->deque.steal(job))
+		{
+			m_steals.fetch_add(1, std::memory_order_relaxed);
+			return job;
+		}
+	}
+
+	return nullptr;
+}
+
+bool sock::Executor::wait()
+{
+	std::unique_lock lock {m_sleep_mutex};
+
+	m_sleeping.fetch_add(1, std::memory_order_seq_cst);
+	m_sleep.wait(
+	    lock,
+	    [this]()
+	    {
+		    return m_pending.load(std::memory_order_seq_cst) > 0
+		        || m_stopping.load();
+	    }
+	);
+	m_sleeping.fetch_sub(1, std::memory_order_seq_cst);
+
+	return m_pending.load() > 0 || !m_stopping.load();
+}
+
+void sock::Executor::run(size_t index)
+{
+	current = {.executor = this, .index = index};
+
+	while (true)
+	{
+		if (auto job = find(index))
+		{
+			m_pending.fetch_sub(1, std::memory_order_relaxed);
+			(*job)();
+			delete job;
+			continue;
+		}
+
+		if (m_pending.load() > 0)
+		{
+			// A job is on its way into some queue.
+			std::this_thread::yield();
+			continue;
+		}
+
+		if (!wait())
+		{
+			break;
+		}
+	}
+
+	current = {};
+}
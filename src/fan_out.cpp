@@ -0,0 +1,78 @@
+#include "sock/fan_out.hpp"
+#include <utility>
+
+sock::FanOut::FanOut(
+    Reactor& reactor,
+    CtorArgs args,
+    std::span<const Address> addresses,
+    std::chrono::milliseconds timeout
+) :
+    m_shared {std::make_shared<Shared>()}
+{
+	m_shared->in_flight.resize(addresses.size(), nullptr);
+	m_shared->remaining = addresses.size();
+
+	for (size_t i = 0; i < addresses.size(); i++)
+	{
+		AsyncSocket socket {reactor, args};
+		socket.timeout(timeout);
+
+		// Runs up to the first suspension, resolving the address while
+		// its view is still valid.
+		sock::spawn(attempt(m_shared, std::move(socket), addresses[i], i));
+	}
+}
+
+sock::FanOut::~FanOut()
+{
+	// Cancelled attempts finish synchronously and clear their slot.
+	for (size_t i = 0; i < m_shared->in_flight.size(); i++)
+	{
+		if (auto socket = m_shared->in_flight[i])
+		{
+			socket->cancel();
+		}
+	}
+}
+
+sock::Task<> sock::FanOut::attempt(
+    std::shared_ptr<Shared> shared,
+    AsyncSocket socket,
+    Address address,
+    size_t index
+)
+{
+	shared->in_flight[index] = &socket;
+	const auto status = co_await socket.async_connect(address);
+	shared->in_flight[index] = nullptr;
+
+	shared->ready.push_back({
+	    .index = index,
+	    .status = status,
+	    .socket = std::move(socket),
+	});
+	shared->remaining--;
+
+	if (auto waiter = std::exchange(shared->waiter, nullptr))
+	{
+		waiter.resume();
+	}
+}
+
+sock::Task<std::optional<sock::FanOut::Result>> sock::FanOut::next()
+{
+	// Keeps the state alive should the awaiting coroutine outlive us.
+	const auto shared = m_shared;
+
+	co_await Wait {*shared};
+
+	if (shared->ready.empty())
+	{
+		co_return std::nullopt;
+	}
+
+	auto result = std::move(shared->ready.front());
+	shared->ready.pop_front();
+
+	co_return result;
+}
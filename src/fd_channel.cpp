@@ -0,0 +1,244 @@
+#include "sock/fd_channel.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// A batch is one datagram: the amount of handoffs, the length of each
+// one's data, then the data itself. Descriptors travel as `SCM_RIGHTS`.
+using Length = uint32_t;
+
+std::pair<sock::FdChannel, sock::FdChannel> sock::FdChannel::pair()
+{
+	int fds[2] {-1, -1};
+
+	if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, fds) < 0)
+	{
+		FdChannel broken;
+		broken.m_status = sock::Status::SOCKET_CREATE_ERROR;
+
+		return {std::move(broken), FdChannel {}};
+	}
+
+	return {FdChannel {fds[0]}, FdChannel {fds[1]}};
+}
+
+sock::FdChannel& sock::FdChannel::operator=(FdChannel&& other)
+{
+	if (this != &other)
+	{
+		close();
+		m_status = other.m_status;
+		m_fd = std::exchange(other.m_fd, -1);
+	}
+
+	return *this;
+}
+
+sock::FdChannel::~FdChannel()
+{
+	close();
+}
+
+void sock::FdChannel::close()
+{
+	if (m_fd >= 0)
+	{
+		::close(m_fd);
+		m_fd = -1;
+	}
+}
+
+sock::FdChannel& sock::FdChannel::non_blocking(bool enable)
+{
+	const auto flags = fcntl(m_fd, F_GETFL, 0);
+
+	if (flags < 0
+	    || fcntl(m_fd, F_SETFL, enable ? flags | O_NONBLOCK : flags & ~O_NONBLOCK)
+	           < 0)
+	{
+		m_status = sock::Status::OPTION_SET_ERROR;
+	}
+
+	return *this;
+}
+
+size_t sock::FdChannel::send(std::span<Handoff> handoffs)
+{
+	size_t sent = 0;
+	std::string message;
+	alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * MAX_BATCH)];
+
+	while (sent < handoffs.size())
+	{
+		const auto batch = std::min(MAX_BATCH, handoffs.size() - sent);
+		const auto chunk = handoffs.subspan(sent, batch);
+
+		const Length count = batch;
+		message.assign(reinterpret_cast<const char*>(&count), sizeof(count));
+
+		for (const auto& handoff : chunk)
+		{
+			const Length size = handoff.data.size();
+			message.append(reinterpret_cast<const char*>(&size), sizeof(size));
+		}
+
+		for (const auto& handoff : chunk)
+		{
+			message += handoff.data;
+		}
+
+		iovec iov {.iov_base = message.data(), .iov_len = message.size()};
+		msghdr msg {};
+		msg.msg_iov = &iov;
+		msg.msg_iovlen = 1;
+		msg.msg_control = control;
+		msg.msg_controllen = CMSG_SPACE(sizeof(int) * batch);
+
+		auto cmsg = CMSG_FIRSTHDR(&msg);
+		cmsg->cmsg_level = SOL_SOCKET;
+		cmsg->cmsg_type = SCM_RIGHTS;
+		cmsg->cmsg_len = CMSG_LEN(sizeof(int) * batch);
+
+		auto fds = reinterpret_cast<int*>(CMSG_DATA(cmsg));
+
+		for (size_t i = 0; i < batch; i++)
+		{
+			const auto fd = chunk[i].socket.native_handle();
+			std::memcpy(fds + i, &fd, sizeof(fd));
+		}
+
+		ssize_t n;
+
+		do
+		{
+			n = sendmsg(m_fd, &msg, MSG_NOSIGNAL);
+		} while (n < 0 && errno == EINTR);
+
+		if (n < 0)
+		{
+			if (errno != EAGAIN)
+			{
+				m_status = sock::Status::SEND_ERROR;
+			}
+
+			break;
+		}
+
+		// The receiver holds its own references now. Closing ours must
+		// not shut the connections down.
+		for (auto& handoff : chunk)
+		{
+			::close(handoff.socket.release());
+		}
+
+		sent += batch;
+	}
+
+	return sent;
+}
+
+size_t sock::FdChannel::receive(std::vector<Handoff>& out)
+{
+	// Learn the size of the next batch without consuming it.
+	ssize_t size;
+
+	do
+	{
+		size = recv(m_fd, nullptr, 0, MSG_PEEK | MSG_TRUNC);
+	} while (size < 0 && errno == EINTR);
+
+	if (size <= 0)
+	{
+		if (size < 0 && errno != EAGAIN)
+		{
+			m_status = sock::Status::RECEIVE_ERROR;
+		}
+
+		return 0;
+	}
+
+	std::string message(size, '\0');
+	alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * MAX_BATCH)];
+
+	iovec iov {.iov_base = message.data(), .iov_len = message.size()};
+	msghdr msg {};
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control;
+	msg.msg_controllen = sizeof(control);
+
+	ssize_t n;
+
+	do
+	{
+		n = recvmsg(m_fd, &msg, MSG_CMSG_CLOEXEC);
+	} while (n < 0 && errno == EINTR);
+
+	if (n <= 0)
+	{
+		m_status = sock::Status::RECEIVE_ERROR;
+
+		return 0;
+	}
+
+	std::vector<int> fds;
+
+	for (auto cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr;
+	     cmsg = CMSG_NXTHDR(&msg, cmsg))
+	{
+		if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+		{
+			const auto count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+			const auto begin = fds.size();
+			fds.resize(begin + count);
+			std::memcpy(fds.data() + begin, CMSG_DATA(cmsg), count * sizeof(int));
+		}
+	}
+
+	Length count = 0;
+
+	if (static_cast<size_t>(n) >= sizeof(count))
+	{
+		std::memcpy(&count, message.data(), sizeof(count));
+	}
+
+	const auto header = sizeof(Length) * (1 + size_t {count});
+
+	if ((msg.msg_flags & (MSG_CTRUNC | MSG_TRUNC)) != 0 || count != fds.size()
+	    || static_cast<size_t>(n) < header)
+	{
+		for (const auto fd : fds)
+		{
+			::close(fd);
+		}
+
+		m_status = sock::Status::RECEIVE_ERROR;
+
+		return 0;
+	}
+
+	size_t offset = header;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		Length length;
+		std::memcpy(
+		    &length,
+		    message.data() + sizeof(Length) * (1 + i),
+		    sizeof(length)
+		);
+		length = std::min<size_t>(length, n - std::min<size_t>(offset, n));
+
+		out.push_back({
+		    .socket = sock::Socket {fds[i]},
+		    .data = message.substr(offset, length),
+		});
+		offset += length;
+	}
+
+	return count;
+}
@@ -0,0 +1,235 @@
+#include "sock/framing.hpp"
+#include <algorithm>
+
+auto sock::FrameEncoder::header(size_t size, char* out) const -> size_t
+{
+	switch (m_prefix)
+	{
+		case Prefix::U16:
+			if (size > 0xffff)
+			{
+				return 0;
+			}
+
+			out[0] = static_cast<char>(size >> 8);
+			out[1] = static_cast<char>(size);
+
+			return 2;
+		case Prefix::U32:
+			if (size > 0xffffffff)
+			{
+				return 0;
+			}
+
+			out[0] = static_cast<char>(size >> 24);
+			out[1] = static_cast<char>(size >> 16);
+			out[2] = static_cast<char>(size >> 8);
+			out[3] = static_cast<char>(size);
+
+			return 4;
+		case Prefix::VARINT:
+		{
+			size_t n = 0;
+
+			while (size >= 0x80)
+			{
+				out[n++] = static_cast<char>((size & 0x7f) | 0x80);
+				size >>= 7;
+			}
+
+			out[n++] = static_cast<char>(size);
+
+			return n;
+		}
+	}
+
+	return 0;
+}
+
+auto sock::FrameEncoder::encode(std::string_view payload, std::string& out) const
+    -> Status
+{
+	char prefix[MAX_HEADER];
+	const auto length = header(payload.size(), prefix);
+
+	if (length == 0)
+	{
+		return Status::FRAME_ERROR;
+	}
+
+	out.reserve(out.size() + length + payload.size());
+	out.append(prefix, length);
+	out.append(payload);
+
+	return Status::GOOD;
+}
+
+auto sock::FrameDecoder::measure(std::string_view bytes)
+    -> std::optional<std::pair<size_t, size_t>>
+{
+	const auto in = reinterpret_cast<const uint8_t*>(bytes.data());
+	size_t header = 0;
+	uint64_t size = 0;
+
+	switch (m_prefix)
+	{
+		case Prefix::U16:
+			if (bytes.size() < 2)
+			{
+				return std::nullopt;
+			}
+
+			header = 2;
+			size = (uint64_t {in[0]} << 8) | in[1];
+			break;
+		case Prefix::U32:
+			if (bytes.size() < 4)
+			{
+				return std::nullopt;
+			}
+
+			header = 4;
+			size = (uint64_t {in[0]} << 24) | (uint64_t {in[1]} << 16)
+			    | (uint64_t {in[2]} << 8) | in[3];
+			break;
+		case Prefix::VARINT:
+			for (; header < FrameEncoder::MAX_HEADER; header++)
+			{
+				if (header == bytes.size())
+				{
+					return std::nullopt;
+				}
+
+				// The tenth byte holds the 64th bit only.
+				if (header == FrameEncoder::MAX_HEADER - 1 && in[header] > 1)
+				{
+					m_status = Status::FRAME_ERROR;
+					return std::nullopt;
+				}
+
+				size |= uint64_t {in[header] & 0x7fu} << (7 * header);
+
+				if ((in[header] & 0x80) == 0)
+				{
+					break;
+				}
+			}
+
+			if (header++ == FrameEncoder::MAX_HEADER)
+			{
+				m_status = Status::FRAME_ERROR;
+				return std::nullopt;
+			}
+
+			break;
+	}
+
+	if (size > m_max_frame)
+	{
+		m_status = Status::FRAME_ERROR;
+		return std::nullopt;
+	}
+
+	return std::pair {header, static_cast<size_t>(size)};
+}
+
+auto sock::FrameDecoder::feed(std::string_view bytes) -> FrameDecoder&
+{
+	m_input = bytes;
+	m_offset = 0;
+	m_assembled_ready = false;
+
+	// Completes the frame the previous reads ended in, byte by byte
+	// while its header is incomplete, at once afterwards.
+	while (!m_partial.empty() && m_status == Status::GOOD)
+	{
+		if (const auto measured = measure(m_partial))
+		{
+			const auto [header, size] = *measured;
+			const auto take = std::min(
+			    header + size - m_partial.size(),
+			    m_input.size() - m_offset
+			);
+
+			m_partial.append(m_input.substr(m_offset, take));
+			m_offset += take;
+
+			if (m_partial.size() == header + size)
+			{
+				m_assembled.swap(m_partial);
+				m_partial.clear();
+				m_assembled_header = header;
+				m_assembled_ready = true;
+			}
+
+			break;
+		}
+
+		if (m_offset == m_input.size())
+		{
+			break;
+		}
+
+		m_partial.push_back(m_input[m_offset++]);
+	}
+
+	return *this;
+}
+
+auto sock::FrameDecoder::next() -> std::optional<std::string_view>
+{
+	if (m_status != Status::GOOD)
+	{
+		return std::nullopt;
+	}
+
+	if (m_assembled_ready)
+	{
+		m_assembled_ready = false;
+
+		return std::string_view {m_assembled}.substr(m_assembled_header);
+	}
+
+	const auto rest = m_input.substr(m_offset);
+
+	if (!m_partial.empty() || rest.empty())
+	{
+		return std::nullopt;
+	}
+
+	const auto measured = measure(rest);
+
+	if (m_status != Status::GOOD)
+	{
+		return std::nullopt;
+	}
+
+	if (measured && measured->first + measured->second <= rest.size())
+	{
+		const auto [header, size] = *measured;
+		m_offset += header + size;
+
+		return rest.substr(header, size);
+	}
+
+	// Kept until the rest arrives, the fed bytes may be gone by then.
+	if (measured)
+	{
+		m_partial.reserve(measured->first + measured->second);
+	}
+
+	m_partial.assign(rest);
+	m_offset = m_input.size();
+
+	return std::nullopt;
+}
+
+auto sock::FrameDecoder::reset() -> void
+{
+	m_status = Status::GOOD;
+	m_input = {};
+	m_offset = 0;
+	m_partial.clear();
+	m_assembled.clear();
+	m_assembled_ready = false;
+}
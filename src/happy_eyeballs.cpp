@@ -0,0 +1,263 @@
+#include "sock/happy_eyeballs.hpp"
+#include <algorithm>
+#include <coroutine>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace
+{
+	struct Race
+	{
+		std::vector<sock::AsyncSocket*> in_flight;
+		std::optional<sock::Connected> winner;
+		size_t running {0};
+		sock::Status last {sock::Status::CONNECT_ERROR};
+		std::coroutine_handle<> waiter {nullptr};
+	};
+
+	/**
+	 * Waits until an attempt finishes, or for at most `delay` unless it
+	 * is negative.
+	 */
+	struct Outcome
+	{
+		std::shared_ptr<Race> race;
+		sock::Reactor& reactor;
+		std::chrono::milliseconds delay;
+		sock::Reactor::TimerId timer {0};
+
+		auto await_ready() const noexcept -> bool
+		{
+			return race->winner || race->running == 0;
+		}
+
+		auto await_suspend(std::coroutine_handle<> handle) -> void
+		{
+			race->waiter = handle;
+
+			if (delay.count() >= 0)
+			{
+				timer = reactor.after(
+				    delay,
+				    [race = race]()
+				    {
+					    if (auto waiter = std::exchange(race->waiter, nullptr))
+					    {
+						    waiter.resume();
+					    }
+				    }
+				);
+			}
+		}
+
+		auto await_resume() const noexcept -> void
+		{}
+
+		~Outcome()
+		{
+			race->waiter = nullptr;
+
+			if (timer != 0)
+			{
+				reactor.cancel(timer);
+			}
+		}
+	};
+
+	/**
+	 * Cancels the attempts still in flight once the race is over, or
+	 * abandoned along with the awaiting coroutine.
+	 */
+	struct Finish
+	{
+		std::shared_ptr<Race> race;
+
+		~Finish()
+		{
+			// Cancelled attempts finish synchronously and clear their slot.
+			for (size_t i = 0; i < race->in_flight.size(); i++)
+			{
+				if (auto socket = race->in_flight[i])
+				{
+					socket->cancel();
+				}
+			}
+		}
+	};
+} // namespace
+
+static auto attempt(
+    std::shared_ptr<Race> race,
+    sock::AsyncSocket socket,
+    sock::Endpoint endpoint,
+    size_t index
+) -> sock::Task<>
+{
+	race->in_flight[index] = &socket;
+	const auto status = co_await socket.async_connect(endpoint);
+	race->in_flight[index] = nullptr;
+	race->running--;
+
+	if (status == sock::Status::GOOD && !race->winner)
+	{
+		race->winner.emplace(sock::Connected {
+		    .status = status,
+		    .socket = std::move(socket),
+		    .endpoint = endpoint,
+		});
+	}
+	else if (status != sock::Status::GOOD && status != sock::Status::CANCELLED)
+	{
+		race->last = status;
+	}
+
+	if (auto waiter = std::exchange(race->waiter, nullptr))
+	{
+		waiter.resume();
+	}
+}
+
+/**
+ * RFC 8305 section 4: alternates address families, keeping the order
+ * within each family.
+ */
+static auto interleave(std::vector<sock::Endpoint> endpoints)
+    -> std::vector<sock::Endpoint>
+{
+	if (endpoints.empty())
+	{
+		return endpoints;
+	}
+
+	const auto preferred = endpoints.front().family();
+	std::vector<sock::Endpoint> first;
+	std::vector<sock::Endpoint> second;
+
+	for (auto& endpoint : endpoints)
+	{
+		(endpoint.family() == preferred ? first : second).push_back(endpoint);
+	}
+
+	std::vector<sock::Endpoint> order;
+	order.reserve(endpoints.size());
+
+	for (size_t i = 0; i < std::max(first.size(), second.size()); i++)
+	{
+		if (i < first.size())
+		{
+			order.push_back(first[i]);
+		}
+
+		if (i < second.size())
+		{
+			order.push_back(second[i]);
+		}
+	}
+
+	return order;
+}
+
+static auto failed(sock::Reactor& reactor, sock::Status status) -> sock::Connected
+{
+	return {
+	    .status = status,
+	    .socket = sock::AsyncSocket {reactor, sock::Socket {-1}},
+	    .endpoint = {},
+	};
+}
+
+sock::Task<sock::Connected> sock::happy_eyeballs(
+    Reactor& reactor,
+    CtorArgs args,
+    std::vector<Endpoint> endpoints,
+    HappyEyeballsOptions options
+)
+{
+	const auto order = interleave(std::move(endpoints));
+
+	if (order.empty())
+	{
+		co_return failed(reactor, sock::Status::CONNECT_ERROR);
+	}
+
+	const auto race = std::make_shared<Race>();
+	race->in_flight.resize(order.size(), nullptr);
+
+	const Finish finish {race};
+	size_t next = 0;
+
+	while (!race->winner && (next < order.size() || race->running > 0))
+	{
+		if (next < order.size())
+		{
+			AsyncSocket socket {
+			    reactor,
+			    CtorArgs {
+			        .domain = order[next].family() == AF_INET6
+			            ? Domain::INET6
+			            : Domain::INET,
+			        .type = args.type,
+			        .protocol = args.protocol,
+			        .flags = args.flags,
+			    }};
+			socket.timeout(options.timeout);
+
+			race->running++;
+			sock::spawn(attempt(race, std::move(socket), order[next], next));
+			next++;
+		}
+
+		co_await Outcome {
+		    race,
+		    reactor,
+		    next < order.size() ? options.attempt_delay
+		                        : std::chrono::milliseconds {-1}};
+	}
+
+	if (race->winner)
+	{
+		co_return std::move(*race->winner);
+	}
+
+	co_return failed(reactor, race->last);
+}
+
+static auto resolve_and_race(
+    sock::Reactor& reactor,
+    sock::Task<sock::Resolution> resolving,
+    sock::CtorArgs args,
+    sock::HappyEyeballsOptions options
+) -> sock::Task<sock::Connected>
+{
+	auto resolution = co_await std::move(resolving);
+
+	if (resolution.status != sock::Status::GOOD)
+	{
+		co_return failed(reactor, resolution.status);
+	}
+
+	co_return co_await sock::happy_eyeballs(
+	    reactor,
+	    args,
+	    std::move(resolution.endpoints),
+	    options
+	);
+}
+
+sock::Task<sock::Connected> sock::happy_eyeballs(
+    Reactor& reactor,
+    Resolver& resolver,
+    CtorArgs args,
+    Address address,
+    HappyEyeballsOptions options
+)
+{
+	// Not a coroutine itself, the resolver copies `address` right away.
+	return resolve_and_race(
+	    reactor,
+	    resolver.resolve(args, address),
+	    args,
+	    options
+	);
+}
@@ -0,0 +1,254 @@
+#include "sock/hedger.hpp"
+#include <algorithm>
+#include <cmath>
+#include <coroutine>
+#include <memory>
+#include <optional>
+#include <utility>
+
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+	struct Race
+	{
+		std::string payload;
+		sock::AsyncSocket* sockets[2] {nullptr, nullptr};
+		bool running[2] {false, false};
+		Clock::time_point started[2] {};
+
+		std::optional<size_t> winner;
+		std::string reply;
+		sock::Status last {sock::Status::RECEIVE_ERROR};
+		std::coroutine_handle<> waiter {nullptr};
+
+		auto done() const -> bool
+		{
+			return winner || (!running[0] && !running[1]);
+		}
+	};
+
+	/**
+	 * Waits until an exchange finishes, or for at most `delay` unless it
+	 * is negative.
+	 */
+	struct Outcome
+	{
+		std::shared_ptr<Race> race;
+		sock::Reactor& reactor;
+		std::chrono::milliseconds delay;
+		sock::Reactor::TimerId timer {0};
+
+		auto await_ready() const noexcept -> bool
+		{
+			return race->done();
+		}
+
+		auto await_suspend(std::coroutine_handle<> handle) -> void
+		{
+			race->waiter = handle;
+
+			if (delay.count() >= 0)
+			{
+				timer = reactor.after(
+				    delay,
+				    [race = race]()
+				    {
+					    if (auto waiter = std::exchange(race->waiter, nullptr))
+					    {
+						    waiter.resume();
+					    }
+				    }
+				);
+			}
+		}
+
+		auto await_resume() const noexcept -> void
+		{}
+
+		~Outcome()
+		{
+			race->waiter = nullptr;
+
+			if (timer != 0)
+			{
+				reactor.cancel(timer);
+			}
+		}
+	};
+} // namespace
+
+static auto send_and_receive(std::shared_ptr<Race> race, size_t index)
+    -> sock::Task<>
+{
+	auto& socket = *race->sockets[index];
+	race->running[index] = true;
+	race->started[index] = Clock::now();
+
+	auto status = co_await socket.async_send(race->payload);
+	sock::Buffer buff;
+
+	if (status == sock::Status::GOOD)
+	{
+		status = co_await socket.async_receive(buff);
+	}
+
+	race->running[index] = false;
+
+	if (status == sock::Status::GOOD && buff.received_size() > 0)
+	{
+		if (!race->winner)
+		{
+			race->winner = index;
+			race->reply.assign(buff.view());
+		}
+	}
+	else if (status != sock::Status::CANCELLED)
+	{
+		// Zero bytes: the peer closed the connection instead.
+		race->last =
+		    status == sock::Status::GOOD ? sock::Status::RECEIVE_ERROR : status;
+	}
+
+	if (auto waiter = std::exchange(race->waiter, nullptr))
+	{
+		waiter.resume();
+	}
+}
+
+sock::Hedger::Hedger(Reactor& reactor, HedgeOptions options) :
+    m_reactor {reactor},
+    m_options {options},
+    m_delay {options.initial_delay}
+{
+	m_samples.reserve(m_options.window);
+}
+
+auto sock::Hedger::request(
+    AsyncSocket& primary,
+    AsyncSocket& backup,
+    std::string_view payload
+) -> Task<Hedged>
+{
+	// Tasks start lazily, `payload` may be gone by then.
+	return exchange(primary, backup, std::string {payload});
+}
+
+auto sock::Hedger::exchange(
+    AsyncSocket& primary,
+    AsyncSocket& backup,
+    std::string payload
+) -> Task<Hedged>
+{
+	m_metrics.requests++;
+	// A few hedges may be saved up for a burst of slow replies.
+	m_tokens = std::min(m_tokens + m_options.budget, 10.0);
+
+	const auto race = std::make_shared<Race>();
+	race->payload = std::move(payload);
+	race->sockets[0] = &primary;
+	race->sockets[1] = &backup;
+
+	sock::spawn(send_and_receive(race, 0));
+	co_await Outcome {race, m_reactor, delay()};
+
+	bool hedged = false;
+
+	// Slow or failed: one more try on the backup.
+	if (!race->winner)
+	{
+		if (m_tokens >= 1.0)
+		{
+			m_tokens -= 1.0;
+			m_metrics.hedged++;
+			hedged = true;
+			sock::spawn(send_and_receive(race, 1));
+		}
+		else
+		{
+			m_metrics.denied++;
+		}
+	}
+
+	while (!race->done())
+	{
+		co_await Outcome {race, m_reactor, std::chrono::milliseconds {-1}};
+	}
+
+	// Cancelled exchanges finish synchronously.
+	for (size_t i = 0; i < 2; i++)
+	{
+		if (race->running[i])
+		{
+			race->sockets[i]->cancel();
+		}
+	}
+
+	if (!race->winner)
+	{
+		co_return Hedged {
+		    .status = race->last,
+		    .reply = {},
+		    .winner = 0,
+		    .hedged = hedged,
+		};
+	}
+
+	const auto winner = *race->winner;
+	m_metrics.backup_wins += winner == 1;
+	record(std::chrono::duration_cast<std::chrono::microseconds>(
+	    Clock::now() - race->started[winner]
+	));
+
+	co_return Hedged {
+	    .status = Status::GOOD,
+	    .reply = std::move(race->reply),
+	    .winner = winner,
+	    .hedged = hedged,
+	};
+}
+
+auto sock::Hedger::record(std::chrono::microseconds latency) -> void
+{
+	if (m_samples.size() < m_options.window)
+	{
+		m_samples.push_back(latency);
+	}
+	else
+	{
+		m_samples[m_next_sample] = latency;
+		m_next_sample = (m_next_sample + 1) % m_options.window;
+	}
+
+	m_since_update++;
+}
+
+auto sock::Hedger::delay() -> std::chrono::milliseconds
+{
+	if (m_samples.size() < m_options.min_samples)
+	{
+		return m_options.initial_delay;
+	}
+
+	// Selecting the percentile costs a pass over the window, only done
+	// once a sixteenth of it was replaced.
+	if (m_since_update >= std::max<size_t>(m_samples.size() / 16, 1))
+	{
+		m_since_update = 0;
+
+		auto sorted = m_samples;
+		const auto rank = static_cast<size_t>(
+		    std::ceil(m_options.percentile * sorted.size())
+		);
+		const auto nth = sorted.begin()
+		    + std::clamp<size_t>(rank, 1, sorted.size()) - 1;
+		std::nth_element(sorted.begin(), nth, sorted.end());
+
+		m_delay = std::max(
+		    m_options.min_delay,
+		    std::chrono::ceil<std::chrono::milliseconds>(*nth)
+		);
+	}
+
+	return m_delay;
+}
@@ -0,0 +1,635 @@
+#include "sock/http.hpp"
+#include "sock/records.hpp"
+#include <array>
+#include <charconv>
+
+static constexpr auto npos = std::string_view::npos;
+
+// Responses of one read leave together, at most this many at a time.
+static constexpr size_t MAX_BATCH = 64;
+
+/**
+ * `tchar` of RFC 9110, what methods and header names are made of.
+ */
+static constexpr auto TOKEN = []()
+{
+	std::array<bool, 256> table {};
+
+	for (int c = '0'; c <= '9'; c++)
+	{
+		table[c] = true;
+	}
+
+	for (int c = 'a'; c <= 'z'; c++)
+	{
+		table[c] = true;
+		table[c - 'a' + 'A'] = true;
+	}
+
+	for (const auto c : std::string_view {"!#$%&'*+-.^_`|~"})
+	{
+		table[static_cast<unsigned char>(c)] = true;
+	}
+
+	return table;
+}();
+
+static auto is_token(std::string_view bytes) -> bool
+{
+	for (const auto c : bytes)
+	{
+		if (!TOKEN[static_cast<unsigned char>(c)])
+		{
+			return false;
+		}
+	}
+
+	return !bytes.empty();
+}
+
+static auto is_target(std::string_view bytes) -> bool
+{
+	for (const auto c : bytes)
+	{
+		if (static_cast<unsigned char>(c) <= ' ' || c == '\x7f')
+		{
+			return false;
+		}
+	}
+
+	return !bytes.empty();
+}
+
+static auto lower(char c) -> char
+{
+	return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+}
+
+static auto iequals(std::string_view a, std::string_view b) -> bool
+{
+	if (a.size() != b.size())
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < a.size(); i++)
+	{
+		if (lower(a[i]) != lower(b[i]))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static auto trim(std::string_view value) -> std::string_view
+{
+	const auto first = value.find_first_not_of(" \t");
+
+	if (first == npos)
+	{
+		return {};
+	}
+
+	return value.substr(first, value.find_last_not_of(" \t") - first + 1);
+}
+
+/**
+ * Whether the comma separated `list` has `token`, as in `Connection`.
+ */
+static auto has_token(std::string_view list, std::string_view token) -> bool
+{
+	while (!list.empty())
+	{
+		const auto comma = list.find(',');
+
+		if (iequals(trim(list.substr(0, comma)), token))
+		{
+			return true;
+		}
+
+		list = comma == npos ? std::string_view {} : list.substr(comma + 1);
+	}
+
+	return false;
+}
+
+static auto reason(int status) -> std::string_view
+{
+	switch (status)
+	{
+		case 100:
+			return "Continue";
+		case 200:
+			return "OK";
+		case 201:
+			return "Created";
+		case 204:
+			return "No Content";
+		case 301:
+			return "Moved Permanently";
+		case 302:
+			return "Found";
+		case 304:
+			return "Not Modified";
+		case 400:
+			return "Bad Request";
+		case 403:
+			return "Forbidden";
+		case 404:
+			return "Not Found";
+		case 405:
+			return "Method Not Allowed";
+		case 413:
+			return "Content Too Large";
+		case 431:
+			return "Request Header Fields Too Large";
+		case 500:
+			return "Internal Server Error";
+		case 501:
+			return "Not Implemented";
+		case 503:
+			return "Service Unavailable";
+		case 505:
+			return "HTTP Version Not Supported";
+	}
+
+	return "Unknown";
+}
+
+auto sock::HttpRequest::header(std::string_view name) const
+    -> std::optional<std::string_view>
+{
+	for (const auto& header : headers)
+	{
+		if (iequals(header.name, name))
+		{
+			return header.value;
+		}
+	}
+
+	return std::nullopt;
+}
+
+auto sock::HttpParser::fail(int error) -> size_t
+{
+	m_error = error;
+
+	return 0;
+}
+
+auto sock::HttpParser::parse_head(std::string_view head, HttpRequest& request)
+    -> bool
+{
+	request.headers.clear();
+	request.body = {};
+
+	// `head` ends in the line break of its last line.
+	auto eol = find_delimiter(head, "\r\n");
+	const auto line = head.substr(0, eol);
+
+	const auto space = line.find(' ');
+	const auto second = space == npos ? npos : line.find(' ', space + 1);
+
+	if (second == npos)
+	{
+		fail(400);
+		return false;
+	}
+
+	request.method = line.substr(0, space);
+	request.target = line.substr(space + 1, second - space - 1);
+	const auto version = line.substr(second + 1);
+
+	if (!is_token(request.method) || !is_target(request.target))
+	{
+		fail(400);
+		return false;
+	}
+
+	if (version.size() != 8 || !version.starts_with("HTTP/1.")
+	    || (version[7] != '0' && version[7] != '1'))
+	{
+		fail(version.starts_with("HTTP/") ? 505 : 400);
+		return false;
+	}
+
+	request.minor_version = version[7] - '0';
+
+	for (auto at = eol + 2; at < head.size(); at += eol + 2)
+	{
+		eol = find_delimiter(head.substr(at), "\r\n");
+		const auto field = head.substr(at, eol);
+		const auto colon = find_delimiter(field, ":");
+
+		// Also rejects obsolete line folding, which starts with a space.
+		if (colon == npos || !is_token(field.substr(0, colon)))
+		{
+			fail(400);
+			return false;
+		}
+
+		if (request.headers.size() == m_limits.max_headers)
+		{
+			fail(431);
+			return false;
+		}
+
+		request.headers.push_back(
+		    {.name = field.substr(0, colon), .value = trim(field.substr(colon + 1))}
+		);
+	}
+
+	const auto connection = request.header("Connection");
+
+	request.keep_alive = request.minor_version == 1
+	    ? !(connection && has_token(*connection, "close"))
+	    : connection && has_token(*connection, "keep-alive");
+
+	return true;
+}
+
+auto sock::HttpParser::parse_chunks(std::string_view bytes, bool gather)
+    -> size_t
+{
+	size_t at = 0;
+	size_t total = 0;
+
+	if (gather)
+	{
+		m_body.clear();
+	}
+
+	while (true)
+	{
+		const auto eol = find_delimiter(bytes.substr(at), "\r\n");
+
+		if (eol == npos)
+		{
+			return bytes.size() - at > m_limits.max_head ? fail(400) : 0;
+		}
+
+		const auto line = bytes.substr(at, eol);
+		size_t size = 0;
+		const auto [end, error] =
+		    std::from_chars(line.data(), line.data() + line.size(), size, 16);
+
+		if (error == std::errc::result_out_of_range)
+		{
+			return fail(413);
+		}
+
+		// Chunk extensions are ignored.
+		if (error != std::errc {} || (end != line.data() + line.size()
+		                              && *end != ';' && *end != ' ' && *end != '\t'))
+		{
+			return fail(400);
+		}
+
+		at += eol + 2;
+
+		if (size == 0)
+		{
+			break;
+		}
+
+		total += size;
+
+		if (total > m_limits.max_body)
+		{
+			return fail(413);
+		}
+
+		if (bytes.size() - at < size + 2)
+		{
+			return 0;
+		}
+
+		if (bytes.substr(at + size, 2) != "\r\n")
+		{
+			return fail(400);
+		}
+
+		if (gather)
+		{
+			m_body.append(bytes.substr(at, size));
+		}
+
+		at += size + 2;
+	}
+
+	// Trailer fields, ignored as well, up to an empty line.
+	const auto trailers = at;
+
+	while (true)
+	{
+		const auto eol = find_delimiter(bytes.substr(at), "\r\n");
+
+		if (eol == npos)
+		{
+			return bytes.size() - trailers > m_limits.max_head ? fail(431) : 0;
+		}
+
+		at += eol + 2;
+
+		if (eol == 0)
+		{
+			return at;
+		}
+	}
+}
+
+auto sock::HttpParser::parse(std::string_view bytes, HttpRequest& request)
+    -> size_t
+{
+	m_expects_continue = false;
+
+	if (m_error != 0)
+	{
+		return 0;
+	}
+
+	const auto blank = find_delimiter(bytes, "\r\n\r\n");
+
+	if (blank == npos)
+	{
+		return bytes.size() > m_limits.max_head ? fail(431) : 0;
+	}
+
+	const auto head_size = blank + 4;
+
+	if (head_size > m_limits.max_head)
+	{
+		return fail(431);
+	}
+
+	if (!parse_head(bytes.substr(0, blank + 2), request))
+	{
+		return 0;
+	}
+
+	std::optional<std::string_view> encoding;
+	std::optional<std::string_view> length;
+
+	for (const auto& header : request.headers)
+	{
+		if (iequals(header.name, "Transfer-Encoding"))
+		{
+			encoding = header.value;
+		}
+		else if (iequals(header.name, "Content-Length"))
+		{
+			// Disagreeing lengths are how requests get smuggled.
+			if (length && *length != header.value)
+			{
+				return fail(400);
+			}
+
+			length = header.value;
+		}
+	}
+
+	const auto expect = request.header("Expect");
+	const auto continues =
+	    request.minor_version == 1 && expect && iequals(*expect, "100-continue");
+	const auto rest = bytes.substr(head_size);
+
+	if (encoding)
+	{
+		// Only chunked is understood, and it must come last.
+		const auto comma = encoding->rfind(',');
+		const auto last =
+		    trim(comma == npos ? *encoding : encoding->substr(comma + 1));
+
+		if (length || !iequals(last, "chunked"))
+		{
+			return fail(comma == npos && !length ? 501 : 400);
+		}
+
+		const auto size = parse_chunks(rest, false);
+
+		if (size == 0)
+		{
+			m_expects_continue = m_error == 0 && continues;
+			return 0;
+		}
+
+		parse_chunks(rest, true);
+		request.body = m_body;
+
+		return head_size + size;
+	}
+
+	size_t size = 0;
+
+	if (length)
+	{
+		const auto [end, error] =
+		    std::from_chars(length->data(), length->data() + length->size(), size);
+
+		if (error == std::errc::result_out_of_range)
+		{
+			return fail(413);
+		}
+
+		if (error != std::errc {} || end != length->data() + length->size())
+		{
+			return fail(400);
+		}
+
+		if (size > m_limits.max_body)
+		{
+			return fail(413);
+		}
+	}
+
+	if (rest.size() < size)
+	{
+		m_expects_continue = continues;
+		return 0;
+	}
+
+	request.body = rest.substr(0, size);
+
+	return head_size + size;
+}
+
+struct sock::HttpServer::Session
+{
+	explicit Session(HttpLimits limits) :
+	    parser {limits}
+	{}
+
+	HttpParser parser;
+	HttpRequest request;
+	bool continued {false};
+
+	// Response heads and bodies of one read, in the order they are sent.
+	std::vector<std::string> output;
+	std::vector<std::string_view> pieces;
+	size_t responses {0};
+};
+
+sock::HttpServer::HttpServer(Handler handler, HttpLimits limits) :
+    m_handler {std::move(handler)},
+    m_limits {limits}
+{}
+
+auto sock::HttpServer::serve(Core& core, sock::Socket&& accepted) -> void
+{
+	auto session = std::make_shared<Session>(m_limits);
+	auto connection = std::make_shared<Connection>(
+	    std::move(accepted),
+	    [this, session](Connection& conn)
+	    {
+		    on_input(*session, conn);
+	    }
+	);
+
+	// Requests left unread while the output was congested.
+	connection->on_drained(
+	    [this, session](Connection& conn)
+	    {
+		    on_input(*session, conn);
+	    }
+	);
+	core.adopt(std::move(connection));
+}
+
+static auto respond(
+    std::vector<std::string>& output,
+    sock::HttpResponse& response,
+    int minor_version,
+    bool keep_alive,
+    bool head_only
+) -> void
+{
+	char number[24];
+	auto& head = output.emplace_back();
+	head.reserve(96 + response.headers.size());
+
+	head.append("HTTP/1.1 ");
+	head.append(number, std::to_chars(number, number + sizeof(number), response.status).ptr);
+	head.push_back(' ');
+	head.append(reason(response.status));
+	head.append("\r\n");
+
+	const auto has_body =
+	    response.status >= 200 && response.status != 204 && response.status != 304;
+
+	if (has_body)
+	{
+		head.append("Content-Length: ");
+		head.append(
+		    number,
+		    std::to_chars(number, number + sizeof(number), response.body.size()).ptr
+		);
+		head.append("\r\n");
+	}
+
+	head.append(response.headers);
+
+	if (!keep_alive)
+	{
+		head.append("Connection: close\r\n");
+	}
+	else if (minor_version == 0)
+	{
+		head.append("Connection: keep-alive\r\n");
+	}
+
+	head.append("\r\n");
+
+	// Sent as it is, next to the head.
+	if (has_body && !head_only && !response.body.empty())
+	{
+		output.push_back(std::move(response.body));
+	}
+}
+
+static auto flush(
+    std::vector<std::string>& output,
+    std::vector<std::string_view>& pieces,
+    sock::Connection& conn
+) -> void
+{
+	// Views are taken only now, growing `output` moves short strings.
+	pieces.assign(output.begin(), output.end());
+	conn.write(pieces);
+	output.clear();
+}
+
+auto sock::HttpServer::on_input(Session& session, Connection& conn) -> void
+{
+	const std::string_view input {conn.input()};
+	size_t offset = 0;
+	bool closing = false;
+
+	while (!closing && !conn.congested() && offset < input.size())
+	{
+		const auto size = session.parser.parse(input.substr(offset), session.request);
+
+		if (size == 0 && session.parser.status() != Status::GOOD)
+		{
+			m_metrics.rejected.fetch_add(1, std::memory_order_relaxed);
+
+			HttpResponse response;
+			response.status = session.parser.error();
+			respond(session.output, response, 1, false, false);
+			closing = true;
+			session.responses++;
+			break;
+		}
+
+		if (size == 0)
+		{
+			if (session.parser.expects_continue() && !session.continued)
+			{
+				session.continued = true;
+				session.output.emplace_back("HTTP/1.1 100 Continue\r\n\r\n");
+				session.responses++;
+			}
+
+			break;
+		}
+
+		offset += size;
+		session.continued = false;
+		m_metrics.requests.fetch_add(1, std::memory_order_relaxed);
+
+		const auto& request = session.request;
+		HttpResponse response;
+		m_handler(request, response);
+
+		closing = !request.keep_alive;
+		respond(
+		    session.output,
+		    response,
+		    request.minor_version,
+		    request.keep_alive,
+		    request.method == "HEAD"
+		);
+
+		if (++session.responses == MAX_BATCH)
+		{
+			flush(session.output, session.pieces, conn);
+			m_metrics.writes.fetch_add(1, std::memory_order_relaxed);
+			session.responses = 0;
+		}
+	}
+
+	if (session.responses > 0)
+	{
+		flush(session.output, session.pieces, conn);
+		m_metrics.writes.fetch_add(1, std::memory_order_relaxed);
+		session.responses = 0;
+	}
+
+	conn.input().erase(0, offset);
+
+	if (closing)
+	{
+		conn.finish();
+	}
+}
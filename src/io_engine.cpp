@@ -0,0 +1,53 @@
+#include "sock/io_engine.hpp"
+#include "sock/internal/epoll_engine.hpp"
+#include "sock/internal/uring_engine.hpp"
+#include <cstdlib>
+#include <string_view>
+
+static auto engine_from_environment() -> sock::Engine
+{
+	const auto value = std::getenv("SOCK_IO_ENGINE");
+
+	if (value == nullptr)
+	{
+		return sock::Engine::AUTO;
+	}
+
+	const std::string_view name {value};
+
+	if (name == sock::str_engine(sock::Engine::IO_URING))
+	{
+		return sock::Engine::IO_URING;
+	}
+
+	if (name == sock::str_engine(sock::Engine::EPOLL))
+	{
+		return sock::Engine::EPOLL;
+	}
+
+	return sock::Engine::AUTO;
+}
+
+std::unique_ptr<sock::IoEngine>
+    sock::make_io_engine(sock::Engine engine, sock::EngineOptions options)
+{
+	if (engine == sock::Engine::AUTO)
+	{
+		engine = engine_from_environment();
+	}
+
+	if (engine == sock::Engine::EPOLL)
+	{
+		return std::make_unique<sock::internal::EpollEngine>(options);
+	}
+
+	auto uring = std::make_unique<sock::internal::UringEngine>(options);
+
+	if (uring->status() == sock::Status::GOOD
+	    || engine == sock::Engine::IO_URING)
+	{
+		return uring;
+	}
+
+	return std::make_unique<sock::internal::EpollEngine>(options);
+}
@@ -0,0 +1,66 @@
+#include "sock/listener_group.hpp"
+#include <linux/filter.h>
+#include <sys/socket.h>
+
+sock::ListenerGroup::ListenerGroup(
+    CtorArgs args,
+    sock::Address address,
+    size_t size,
+    ListenerGroupOptions options
+)
+{
+	m_listeners.reserve(size);
+
+	// The kernel numbers group members in the order they start listening,
+	// that order is what the steering program indexes.
+	for (size_t i = 0; i < size; i++)
+	{
+		auto& listener = m_listeners.emplace_back(args);
+
+		listener.option(sock::Option::REUSEADDR, 1)
+		    .option(sock::Option::REUSEPORT, 1)
+		    .bind(address)
+		    .listen(options.backlog);
+
+		if (listener.status() != Status::GOOD)
+		{
+			m_status = listener.status();
+			return;
+		}
+	}
+
+	if (options.steer_by_cpu && size > 0)
+	{
+		steer_by_cpu();
+	}
+}
+
+void sock::ListenerGroup::steer_by_cpu()
+{
+	// A = current CPU; A %= size; return A
+	sock_filter code[] = {
+	    {BPF_LD | BPF_W | BPF_ABS,
+	     0,
+	     0,
+	     static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU)},
+	    {BPF_ALU | BPF_MOD | BPF_K, 0, 0, static_cast<uint32_t>(size())},
+	    {BPF_RET | BPF_A, 0, 0, 0},
+	};
+	sock_fprog program {
+	    .len = sizeof(code) / sizeof(code[0]),
+	    .filter = code,
+	};
+
+	// Attaching to any member programs the whole group.
+	if (setsockopt(
+	        m_listeners.front().native_handle(),
+	        SOL_SOCKET,
+	        SO_ATTACH_REUSEPORT_CBPF,
+	        &program,
+	        sizeof(program)
+	    )
+	    < 0)
+	{
+		m_status = Status::OPTION_SET_ERROR;
+	}
+}
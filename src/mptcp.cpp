@@ -0,0 +1,91 @@
+#include "sock/mptcp.hpp"
+#include <algorithm>
+#include <iterator>
+#include <netinet/in.h>
+#include <sys/socket.h>
+// After <netinet/in.h>, whose definitions it then leaves alone.
+#include <linux/mptcp.h>
+
+auto sock::is_mptcp(const sock::Socket& socket) -> bool
+{
+	int protocol = 0;
+	socklen_t size = sizeof(protocol);
+
+	return getsockopt(
+	           socket.native_handle(),
+	           SOL_SOCKET,
+	           SO_PROTOCOL,
+	           &protocol,
+	           &size
+	       )
+	        == 0
+	    && protocol == IPPROTO_MPTCP;
+}
+
+static auto length_of(const sockaddr& address) -> socklen_t
+{
+	return address.sa_family == AF_INET6 ? sizeof(sockaddr_in6)
+	                                     : sizeof(sockaddr_in);
+}
+
+auto sock::mptcp_status(const sock::Socket& socket) -> MptcpInfo
+{
+	MptcpInfo info;
+	::mptcp_info raw {};
+	socklen_t size = sizeof(raw);
+
+	// Fails for plain TCP, and for fallen back connections on older
+	// kernels, newer ones flag them.
+	if (getsockopt(socket.native_handle(), SOL_MPTCP, MPTCP_INFO, &raw, &size)
+	        != 0
+	    || raw.mptcpi_flags & MPTCP_INFO_FLAG_FALLBACK)
+	{
+		return info;
+	}
+
+	info.active = true;
+	info.extra_subflows = raw.mptcpi_subflows;
+	info.max_subflows = raw.mptcpi_subflows_max;
+	info.addresses_signalled = raw.mptcpi_add_addr_signal;
+	info.addresses_accepted = raw.mptcpi_add_addr_accepted;
+
+	// The kernel fills in how many there are, and copies as many as fit.
+	struct
+	{
+		mptcp_subflow_data header;
+		mptcp_subflow_addrs addresses[16];
+	} subflows {};
+
+	subflows.header.size_subflow_data = sizeof(subflows.header);
+	subflows.header.size_user = sizeof(mptcp_subflow_addrs);
+	size = sizeof(subflows);
+
+	if (getsockopt(
+	        socket.native_handle(),
+	        SOL_MPTCP,
+	        MPTCP_SUBFLOW_ADDRS,
+	        &subflows,
+	        &size
+	    )
+	    != 0)
+	{
+		return info;
+	}
+
+	const auto count = std::min<size_t>(
+	    subflows.header.num_subflows,
+	    std::size(subflows.addresses)
+	);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const auto& addresses = subflows.addresses[i];
+
+		info.subflows.push_back(Subflow {
+		    .local = Endpoint {&addresses.sa_local, length_of(addresses.sa_local)},
+		    .remote = Endpoint {&addresses.sa_remote, length_of(addresses.sa_remote)},
+		});
+	}
+
+	return info;
+}
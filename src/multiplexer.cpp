@@ -0,0 +1,333 @@
+#include "sock/multiplexer.hpp"
+#include <cerrno>
+#include <memory>
+#include <sys/socket.h>
+#include <utility>
+#include <vector>
+
+static auto put_u32(std::string& out, uint32_t value) -> void
+{
+	out.push_back(static_cast<char>(value >> 24));
+	out.push_back(static_cast<char>(value >> 16));
+	out.push_back(static_cast<char>(value >> 8));
+	out.push_back(static_cast<char>(value));
+}
+
+static auto get_u32(const char* in) -> uint32_t
+{
+	const auto bytes = reinterpret_cast<const uint8_t*>(in);
+
+	return (uint32_t {bytes[0]} << 24) | (uint32_t {bytes[1]} << 16)
+	    | (uint32_t {bytes[2]} << 8) | uint32_t {bytes[3]};
+}
+
+sock::Multiplexer::Multiplexer(
+    Reactor& reactor,
+    sock::Socket&& connected,
+    Matching matching,
+    Framer framer
+) :
+    m_reactor {reactor},
+    m_sock {std::move(connected)},
+    m_matching {matching},
+    m_framer {std::move(framer)}
+{
+	if (m_sock.native_handle() < 0 || m_sock.status() != Status::GOOD)
+	{
+		m_status = Status::CONNECT_ERROR;
+		return;
+	}
+
+	if (m_output.status() != Status::GOOD)
+	{
+		m_status = m_output.status();
+		return;
+	}
+
+	m_sock.non_blocking(true);
+	m_reactor.add(
+	    m_sock.native_handle(),
+	    Events::READABLE,
+	    [this](uint32_t events)
+	    {
+		    on_events(events);
+	    }
+	);
+	m_reactor.add(
+	    m_output.notifier(),
+	    Events::READABLE,
+	    [this](uint32_t)
+	    {
+		    flush();
+	    }
+	);
+}
+
+sock::Multiplexer::~Multiplexer()
+{
+	fail(Status::CANCELLED);
+}
+
+auto sock::Multiplexer::call(std::string_view payload, Callback callback)
+    -> void
+{
+	// The id and payload must fit a 4 byte length.
+	if (m_matching == Matching::ID && payload.size() > UINT32_MAX - 4)
+	{
+		callback(Reply {.status = Status::FRAME_ERROR, .payload = {}});
+		return;
+	}
+
+	{
+		std::lock_guard lock {m_lock};
+
+		if (status() == Status::GOOD)
+		{
+			if (m_matching == Matching::ID)
+			{
+				const auto id = m_next_id++;
+				char prefix[FrameEncoder::MAX_HEADER];
+				const auto length = FrameEncoder {}.header(payload.size() + 4, prefix);
+				std::string frame;
+				frame.reserve(length + 4 + payload.size());
+				frame.append(prefix, length);
+				put_u32(frame, id);
+				frame.append(payload);
+
+				m_by_id.emplace(id, std::move(callback));
+				m_output.push(std::move(frame));
+			}
+			else
+			{
+				m_ordered.push_back(std::move(callback));
+				m_output.push(std::string {payload});
+			}
+
+			m_metrics.requests.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+	}
+
+	callback(Reply {.status = status(), .payload = {}});
+}
+
+auto sock::Multiplexer::call(std::string_view payload) -> std::future<Reply>
+{
+	auto promise = std::make_shared<std::promise<Reply>>();
+	auto future = promise->get_future();
+
+	call(
+	    payload,
+	    [promise](Reply reply)
+	    {
+		    promise->set_value(std::move(reply));
+	    }
+	);
+
+	return future;
+}
+
+auto sock::Multiplexer::in_flight() -> size_t
+{
+	std::lock_guard lock {m_lock};
+
+	return m_by_id.size() + m_ordered.size();
+}
+
+auto sock::Multiplexer::on_events(uint32_t events) -> void
+{
+	if (events & Events::WRITABLE)
+	{
+		flush();
+	}
+
+	if (events & (Events::READABLE | Events::HANGUP | Events::FAILURE))
+	{
+		receive();
+	}
+}
+
+auto sock::Multiplexer::flush() -> void
+{
+	if (status() != Status::GOOD)
+	{
+		return;
+	}
+
+	const auto written = m_output.flush(m_sock.native_handle());
+
+	if (written < 0)
+	{
+		fail(Status::SEND_ERROR);
+		return;
+	}
+
+	if (written > 0)
+	{
+		m_metrics.flushes.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// Only wait for writability while the socket buffer is full.
+	const auto writing = m_output.pending_bytes() > 0;
+
+	if (writing != m_writing)
+	{
+		m_writing = writing;
+		m_reactor.modify(
+		    m_sock.native_handle(),
+		    writing ? Events::READABLE | Events::WRITABLE : Events::READABLE
+		);
+	}
+}
+
+auto sock::Multiplexer::receive() -> void
+{
+	char chunk[64 * 1024];
+	const auto received =
+	    recv(m_sock.native_handle(), chunk, sizeof(chunk), 0);
+
+	if (received > 0 && m_matching == Matching::ID)
+	{
+		decode({chunk, static_cast<size_t>(received)});
+	}
+	else if (received > 0)
+	{
+		m_input.append(chunk, received);
+		split();
+	}
+	else if (received == 0 || errno != EAGAIN)
+	{
+		fail(Status::RECEIVE_ERROR);
+	}
+}
+
+auto sock::Multiplexer::decode(std::string_view bytes) -> void
+{
+	m_frames.feed(bytes);
+
+	while (status() == Status::GOOD)
+	{
+		const auto frame = m_frames.next();
+
+		if (!frame)
+		{
+			break;
+		}
+
+		if (frame->size() < 4)
+		{
+			fail(Status::FRAME_ERROR);
+			return;
+		}
+
+		complete(get_u32(frame->data()), frame->substr(4));
+	}
+
+	if (m_frames.status() != Status::GOOD)
+	{
+		fail(m_frames.status());
+	}
+}
+
+auto sock::Multiplexer::split() -> void
+{
+	while (status() == Status::GOOD && m_input_offset < m_input.size())
+	{
+		const std::string_view rest {
+		    m_input.data() + m_input_offset,
+		    m_input.size() - m_input_offset};
+		const auto size = m_framer(rest);
+
+		if (size == 0 || size > rest.size())
+		{
+			break;
+		}
+
+		m_input_offset += size;
+		complete(0, rest.substr(0, size));
+	}
+
+	// Views into the input are gone by now.
+	if (m_input_offset == m_input.size())
+	{
+		m_input.clear();
+		m_input_offset = 0;
+	}
+	else if (m_input_offset > m_input.size() / 2)
+	{
+		m_input.erase(0, m_input_offset);
+		m_input_offset = 0;
+	}
+}
+
+auto sock::Multiplexer::complete(uint32_t id, std::string_view payload)
+    -> void
+{
+	Callback callback;
+
+	{
+		std::lock_guard lock {m_lock};
+
+		if (m_matching == Matching::ID)
+		{
+			auto node = m_by_id.extract(id);
+
+			if (node)
+			{
+				callback = std::move(node.mapped());
+			}
+		}
+		else if (!m_ordered.empty())
+		{
+			callback = std::move(m_ordered.front());
+			m_ordered.pop_front();
+		}
+	}
+
+	// A response nobody asked for, the stream can not be trusted.
+	if (!callback)
+	{
+		fail(Status::RECEIVE_ERROR);
+		return;
+	}
+
+	m_metrics.responses.fetch_add(1, std::memory_order_relaxed);
+	callback(Reply {.status = Status::GOOD, .payload = std::string {payload}});
+}
+
+auto sock::Multiplexer::fail(Status status) -> void
+{
+	auto expected = Status::GOOD;
+
+	if (!m_status.compare_exchange_strong(expected, status))
+	{
+		return;
+	}
+
+	m_reactor.remove(m_sock.native_handle());
+	m_reactor.remove(m_output.notifier());
+
+	std::vector<Callback> outstanding;
+
+	{
+		std::lock_guard lock {m_lock};
+
+		for (auto& [id, callback] : m_by_id)
+		{
+			outstanding.push_back(std::move(callback));
+		}
+
+		for (auto& callback : m_ordered)
+		{
+			outstanding.push_back(std::move(callback));
+		}
+
+		m_by_id.clear();
+		m_ordered.clear();
+	}
+
+	for (auto& callback : outstanding)
+	{
+		callback(Reply {.status = status, .payload = {}});
+	}
+}
@@ -0,0 +1,195 @@
+#include "sock/prefork.hpp"
+#include <sched.h>
+#include <span>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+sock::Prefork::Prefork(
+    CtorArgs args,
+    sock::Address address,
+    Worker worker,
+    PreforkOptions options
+) :
+    m_listener {args},
+    m_worker {std::move(worker)}
+{
+	auto workers = options.workers;
+
+	if (workers == 0)
+	{
+		cpu_set_t set;
+		workers = sched_getaffinity(0, sizeof(set), &set) == 0
+		            ? CPU_COUNT(&set)
+		            : 1;
+	}
+
+	m_workers.resize(workers);
+
+	m_listener.option(Option::REUSEADDR, 1);
+	m_listener.bind(address);
+	m_listener.listen(options.backlog);
+	m_listener.non_blocking(true);
+
+	if (m_listener.status() != Status::GOOD)
+	{
+		m_status = m_listener.status();
+		return;
+	}
+
+	if (m_reactor.status() != Status::GOOD)
+	{
+		m_status = m_reactor.status();
+		return;
+	}
+
+	m_reactor.add(
+	    m_listener,
+	    Events::READABLE,
+	    [this](uint32_t)
+	    {
+		    accept();
+	    }
+	);
+}
+
+sock::Prefork::~Prefork()
+{
+	for (auto& worker : m_workers)
+	{
+		worker.channel.close();
+	}
+
+	reap(true);
+}
+
+sock::Prefork& sock::Prefork::start()
+{
+	for (size_t i = 0; i < m_workers.size() && m_status == Status::GOOD; i++)
+	{
+		spawn(i);
+	}
+
+	return *this;
+}
+
+void sock::Prefork::spawn(size_t index)
+{
+	auto [ours, theirs] = FdChannel::pair();
+
+	if (ours.status() != Status::GOOD)
+	{
+		m_status = ours.status();
+		return;
+	}
+
+	const auto pid = fork();
+
+	if (pid < 0)
+	{
+		m_status = Status::SOCKET_CREATE_ERROR;
+		return;
+	}
+
+	if (pid == 0)
+	{
+		// Other workers must see their channel close when the acceptor
+		// closes it, so no copies of its end may live on here. The
+		// listener is closed, not shut down, which would stop it
+		// accepting for everyone.
+		ours.close();
+
+		for (auto& worker : m_workers)
+		{
+			worker.channel.close();
+		}
+
+		::close(m_listener.release());
+
+		m_worker(index, theirs);
+		_exit(0);
+	}
+
+	m_workers[index] = {.pid = pid, .channel = std::move(ours)};
+}
+
+void sock::Prefork::restart(size_t index)
+{
+	auto& worker = m_workers[index];
+
+	worker.channel.close();
+
+	if (worker.pid > 0)
+	{
+		m_retired.push_back(worker.pid);
+	}
+
+	spawn(index);
+	reap(false);
+}
+
+void sock::Prefork::reap(bool wait)
+{
+	std::erase_if(
+	    m_retired,
+	    [wait](pid_t pid)
+	    {
+		    return waitpid(pid, nullptr, wait ? 0 : WNOHANG) != 0;
+	    }
+	);
+
+	if (!wait)
+	{
+		return;
+	}
+
+	for (auto& worker : m_workers)
+	{
+		if (worker.pid > 0)
+		{
+			waitpid(worker.pid, nullptr, 0);
+			worker.pid = -1;
+		}
+	}
+}
+
+void sock::Prefork::accept()
+{
+	std::vector<Handoff> batch;
+
+	while (batch.size() < FdChannel::MAX_BATCH)
+	{
+		const auto fd =
+		    accept4(m_listener.native_handle(), nullptr, nullptr, SOCK_CLOEXEC);
+
+		if (fd < 0)
+		{
+			break;
+		}
+
+		batch.push_back({.socket = sock::Socket {fd}});
+	}
+
+	// A worker that died or is being replaced does not take its share,
+	// the next one does. Connections nobody takes are closed.
+	std::span<Handoff> rest {batch};
+
+	for (size_t tried = 0; !rest.empty() && tried < m_workers.size(); tried++)
+	{
+		auto& worker = m_workers[m_next++ % m_workers.size()];
+		const auto sent = worker.channel.send(rest);
+
+		m_handed_off += sent;
+		rest = rest.subspan(sent);
+	}
+}
+
+void sock::Prefork::run()
+{
+	m_reactor.run();
+}
+
+void sock::Prefork::stop()
+{
+	m_reactor.stop();
+}
@@ -0,0 +1,398 @@
+#include "sock/reactor.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <sched.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+static constexpr size_t MAX_EVENTS = 256;
+
+// epoll_event::data carries descriptor in the low and registration
+// generation in the high half, so events of a descriptor that was removed
+// and re-added during one dispatch round are not delivered to the new
+// handler.
+static constexpr uint64_t pack(int fd, uint32_t generation)
+{
+	return (static_cast<uint64_t>(generation) << 32)
+	     | static_cast<uint32_t>(fd);
+}
+
+sock::Reactor::Reactor()
+{
+	m_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	m_wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	if (m_epoll_fd < 0 || m_wakeup_fd < 0)
+	{
+		m_status = sock::Status::REACTOR_ERROR;
+		return;
+	}
+
+	epoll_event ev {};
+	ev.events = EPOLLIN;
+	ev.data.u64 = pack(m_wakeup_fd, 0);
+
+	if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_wakeup_fd, &ev) < 0)
+	{
+		m_status = sock::Status::REACTOR_ERROR;
+	}
+
+	m_events.resize(MAX_EVENTS);
+}
+
+sock::Reactor::~Reactor()
+{
+	if (m_wakeup_fd >= 0)
+	{
+		close(m_wakeup_fd);
+	}
+
+	if (m_epoll_fd >= 0)
+	{
+		close(m_epoll_fd);
+	}
+}
+
+sock::Reactor& sock::Reactor::add(int fd, uint32_t events, Handler handler)
+{
+	auto entry = std::make_shared<Entry>(Entry {
+	    .generation = ++m_generation,
+	    .handler = std::move(handler),
+	});
+
+	epoll_event ev {};
+	ev.events = events;
+	ev.data.u64 = pack(fd, entry->generation);
+
+	if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0)
+	{
+		m_status = sock::Status::REACTOR_ERROR;
+	}
+	else
+	{
+		m_entries[fd] = std::move(entry);
+	}
+
+	return *this;
+}
+
+sock::Reactor& sock::Reactor::modify(int fd, uint32_t events)
+{
+	const auto it = m_entries.find(fd);
+
+	if (it == m_entries.end())
+	{
+		m_status = sock::Status::REACTOR_ERROR;
+		return *this;
+	}
+
+	epoll_event ev {};
+	ev.events = events;
+	ev.data.u64 = pack(fd, it->second->generation);
+
+	if (epoll_ctl(m_epoll_fd, EPOLL_CTL_MOD, fd, &ev) < 0)
+	{
+		m_status = sock::Status::REACTOR_ERROR;
+	}
+
+	return *this;
+}
+
+sock::Reactor& sock::Reactor::remove(int fd)
+{
+	if (m_entries.erase(fd) > 0)
+	{
+		// Descriptor may already be closed, in which case kernel has
+		// dropped it from the interest list on its own.
+		if (epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, fd, nullptr) < 0
+		    && errno != EBADF && errno != ENOENT)
+		{
+			m_status = sock::Status::REACTOR_ERROR;
+		}
+	}
+
+	return *this;
+}
+
+sock::Reactor::TimerId sock::Reactor::schedule(
+    Clock::duration delay,
+    Clock::duration period,
+    Callback callback
+)
+{
+	const auto id = m_next_timer++;
+
+	m_timers.push({.deadline = Clock::now() + delay, .id = id});
+	m_timer_callbacks.emplace(
+	    id,
+	    TimerCallback {.period = period, .callback = std::move(callback)}
+	);
+
+	return id;
+}
+
+sock::Reactor::TimerId
+    sock::Reactor::after(std::chrono::milliseconds delay, Callback callback)
+{
+	return schedule(delay, Clock::duration::zero(), std::move(callback));
+}
+
+sock::Reactor::TimerId
+    sock::Reactor::every(std::chrono::milliseconds period, Callback callback)
+{
+	return schedule(period, period, std::move(callback));
+}
+
+bool sock::Reactor::cancel(TimerId id)
+{
+	// Heap entry is dropped lazily once it expires.
+	return m_timer_callbacks.erase(id) > 0;
+}
+
+void sock::Reactor::post(Callback callback)
+{
+	{
+		std::lock_guard lock {m_posted_mutex};
+		m_posted.push_back(std::move(callback));
+	}
+
+	wakeup();
+}
+
+void sock::Reactor::wakeup()
+{
+	const uint64_t one = 1;
+
+	// EAGAIN means the counter is saturated, the loop is woken up anyway.
+	[[maybe_unused]] const auto n = write(m_wakeup_fd, &one, sizeof(one));
+}
+
+void sock::Reactor::stop()
+{
+	post(
+	    [this]()
+	    {
+		    m_stopped = true;
+	    }
+	);
+}
+
+int sock::Reactor::next_timeout(std::chrono::milliseconds timeout) const
+{
+	if (m_timers.empty())
+	{
+		return timeout.count() < 0 ? -1 : static_cast<int>(timeout.count());
+	}
+
+	const auto until = std::chrono::ceil<std::chrono::milliseconds>(
+	    m_timers.top().deadline - Clock::now()
+	);
+	const auto ms = std::max<long>(0, until.count());
+
+	if (timeout.count() < 0)
+	{
+		return static_cast<int>(ms);
+	}
+
+	return static_cast<int>(std::min<long>(ms, timeout.count()));
+}
+
+size_t sock::Reactor::run_timers()
+{
+	size_t dispatched = 0;
+	const auto now = Clock::now();
+
+	while (!m_timers.empty() && m_timers.top().deadline <= now)
+	{
+		const auto timer = m_timers.top();
+		m_timers.pop();
+
+		const auto it = m_timer_callbacks.find(timer.id);
+
+		if (it == m_timer_callbacks.end())
+		{
+			continue;
+		}
+
+		auto callback = it->second.callback;
+
+		if (it->second.period == Clock::duration::zero())
+		{
+			m_timer_callbacks.erase(it);
+		}
+		else
+		{
+			m_timers.push({
+			    .deadline = timer.deadline + it->second.period,
+			    .id = timer.id,
+			});
+		}
+
+		callback();
+		dispatched++;
+	}
+
+	return dispatched;
+}
+
+size_t sock::Reactor::run_posted()
+{
+	std::vector<Callback> posted;
+
+	{
+		std::lock_guard lock {m_posted_mutex};
+		posted.swap(m_posted);
+	}
+
+	for (auto& callback : posted)
+	{
+		callback();
+	}
+
+	return posted.size();
+}
+
+int sock::Reactor::poll(int timeout)
+{
+	return epoll_wait(
+	    m_epoll_fd,
+	    m_events.data(),
+	    static_cast<int>(m_events.size()),
+	    timeout
+	);
+}
+
+int sock::Reactor::wait(int timeout)
+{
+	using std::chrono::microseconds;
+
+	const auto start = Clock::now();
+	const auto limit = timeout < 0 ? microseconds::max()
+	                               : microseconds {timeout * 1000L};
+	auto elapsed = microseconds {0};
+
+	if (timeout != 0 && (m_spin.count() > 0 || m_strategy.yield.count() > 0))
+	{
+		while (true)
+		{
+			const auto n = poll(0);
+			elapsed = std::chrono::duration_cast<microseconds>(
+			    Clock::now() - start
+			);
+
+			if (n != 0)
+			{
+				m_stats.spinning += elapsed;
+				m_stats.spin_hits++;
+
+				return n;
+			}
+
+			if (elapsed >= limit || elapsed - m_spin >= m_strategy.yield)
+			{
+				break;
+			}
+
+			if (elapsed >= m_spin)
+			{
+				sched_yield();
+			}
+		}
+
+		m_stats.spinning += elapsed;
+
+		if (m_strategy.adaptive)
+		{
+			m_spin /= 2;
+		}
+
+		if (elapsed >= limit)
+		{
+			return 0;
+		}
+	}
+
+	const auto remaining =
+	    timeout < 0
+	        ? -1
+	        : static_cast<int>(
+	              std::chrono::ceil<std::chrono::milliseconds>(limit - elapsed)
+	                  .count()
+	          );
+	const auto blocked_at = Clock::now();
+	const auto n = poll(remaining);
+	const auto blocked = Clock::now() - blocked_at;
+
+	m_stats.blocked += blocked;
+	m_stats.blocks++;
+
+	// Events came sooner than the spin phase would have lasted, so
+	// spinning would have caught them.
+	if (m_strategy.adaptive && n > 0 && blocked < m_strategy.spin)
+	{
+		m_spin = m_spin > m_strategy.spin / 2
+		           ? m_strategy.spin
+		           : std::max(m_spin * 2, microseconds {1});
+	}
+
+	return n;
+}
+
+size_t sock::Reactor::run_once(std::chrono::milliseconds timeout)
+{
+	size_t dispatched = 0;
+
+	const auto n = wait(next_timeout(timeout));
+
+	if (n < 0 && errno != EINTR)
+	{
+		m_status = sock::Status::REACTOR_ERROR;
+	}
+
+	for (int i = 0; i < n; i++)
+	{
+		const auto data = m_events[i].data.u64;
+		const auto fd = static_cast<int>(data & 0xffffffff);
+		const auto generation = static_cast<uint32_t>(data >> 32);
+
+		if (fd == m_wakeup_fd)
+		{
+			uint64_t value;
+			[[maybe_unused]] const auto r =
+			    read(m_wakeup_fd, &value, sizeof(value));
+			continue;
+		}
+
+		const auto it = m_entries.find(fd);
+
+		if (it == m_entries.end() || it->second->generation != generation)
+		{
+			continue;
+		}
+
+		// Keep the entry alive in case the handler removes itself.
+		const auto entry = it->second;
+		entry->handler(m_events[i].events);
+		dispatched++;
+	}
+
+	if (static_cast<size_t>(n) == m_events.size())
+	{
+		m_events.resize(m_events.size() * 2);
+	}
+
+	dispatched += run_timers();
+	dispatched += run_posted();
+
+	return dispatched;
+}
+
+void sock::Reactor::run()
+{
+	m_stopped = false;
+
+	while (!m_stopped && m_status == sock::Status::GOOD)
+	{
+		run_once();
+	}
+}
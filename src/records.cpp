@@ -0,0 +1,395 @@
+#include "sock/records.hpp"
+#include <algorithm>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) \
+    && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define SOCK_RECORDS_X86_
+#endif
+
+static constexpr auto npos = std::string_view::npos;
+
+/**
+ * Position of the first `first` byte followed by `second`, or of the
+ * first `first` byte if not `pair`. The vector kernels below look for the
+ * same and hand their tails over to this one.
+ */
+static auto find_portable(
+    const char* data,
+    size_t size,
+    char first,
+    char second,
+    bool pair
+) -> size_t
+{
+	const auto end = data + size;
+
+	for (auto from = data; from < end;)
+	{
+		const auto hit =
+		    static_cast<const char*>(std::memchr(from, first, end - from));
+
+		if (hit == nullptr)
+		{
+			return npos;
+		}
+
+		if (!pair || (hit + 1 < end && hit[1] == second))
+		{
+			return hit - data;
+		}
+
+		from = hit + 1;
+	}
+
+	return npos;
+}
+
+#ifdef SOCK_RECORDS_X86_
+// Both kernels work on aligned 64 byte blocks, one bit per byte for where
+// `first` and where `second` are. A pair is a `first` bit followed by a
+// `second` bit, the last one of a block pairs with the next block's first
+// byte. Unaligned loads crossing cache lines cost as much as scanning.
+
+/**
+ * Hits among the 64 bytes at `at` given their masks, `at + 64 <= size`.
+ */
+static inline auto pairs(
+    const char* data,
+    size_t size,
+    size_t at,
+    uint64_t firsts,
+    uint64_t seconds,
+    char second
+) -> uint64_t
+{
+	auto hits = firsts & (seconds >> 1);
+
+	if ((firsts >> 63) && at + 64 < size && data[at + 64] == second)
+	{
+		hits |= uint64_t {1} << 63;
+	}
+
+	return hits;
+}
+
+__attribute__((target("sse2"))) static auto find_sse2(
+    const char* data,
+    size_t size,
+    char first,
+    char second,
+    bool pair
+) -> size_t
+{
+	const auto firsts = _mm_set1_epi8(first);
+	const auto seconds = _mm_set1_epi8(second);
+
+	const auto mask = [&](size_t at, __m128i byte) -> uint64_t
+	{
+		uint64_t bits = 0;
+
+		for (size_t i = 0; i < 4; i++)
+		{
+			const auto chunk =
+			    _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + at + 16 * i));
+			bits |= uint64_t {static_cast<uint16_t>(
+			            _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, byte))
+			        )}
+			    << (16 * i);
+		}
+
+		return bits;
+	};
+
+	const auto hits = [&](size_t at) -> uint64_t
+	{
+		const auto found = mask(at, firsts);
+
+		return pair && found ? pairs(data, size, at, found, mask(at, seconds), second)
+		                     : found;
+	};
+
+	if (size < 64)
+	{
+		return find_portable(data, size, first, second, pair);
+	}
+
+	if (const auto found = hits(0))
+	{
+		return __builtin_ctzll(found);
+	}
+
+	// Overlaps the first block so that the rest is aligned.
+	auto i = 64 - (reinterpret_cast<uintptr_t>(data) & 63);
+
+	for (; i + 64 <= size; i += 64)
+	{
+		if (const auto found = hits(i))
+		{
+			return i + __builtin_ctzll(found);
+		}
+	}
+
+	const auto rest = find_portable(data + i, size - i, first, second, pair);
+
+	return rest == npos ? npos : i + rest;
+}
+
+__attribute__((target("avx2"))) static auto find_avx2(
+    const char* data,
+    size_t size,
+    char first,
+    char second,
+    bool pair
+) -> size_t
+{
+	const auto firsts = _mm256_set1_epi8(first);
+	const auto seconds = _mm256_set1_epi8(second);
+
+	const auto mask = [&](size_t at, __m256i byte) __attribute__((target("avx2")))
+	{
+		const auto low = _mm256_cmpeq_epi8(
+		    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + at)),
+		    byte
+		);
+		const auto high = _mm256_cmpeq_epi8(
+		    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + at + 32)),
+		    byte
+		);
+
+		return uint64_t {static_cast<uint32_t>(_mm256_movemask_epi8(low))}
+		    | uint64_t {static_cast<uint32_t>(_mm256_movemask_epi8(high))} << 32;
+	};
+
+	const auto hits = [&](size_t at) __attribute__((target("avx2"))) -> uint64_t
+	{
+		const auto found = mask(at, firsts);
+
+		return pair && found ? pairs(data, size, at, found, mask(at, seconds), second)
+		                     : found;
+	};
+
+	if (size < 64)
+	{
+		return find_sse2(data, size, first, second, pair);
+	}
+
+	if (const auto found = hits(0))
+	{
+		return __builtin_ctzll(found);
+	}
+
+	auto i = 64 - (reinterpret_cast<uintptr_t>(data) & 63);
+
+	for (; i + 64 <= size; i += 64)
+	{
+		if (const auto found = hits(i))
+		{
+			return i + __builtin_ctzll(found);
+		}
+	}
+
+	const auto rest = find_portable(data + i, size - i, first, second, pair);
+
+	return rest == npos ? npos : i + rest;
+}
+#endif
+
+auto sock::best_isa() -> Isa
+{
+	static const auto best = []()
+	{
+#ifdef SOCK_RECORDS_X86_
+		__builtin_cpu_init();
+
+		if (__builtin_cpu_supports("avx2"))
+		{
+			return Isa::AVX2;
+		}
+
+		if (__builtin_cpu_supports("sse2"))
+		{
+			return Isa::SSE2;
+		}
+#endif
+
+		return Isa::PORTABLE;
+	}();
+
+	return best;
+}
+
+auto sock::find_delimiter(
+    std::string_view bytes,
+    std::string_view delimiter,
+    Isa isa
+) -> size_t
+{
+	if (delimiter.empty())
+	{
+		return 0;
+	}
+
+	using Kernel = size_t (*)(const char*, size_t, char, char, bool);
+
+#ifdef SOCK_RECORDS_X86_
+	static constexpr Kernel kernels[] {find_portable, find_sse2, find_avx2};
+#else
+	static constexpr Kernel kernels[] {find_portable, find_portable, find_portable};
+#endif
+
+	const auto find = kernels[static_cast<int>(std::min(isa, best_isa()))];
+
+	const auto pair = delimiter.size() > 1;
+	const auto second = pair ? delimiter[1] : '\0';
+
+	for (size_t from = 0; from < bytes.size();)
+	{
+		const auto found =
+		    find(bytes.data() + from, bytes.size() - from, delimiter[0], second, pair);
+
+		if (found == npos)
+		{
+			return npos;
+		}
+
+		const auto at = from + found;
+
+		// The first two bytes match, longer delimiters need the rest too.
+		if (delimiter.size() <= 2 || bytes.substr(at).starts_with(delimiter))
+		{
+			return at;
+		}
+
+		from = at + 1;
+	}
+
+	return npos;
+}
+
+auto sock::RecordReader::keep(std::string_view bytes) -> void
+{
+	// Leaves room for a delimiter that is only partly received.
+	if (m_partial.size() + bytes.size() > m_max_record + m_delimiter.size() - 1)
+	{
+		m_status = Status::FRAME_ERROR;
+		return;
+	}
+
+	m_partial.append(bytes);
+}
+
+auto sock::RecordReader::feed(std::string_view bytes) -> RecordReader&
+{
+	m_input = bytes;
+	m_offset = 0;
+	m_assembled_ready = false;
+
+	if (m_partial.empty() || m_status != Status::GOOD)
+	{
+		return *this;
+	}
+
+	// The previous reads held no delimiter, but may end in the start of
+	// one. Straddling ones start earliest, the longest overlap first.
+	bool straddled = false;
+
+	for (size_t overlap = std::min(m_delimiter.size() - 1, m_partial.size());
+	     overlap > 0;
+	     overlap--)
+	{
+		const std::string_view delimiter {m_delimiter};
+
+		if (std::string_view {m_partial}.ends_with(delimiter.substr(0, overlap))
+		    && bytes.starts_with(delimiter.substr(overlap)))
+		{
+			m_partial.resize(m_partial.size() - overlap);
+			m_offset = m_delimiter.size() - overlap;
+			straddled = true;
+			break;
+		}
+	}
+
+	if (!straddled)
+	{
+		const auto found = find_delimiter(bytes, m_delimiter);
+
+		keep(bytes.substr(0, found));
+
+		if (found == npos)
+		{
+			m_offset = bytes.size();
+			return *this;
+		}
+
+		m_offset = found + m_delimiter.size();
+	}
+
+	if (m_status == Status::GOOD && m_partial.size() > m_max_record)
+	{
+		m_status = Status::FRAME_ERROR;
+	}
+
+	if (m_status == Status::GOOD)
+	{
+		m_assembled.swap(m_partial);
+		m_partial.clear();
+		m_assembled_ready = true;
+	}
+
+	return *this;
+}
+
+auto sock::RecordReader::next() -> std::optional<std::string_view>
+{
+	if (m_status != Status::GOOD)
+	{
+		return std::nullopt;
+	}
+
+	if (m_assembled_ready)
+	{
+		m_assembled_ready = false;
+
+		return std::string_view {m_assembled};
+	}
+
+	const auto rest = m_input.substr(m_offset);
+
+	if (!m_partial.empty() || rest.empty())
+	{
+		return std::nullopt;
+	}
+
+	const auto found = find_delimiter(rest, m_delimiter);
+
+	if (found == npos)
+	{
+		// Kept until the rest arrives, the fed bytes may be gone by then.
+		keep(rest);
+		m_offset = m_input.size();
+
+		return std::nullopt;
+	}
+
+	if (found > m_max_record)
+	{
+		m_status = Status::FRAME_ERROR;
+		return std::nullopt;
+	}
+
+	m_offset += found + m_delimiter.size();
+
+	return rest.substr(0, found);
+}
+
+auto sock::RecordReader::reset() -> void
+{
+	m_status = Status::GOOD;
+	m_input = {};
+	m_offset = 0;
+	m_partial.clear();
+	m_assembled.clear();
+	m_assembled_ready = false;
+}
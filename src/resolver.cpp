@@ -0,0 +1,106 @@
+#include "sock/resolver.hpp"
+#include <algorithm>
+#include <coroutine>
+#include <memory>
+#include <utility>
+
+struct sock::Resolver::Pending
+{
+	Resolution resolution;
+	std::coroutine_handle<> waiter {nullptr};
+	// Set on the reactor thread once the awaiting coroutine is gone.
+	bool abandoned {false};
+};
+
+sock::Resolver::Resolver(
+    Reactor& reactor,
+    size_t threads,
+    ResolverCache* cache
+) :
+    m_reactor {reactor},
+    m_cache {cache},
+    m_pool {std::max<size_t>(threads, 1)}
+{}
+
+sock::Task<sock::Resolution> sock::Resolver::resolve(
+    CtorArgs args,
+    sock::Address address
+)
+{
+	// Tasks start lazily, the views may be gone by then.
+	return lookup(args, std::string {address.host}, std::string {address.port});
+}
+
+sock::Task<sock::Resolution> sock::Resolver::lookup(
+    CtorArgs args,
+    std::string host,
+    std::string port
+)
+{
+	if (Endpoint::parse({.host = host, .port = port}))
+	{
+		co_return sock::resolve(args, {.host = host, .port = port});
+	}
+
+	struct Wait
+	{
+		Resolver& resolver;
+		CtorArgs args;
+		const std::string& host;
+		const std::string& port;
+		std::shared_ptr<Pending> pending;
+
+		auto await_ready() const noexcept -> bool
+		{
+			return false;
+		}
+
+		auto await_suspend(std::coroutine_handle<> handle) -> void
+		{
+			pending->waiter = handle;
+
+			resolver.m_pool.submit(
+			    [reactor = &resolver.m_reactor,
+			     cache = resolver.m_cache,
+			     args = args,
+			     host = host,
+			     port = port,
+			     pending = pending]()
+			    {
+				    const sock::Address address {.host = host, .port = port};
+
+				    pending->resolution = cache ? cache->resolve(args, address)
+				                                : sock::resolve(args, address);
+
+				    reactor->post(
+				        [pending]()
+				        {
+					        if (!pending->abandoned)
+					        {
+						        pending->waiter.resume();
+					        }
+				        }
+				    );
+			    }
+			);
+		}
+
+		auto await_resume() -> Resolution
+		{
+			return std::move(pending->resolution);
+		}
+
+		~Wait()
+		{
+			// Destroyed along with a coroutine that never got resumed.
+			pending->abandoned = true;
+		}
+	};
+
+	co_return co_await Wait {
+	    *this,
+	    args,
+	    host,
+	    port,
+	    std::make_shared<Pending>()};
+}
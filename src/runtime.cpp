@@ -0,0 +1,318 @@
+#include "sock/runtime.hpp"
+#include <cerrno>
+#include <sched.h>
+#include <sys/socket.h>
+#include <utility>
+
+sock::BufferPool::Handle sock::BufferPool::acquire()
+{
+	if (m_free.empty())
+	{
+		return Handle {new Buffer, Release {this}};
+	}
+
+	auto buffer = std::move(m_free.back());
+	m_free.pop_back();
+
+	return Handle {buffer.release(), Release {this}};
+}
+
+void sock::BufferPool::release(Buffer* buffer)
+{
+	m_free.emplace_back(buffer);
+}
+
+sock::Core::Core(Runtime& runtime, size_t index) :
+    m_runtime {runtime},
+    m_index {index}
+{}
+
+void sock::Core::send(size_t target, Message message)
+{
+	auto& core = m_runtime.core(target);
+
+	core.reactor().post(
+	    [&core, message = std::move(message)]()
+	    {
+		    core.m_metrics.messages.fetch_add(1, std::memory_order_relaxed);
+		    message(core);
+	    }
+	);
+}
+
+void sock::Core::adopt(std::shared_ptr<Connection> connection)
+{
+	const auto fd = connection->native_handle();
+
+	connection->attach(*this);
+	m_reactor.add(
+	    fd,
+	    connection->events(),
+	    [conn = connection.get()](uint32_t events)
+	    {
+		    conn->on_events(events);
+	    }
+	);
+	m_reactor.add(
+	    connection->m_output.notifier(),
+	    Events::READABLE,
+	    [conn = connection.get()](uint32_t)
+	    {
+		    conn->on_events(0);
+	    }
+	);
+	m_connections[fd] = std::move(connection);
+	m_metrics.connections.fetch_add(1, std::memory_order_relaxed);
+}
+
+void sock::Core::drop(Connection& connection)
+{
+	const auto fd = connection.native_handle();
+
+	// Removing inside of the connection's own handler is fine, the
+	// connection itself is freed once the dispatch round is over.
+	m_reactor.remove(fd);
+	m_reactor.remove(connection.m_output.notifier());
+	m_reactor.post(
+	    [owned = std::move(m_connections[fd])]() mutable
+	    {
+		    owned.reset();
+	    }
+	);
+	m_connections.erase(fd);
+	m_metrics.connections.fetch_sub(1, std::memory_order_relaxed);
+	m_metrics.queued.fetch_sub(
+	    std::exchange(connection.m_queued, 0),
+	    std::memory_order_relaxed
+	);
+}
+
+void sock::Core::migrate(Connection& connection, size_t target)
+{
+	const auto fd = connection.native_handle();
+
+	if (target == m_index || !m_connections.contains(fd))
+	{
+		return;
+	}
+
+	// Posted callbacks run after every ready handler, so the connection is
+	// not in the middle of one when it leaves.
+	m_reactor.post(
+	    [this, fd, target]()
+	    {
+		    const auto it = m_connections.find(fd);
+
+		    if (it == m_connections.end())
+		    {
+			    return;
+		    }
+
+		    auto leaving = std::move(it->second);
+		    m_connections.erase(it);
+		    m_reactor.remove(fd);
+		    m_reactor.remove(leaving->m_output.notifier());
+		    leaving->detach();
+		    m_metrics.connections.fetch_sub(1, std::memory_order_relaxed);
+		    m_metrics.migrated.fetch_add(1, std::memory_order_relaxed);
+
+		    send(
+		        target,
+		        [leaving](Core& core)
+		        {
+			        core.adopt(leaving);
+		        }
+		    );
+	    }
+	);
+}
+
+void sock::Core::shed(size_t target, uint64_t budget)
+{
+	Connection* chosen = nullptr;
+
+	for (auto& [fd, connection] : m_connections)
+	{
+		if (connection->m_load <= budget
+		    && (chosen == nullptr || connection->m_load > chosen->m_load))
+		{
+			chosen = connection.get();
+		}
+	}
+
+	for (auto& [fd, connection] : m_connections)
+	{
+		connection->m_load = 0;
+	}
+
+	if (chosen != nullptr && m_connections.size() > 1)
+	{
+		migrate(*chosen, target);
+	}
+}
+
+sock::Runtime::Runtime(RuntimeOptions options) : m_options {options}
+{
+	cpu_set_t set;
+
+	if (sched_getaffinity(0, sizeof(set), &set) == 0)
+	{
+		for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+		{
+			if (CPU_ISSET(cpu, &set))
+			{
+				m_cpus.push_back(cpu);
+			}
+		}
+	}
+
+	const auto cores = options.cores > 0 ? options.cores
+	                 : m_cpus.empty()     ? 1
+	                                      : m_cpus.size();
+
+	m_cores.reserve(cores);
+
+	for (size_t i = 0; i < cores; i++)
+	{
+		auto& core = m_cores.emplace_back(std::make_unique<Core>(*this, i));
+
+		if (core->reactor().status() != Status::GOOD)
+		{
+			m_status = core->reactor().status();
+		}
+	}
+}
+
+sock::Runtime::~Runtime()
+{
+	stop();
+}
+
+sock::Runtime& sock::Runtime::listen(
+    CtorArgs args,
+    sock::Address address,
+    Acceptor acceptor
+)
+{
+	m_acceptor = std::move(acceptor);
+	m_listeners.emplace(
+	    args,
+	    address,
+	    size(),
+	    ListenerGroupOptions {.steer_by_cpu = true}
+	);
+
+	if (m_listeners->status() != Status::GOOD)
+	{
+		m_status = m_listeners->status();
+		return *this;
+	}
+
+	for (size_t i = 0; i < size(); i++)
+	{
+		auto& core = *m_cores[i];
+		auto& listener = m_listeners->listener(i);
+
+		listener.non_blocking(true);
+		core.reactor().add(
+		    listener,
+		    Events::READABLE,
+		    [this, &core, &listener](uint32_t)
+		    {
+			    accept(core, listener);
+		    }
+		);
+	}
+
+	return *this;
+}
+
+void sock::Runtime::accept(Core& core, sock::Socket& listener)
+{
+	while (true)
+	{
+		const auto fd = accept4(
+		    listener.native_handle(),
+		    nullptr,
+		    nullptr,
+		    SOCK_NONBLOCK | SOCK_CLOEXEC
+		);
+
+		if (fd < 0)
+		{
+			return;
+		}
+
+		core.m_metrics.accepted.fetch_add(1, std::memory_order_relaxed);
+		m_acceptor(core, sock::Socket {fd});
+	}
+}
+
+void sock::Runtime::broadcast(Core::Message message)
+{
+	for (auto& core : m_cores)
+	{
+		core->reactor().post(
+		    [&core = *core, message]()
+		    {
+			    message(core);
+		    }
+		);
+	}
+}
+
+sock::Runtime& sock::Runtime::start()
+{
+	for (auto& core : m_cores)
+	{
+		m_threads.emplace_back(
+		    [this, &core = *core]()
+		    {
+			    if (m_options.pin && !m_cpus.empty())
+			    {
+				    cpu_set_t set;
+				    CPU_ZERO(&set);
+				    CPU_SET(m_cpus[core.index() % m_cpus.size()], &set);
+				    sched_setaffinity(0, sizeof(set), &set);
+			    }
+
+			    auto& reactor = core.reactor();
+
+			    while (m_status == Status::GOOD
+			           && reactor.status() == Status::GOOD)
+			    {
+				    const auto n = reactor.run_once();
+				    core.m_metrics.dispatched.fetch_add(
+				        n,
+				        std::memory_order_relaxed
+				    );
+
+				    if (m_stopping.load(std::memory_order_relaxed))
+				    {
+					    break;
+				    }
+			    }
+		    }
+		);
+	}
+
+	return *this;
+}
+
+void sock::Runtime::stop()
+{
+	m_stopping = true;
+
+	for (auto& core : m_cores)
+	{
+		core->reactor().wakeup();
+	}
+
+	for (auto& thread : m_threads)
+	{
+		thread.join();
+	}
+
+	m_threads.clear();
+	m_stopping = false;
+}
@@ -0,0 +1,265 @@
+#include "sock/send_queue.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+sock::SendQueue::SendQueue() : m_head {&m_stub}, m_tail {&m_stub}
+{
+	m_notifier = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	if (m_notifier < 0)
+	{
+		m_status = sock::Status::REACTOR_ERROR;
+	}
+}
+
+sock::SendQueue::~SendQueue()
+{
+	while (auto node = dequeue())
+	{
+		delete node;
+	}
+
+	if (m_notifier >= 0)
+	{
+		close(m_notifier);
+	}
+}
+
+void sock::SendQueue::enqueue(Node* node)
+{
+	node->next.store(nullptr, std::memory_order_relaxed);
+	const auto previous = m_head.exchange(node, std::memory_order_acq_rel);
+	previous->next.store(node, std::memory_order_release);
+}
+
+sock::SendQueue::Node* sock::SendQueue::dequeue()
+{
+	auto tail = m_tail;
+	auto next = tail->next.load(std::memory_order_acquire);
+
+	if (tail == &m_stub)
+	{
+		if (next == nullptr)
+		{
+			return nullptr;
+		}
+
+		m_tail = next;
+		tail = next;
+		next = next->next.load(std::memory_order_acquire);
+	}
+
+	if (next != nullptr)
+	{
+		m_tail = next;
+		return tail;
+	}
+
+	// A producer has swapped the head but not linked its node yet, it
+	// signals again once it has.
+	if (tail != m_head.load(std::memory_order_acquire))
+	{
+		return nullptr;
+	}
+
+	enqueue(&m_stub);
+	next = tail->next.load(std::memory_order_acquire);
+
+	if (next != nullptr)
+	{
+		m_tail = next;
+		return tail;
+	}
+
+	return nullptr;
+}
+
+void sock::SendQueue::push(std::string payload)
+{
+	enqueue(new Node {.next = {nullptr}, .payload = std::move(payload)});
+
+	if (!m_signalled.exchange(true, std::memory_order_acq_rel))
+	{
+		m_wakeups.fetch_add(1, std::memory_order_relaxed);
+		eventfd_write(m_notifier, 1);
+	}
+}
+
+void sock::SendQueue::collect(bool drain)
+{
+	// Saves reading the eventfd on every write while nobody pushes. A
+	// signal racing with that check is consumed by the next `flush()`.
+	if (drain || m_signalled.load(std::memory_order_acquire))
+	{
+		eventfd_t ignored;
+		eventfd_read(m_notifier, &ignored);
+
+		// Pairs with the producers' exchange: every node pushed before
+		// the last signal is visible from here on.
+		m_signalled.exchange(false, std::memory_order_acq_rel);
+	}
+
+	while (auto node = dequeue())
+	{
+		m_ready_bytes += node->payload.size();
+		m_ready.push_back(std::move(node->payload));
+		delete node;
+	}
+}
+
+bool sock::SendQueue::pending()
+{
+	collect();
+
+	return !m_ready.empty();
+}
+
+int64_t sock::SendQueue::write(int fd, std::string_view payload)
+{
+	collect();
+
+	if (!m_ready.empty())
+	{
+		m_ready_bytes += payload.size();
+		m_ready.emplace_back(payload);
+
+		return flush(fd);
+	}
+
+	const auto n = ::send(fd, payload.data(), payload.size(), MSG_NOSIGNAL);
+
+	if (n < 0 && errno != EAGAIN)
+	{
+		return -1;
+	}
+
+	const auto sent = n < 0 ? 0 : static_cast<size_t>(n);
+
+	if (sent < payload.size())
+	{
+		m_ready_bytes += payload.size() - sent;
+		m_ready.emplace_back(payload.substr(sent));
+	}
+
+	return sent;
+}
+
+int64_t sock::SendQueue::write(
+    int fd,
+    std::span<const std::string_view> payloads
+)
+{
+	collect();
+
+	size_t sent = 0;
+
+	if (m_ready.empty())
+	{
+		iovec iov[IOV_MAX];
+		const auto count = std::min<size_t>(payloads.size(), IOV_MAX);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			iov[i].iov_base = const_cast<char*>(payloads[i].data());
+			iov[i].iov_len = payloads[i].size();
+		}
+
+		msghdr message {};
+		message.msg_iov = iov;
+		message.msg_iovlen = count;
+
+		const auto n = sendmsg(fd, &message, MSG_NOSIGNAL);
+
+		if (n < 0 && errno != EAGAIN)
+		{
+			return -1;
+		}
+
+		sent = n < 0 ? 0 : static_cast<size_t>(n);
+	}
+
+	// Whatever the socket did not take is queued behind the rest.
+	auto skip = sent;
+
+	for (const auto payload : payloads)
+	{
+		if (skip >= payload.size())
+		{
+			skip -= payload.size();
+			continue;
+		}
+
+		m_ready_bytes += payload.size() - skip;
+		m_ready.emplace_back(payload.substr(skip));
+		skip = 0;
+	}
+
+	if (sent == 0 && !m_ready.empty())
+	{
+		return flush(fd);
+	}
+
+	return sent;
+}
+
+int64_t sock::SendQueue::flush(int fd)
+{
+	collect(true);
+
+	int64_t written = 0;
+
+	while (!m_ready.empty())
+	{
+		iovec iov[IOV_MAX];
+		const auto count = std::min<size_t>(m_ready.size(), IOV_MAX);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const auto offset = i == 0 ? m_ready_offset : 0;
+			iov[i].iov_base = m_ready[i].data() + offset;
+			iov[i].iov_len = m_ready[i].size() - offset;
+		}
+
+		msghdr message {};
+		message.msg_iov = iov;
+		message.msg_iovlen = count;
+
+		auto n = sendmsg(fd, &message, MSG_NOSIGNAL);
+
+		if (n < 0)
+		{
+			return errno == EAGAIN ? written : -1;
+		}
+
+		written += n;
+		m_ready_bytes -= n;
+
+		while (n > 0)
+		{
+			const auto left = m_ready.front().size() - m_ready_offset;
+
+			if (static_cast<size_t>(n) < left)
+			{
+				m_ready_offset += n;
+				break;
+			}
+
+			n -= left;
+			m_ready_offset = 0;
+			m_ready.pop_front();
+		}
+
+		if (!m_ready.empty() && m_ready_offset > 0)
+		{
+			// The socket buffer is full.
+			break;
+		}
+	}
+
+	return written;
+}
@@ -0,0 +1,560 @@
+#include "sock/shm_socket.hpp"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <linux/futex.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+// Both rings' state up front, the data of each direction after it.
+struct sock::ShmSocket::Region
+{
+	uint64_t capacity;
+	Ring rings[2];
+};
+
+// Not FUTEX_PRIVATE_FLAG, the words are shared between processes.
+static auto futex_wait(
+    std::atomic<uint32_t>& word,
+    uint32_t expected,
+    std::chrono::milliseconds timeout
+) -> long
+{
+	const timespec to {
+	    .tv_sec = static_cast<time_t>(timeout.count() / 1000),
+	    .tv_nsec = static_cast<long>((timeout.count() % 1000) * 1000000)};
+
+	return syscall(
+	    SYS_futex,
+	    reinterpret_cast<uint32_t*>(&word),
+	    FUTEX_WAIT,
+	    expected,
+	    &to,
+	    nullptr,
+	    0
+	);
+}
+
+static auto futex_wake(std::atomic<uint32_t>& word) -> void
+{
+	word.fetch_add(1, std::memory_order_release);
+	syscall(
+	    SYS_futex,
+	    reinterpret_cast<uint32_t*>(&word),
+	    FUTEX_WAKE,
+	    INT_MAX,
+	    nullptr,
+	    nullptr,
+	    0
+	);
+}
+
+static auto copy_in(
+    char* data,
+    size_t capacity,
+    uint64_t position,
+    const char* from,
+    size_t size
+) -> void
+{
+	const auto offset = position & (capacity - 1);
+	const auto first = std::min(size, capacity - offset);
+
+	std::memcpy(data + offset, from, first);
+	std::memcpy(data, from + first, size - first);
+}
+
+static auto copy_out(
+    const char* data,
+    size_t capacity,
+    uint64_t position,
+    char* to,
+    size_t size
+) -> void
+{
+	const auto offset = position & (capacity - 1);
+	const auto first = std::min(size, capacity - offset);
+
+	std::memcpy(to, data + offset, first);
+	std::memcpy(to + first, data, size - first);
+}
+
+sock::ShmSocket::ShmSocket(CtorArgs args, size_t capacity) :
+    m_control {CtorArgs {
+        .domain = Domain::LOCAL,
+        .type = Type::STREAM,
+        .protocol = Protocol::DEFAULT,
+        .flags = args.flags,
+    }},
+    m_capacity {std::bit_ceil(std::max<size_t>(capacity, 4096))}
+{
+	m_status = m_control.status();
+}
+
+sock::ShmSocket::ShmSocket(ShmSocket&& other)
+{
+	*this = std::move(other);
+}
+
+sock::ShmSocket& sock::ShmSocket::operator=(ShmSocket&& other)
+{
+	if (this != &other)
+	{
+		if (m_region != nullptr)
+		{
+			shutdown();
+			unmap();
+		}
+
+		m_status = other.m_status;
+		m_control = std::move(other.m_control);
+		m_capacity = other.m_capacity;
+		m_receive_timeout = other.m_receive_timeout;
+		m_send_timeout = other.m_send_timeout;
+		m_region = std::exchange(other.m_region, nullptr);
+		m_region_size = std::exchange(other.m_region_size, 0);
+		m_tx = std::exchange(other.m_tx, nullptr);
+		m_rx = std::exchange(other.m_rx, nullptr);
+		m_tx_data = std::exchange(other.m_tx_data, nullptr);
+		m_rx_data = std::exchange(other.m_rx_data, nullptr);
+	}
+
+	return *this;
+}
+
+sock::ShmSocket::~ShmSocket()
+{
+	if (m_region != nullptr)
+	{
+		shutdown();
+		unmap();
+	}
+}
+
+sock::ShmSocket& sock::ShmSocket::option(
+    sock::Option opt,
+    std::chrono::milliseconds timeout
+)
+{
+	if (opt == Option::RCVTIMEO)
+	{
+		m_receive_timeout = timeout;
+	}
+	else if (opt == Option::SNDTIMEO)
+	{
+		m_send_timeout = timeout;
+	}
+	else
+	{
+		m_control.option(opt, timeout);
+		m_status = m_control.status();
+	}
+
+	return *this;
+}
+
+sock::ShmSocket& sock::ShmSocket::option(sock::Option opt, int value)
+{
+	m_control.option(opt, value);
+	m_status = m_control.status();
+
+	return *this;
+}
+
+sock::ShmSocket& sock::ShmSocket::bind(sock::Address address)
+{
+	m_control.bind(address);
+	m_status = m_control.status();
+
+	return *this;
+}
+
+sock::ShmSocket& sock::ShmSocket::listen(size_t backlog)
+{
+	m_control.listen(backlog);
+	m_status = m_control.status();
+
+	return *this;
+}
+
+bool sock::ShmSocket::map(int memfd, bool initialize)
+{
+	if (initialize)
+	{
+		m_region_size = sizeof(Region) + 2 * m_capacity;
+
+		if (ftruncate(memfd, m_region_size) < 0)
+		{
+			return false;
+		}
+	}
+	else
+	{
+		struct stat info;
+
+		if (fstat(memfd, &info) < 0
+		    || static_cast<size_t>(info.st_size) < sizeof(Region))
+		{
+			return false;
+		}
+
+		m_region_size = info.st_size;
+	}
+
+	const auto memory = mmap(
+	    nullptr,
+	    m_region_size,
+	    PROT_READ | PROT_WRITE,
+	    MAP_SHARED,
+	    memfd,
+	    0
+	);
+
+	if (memory == MAP_FAILED)
+	{
+		m_region_size = 0;
+
+		return false;
+	}
+
+	if (initialize)
+	{
+		m_region = new (memory) Region {.capacity = m_capacity, .rings = {}};
+	}
+	else
+	{
+		m_region = static_cast<Region*>(memory);
+		m_capacity = m_region->capacity;
+
+		// Do not trust a peer claiming more than it mapped.
+		if (!std::has_single_bit(m_capacity)
+		    || sizeof(Region) + 2 * m_capacity > m_region_size)
+		{
+			unmap();
+
+			return false;
+		}
+	}
+
+	// The connecting side sends on the first ring.
+	auto data = reinterpret_cast<char*>(m_region + 1);
+	m_tx = &m_region->rings[initialize ? 0 : 1];
+	m_rx = &m_region->rings[initialize ? 1 : 0];
+	m_tx_data = initialize ? data : data + m_capacity;
+	m_rx_data = initialize ? data + m_capacity : data;
+
+	return true;
+}
+
+void sock::ShmSocket::unmap()
+{
+	munmap(m_region, m_region_size);
+	m_region = nullptr;
+	m_region_size = 0;
+	m_tx = nullptr;
+	m_rx = nullptr;
+	m_tx_data = nullptr;
+	m_rx_data = nullptr;
+}
+
+sock::ShmSocket& sock::ShmSocket::connect(sock::Address address)
+{
+	m_control.connect(address);
+
+	if (m_control.status() != Status::GOOD)
+	{
+		m_status = Status::CONNECT_ERROR;
+		return *this;
+	}
+
+	const auto memfd = memfd_create("sock-shm", MFD_CLOEXEC);
+
+	if (memfd < 0 || !map(memfd, true))
+	{
+		if (memfd >= 0)
+		{
+			close(memfd);
+		}
+
+		m_status = Status::CONNECT_ERROR;
+		return *this;
+	}
+
+	char byte = 0;
+	iovec iov {.iov_base = &byte, .iov_len = 1};
+	alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] {};
+
+	msghdr msg {};
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control;
+	msg.msg_controllen = sizeof(control);
+
+	auto cmsg = CMSG_FIRSTHDR(&msg);
+	cmsg->cmsg_level = SOL_SOCKET;
+	cmsg->cmsg_type = SCM_RIGHTS;
+	cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+	std::memcpy(CMSG_DATA(cmsg), &memfd, sizeof(memfd));
+
+	const auto sent = sendmsg(m_control.native_handle(), &msg, MSG_NOSIGNAL);
+
+	// The mapping keeps the memory alive.
+	close(memfd);
+
+	m_status = sent == 1 ? Status::GOOD : Status::CONNECT_ERROR;
+
+	return *this;
+}
+
+sock::ShmSocket sock::ShmSocket::accept()
+{
+	ShmSocket conn;
+	conn.m_control = m_control.accept();
+	conn.m_receive_timeout = m_receive_timeout;
+	conn.m_send_timeout = m_send_timeout;
+
+	if (conn.m_control.native_handle() < 0)
+	{
+		conn.m_status = Status::ACCEPT_FAILED;
+		return conn;
+	}
+
+	char byte;
+	iovec iov {.iov_base = &byte, .iov_len = 1};
+	alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] {};
+
+	msghdr msg {};
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control;
+	msg.msg_controllen = sizeof(control);
+
+	int memfd = -1;
+
+	if (recvmsg(conn.m_control.native_handle(), &msg, MSG_CMSG_CLOEXEC) == 1)
+	{
+		auto cmsg = CMSG_FIRSTHDR(&msg);
+
+		if (cmsg != nullptr && cmsg->cmsg_level == SOL_SOCKET
+		    && cmsg->cmsg_type == SCM_RIGHTS)
+		{
+			std::memcpy(&memfd, CMSG_DATA(cmsg), sizeof(memfd));
+		}
+	}
+
+	if (memfd < 0 || !conn.map(memfd, false))
+	{
+		conn.m_status = Status::ACCEPT_FAILED;
+	}
+
+	if (memfd >= 0)
+	{
+		close(memfd);
+	}
+
+	return conn;
+}
+
+bool sock::ShmSocket::peer_gone() const
+{
+	char byte;
+
+	return recv(
+	           m_control.native_handle(),
+	           &byte,
+	           1,
+	           MSG_PEEK | MSG_DONTWAIT
+	       )
+	    == 0;
+}
+
+bool sock::ShmSocket::wait(
+    std::atomic<uint32_t>& word,
+    std::atomic<uint32_t>& sleeping,
+    const std::atomic<uint64_t>& position,
+    uint64_t seen,
+    Ring& ring,
+    std::chrono::milliseconds timeout
+)
+{
+	using Clock = std::chrono::steady_clock;
+
+	// Sleeps in slices to notice a peer that died without closing.
+	constexpr std::chrono::milliseconds slice {100};
+	const auto deadline = timeout.count() > 0 ? Clock::now() + timeout
+	                                          : Clock::time_point::max();
+
+	while (position.load(std::memory_order_acquire) == seen
+	       && ring.closed.load(std::memory_order_acquire) == 0)
+	{
+		const auto now = Clock::now();
+
+		if (now >= deadline)
+		{
+			return false;
+		}
+
+		const auto value = word.load(std::memory_order_acquire);
+
+		// Pairs with the producer storing its position, then checking
+		// whether this side sleeps.
+		sleeping.store(1, std::memory_order_seq_cst);
+
+		long result = 0;
+
+		if (position.load(std::memory_order_seq_cst) == seen
+		    && ring.closed.load(std::memory_order_seq_cst) == 0)
+		{
+			const auto left = std::chrono::ceil<std::chrono::milliseconds>(
+			    deadline - now
+			);
+			result = futex_wait(word, value, std::min(slice, left));
+		}
+
+		sleeping.store(0, std::memory_order_relaxed);
+
+		if (result < 0 && errno == ETIMEDOUT && peer_gone())
+		{
+			ring.closed.store(1, std::memory_order_release);
+		}
+	}
+
+	return true;
+}
+
+void sock::ShmSocket::receive(sock::Buffer& buff, int flags)
+{
+	buff.reset();
+
+	if (m_rx == nullptr)
+	{
+		m_status = Status::RECEIVE_ERROR;
+		buff.received_size(0);
+		return;
+	}
+
+	const auto max = buff.max_size() - 1;
+
+	while (true)
+	{
+		const auto head = m_rx->head.load(std::memory_order_relaxed);
+		const auto tail = m_rx->tail.load(std::memory_order_acquire);
+
+		if (tail != head)
+		{
+			const auto n = std::min<size_t>(tail - head, max);
+			copy_out(m_rx_data, m_capacity, head, buff.buffer(), n);
+			m_rx->head.store(head + n, std::memory_order_seq_cst);
+
+			if (m_rx->writer_sleeping.load(std::memory_order_seq_cst) != 0)
+			{
+				futex_wake(m_rx->writable);
+			}
+
+			buff.buffer()[n] = '\0';
+			buff.received_size(n);
+			return;
+		}
+
+		// Everything sent before closing has been read.
+		if (m_rx->closed.load(std::memory_order_acquire) != 0)
+		{
+			buff.received_size(0);
+			return;
+		}
+
+		if ((flags & MSG_DONTWAIT) != 0
+		    || !wait(
+		        m_rx->readable,
+		        m_rx->reader_sleeping,
+		        m_rx->tail,
+		        tail,
+		        *m_rx,
+		        m_receive_timeout
+		    ))
+		{
+			m_status = Status::RECEIVE_ERROR;
+			buff.received_size(0);
+			return;
+		}
+	}
+}
+
+sock::ShmSocket& sock::ShmSocket::send(std::string_view payload)
+{
+	if (m_tx == nullptr)
+	{
+		m_status = Status::SEND_ERROR;
+		return *this;
+	}
+
+	while (!payload.empty())
+	{
+		if (m_tx->closed.load(std::memory_order_acquire) != 0)
+		{
+			m_status = Status::SEND_ERROR;
+			return *this;
+		}
+
+		const auto head = m_tx->head.load(std::memory_order_acquire);
+		const auto tail = m_tx->tail.load(std::memory_order_relaxed);
+		const auto room = m_capacity - (tail - head);
+
+		if (room == 0)
+		{
+			if (!wait(
+			        m_tx->writable,
+			        m_tx->writer_sleeping,
+			        m_tx->head,
+			        head,
+			        *m_tx,
+			        m_send_timeout
+			    ))
+			{
+				m_status = Status::SEND_ERROR;
+				return *this;
+			}
+
+			continue;
+		}
+
+		const auto n = std::min(room, payload.size());
+		copy_in(m_tx_data, m_capacity, tail, payload.data(), n);
+		m_tx->tail.store(tail + n, std::memory_order_seq_cst);
+
+		// The reader only sleeps on an empty ring, so this is the
+		// empty to non-empty transition.
+		if (m_tx->reader_sleeping.load(std::memory_order_seq_cst) != 0)
+		{
+			futex_wake(m_tx->readable);
+		}
+
+		payload.remove_prefix(n);
+	}
+
+	return *this;
+}
+
+void sock::ShmSocket::shutdown()
+{
+	if (m_region == nullptr)
+	{
+		return;
+	}
+
+	for (auto ring : {m_tx, m_rx})
+	{
+		ring->closed.store(1, std::memory_order_seq_cst);
+		futex_wake(ring->readable);
+		futex_wake(ring->writable);
+	}
+}
@@ -0,0 +1,206 @@
+#include "sock/timer_wheel.hpp"
+#include <algorithm>
+
+sock::WheelTimer::~WheelTimer()
+{
+	if (armed())
+	{
+		m_wheel->cancel(*this);
+	}
+}
+
+sock::TimerWheel::TimerWheel(std::chrono::milliseconds tick) :
+    m_tick {tick.count() > 0 ? tick : std::chrono::milliseconds {1}},
+    m_start {Clock::now()}
+{
+	for (auto& slot : m_inner)
+	{
+		slot.m_prev = &slot;
+		slot.m_next = &slot;
+	}
+
+	for (auto& level : m_outer)
+	{
+		for (auto& slot : level)
+		{
+			slot.m_prev = &slot;
+			slot.m_next = &slot;
+		}
+	}
+}
+
+sock::TimerWheel::~TimerWheel()
+{
+	const auto clear = [](Slot& slot)
+	{
+		while (slot.m_next != &slot)
+		{
+			slot.m_next->unlink();
+		}
+
+		// Sentinels are not timers, keep their destructor from touching
+		// the neighbouring slots.
+		slot.m_prev = nullptr;
+		slot.m_next = nullptr;
+	};
+
+	for (auto& slot : m_inner)
+	{
+		clear(slot);
+	}
+
+	for (auto& level : m_outer)
+	{
+		for (auto& slot : level)
+		{
+			clear(slot);
+		}
+	}
+}
+
+uint64_t sock::TimerWheel::ticks(Clock::time_point time) const
+{
+	if (time <= m_start)
+	{
+		return 0;
+	}
+
+	// Round up so a timer never fires before its deadline.
+	const auto elapsed = time - m_start;
+	const auto tick = std::chrono::duration_cast<Clock::duration>(m_tick);
+
+	return (elapsed + tick - Clock::duration {1}) / tick;
+}
+
+void sock::TimerWheel::append(Slot& slot, WheelTimer& timer)
+{
+	timer.m_prev = slot.m_prev;
+	timer.m_next = &slot;
+	slot.m_prev->m_next = &timer;
+	slot.m_prev = &timer;
+}
+
+void sock::TimerWheel::place(WheelTimer& timer)
+{
+	const auto expiry = timer.m_expiry;
+
+	// Already due, fire with the next processed tick.
+	if (expiry < m_current)
+	{
+		append(m_inner[m_current & (INNER_SLOTS - 1)], timer);
+		return;
+	}
+
+	const auto delta = expiry - m_current;
+
+	if (delta < INNER_SLOTS)
+	{
+		append(m_inner[expiry & (INNER_SLOTS - 1)], timer);
+		return;
+	}
+
+	for (size_t level = 0; level < OUTER_LEVELS; level++)
+	{
+		const auto shift = INNER_BITS + level * OUTER_BITS;
+
+		if (delta < uint64_t {1} << (shift + OUTER_BITS)
+		    || level == OUTER_LEVELS - 1)
+		{
+			append(m_outer[level][(expiry >> shift) & (OUTER_SLOTS - 1)], timer);
+			return;
+		}
+	}
+}
+
+void sock::TimerWheel::schedule(
+    WheelTimer& timer,
+    std::chrono::milliseconds delay
+)
+{
+	cancel(timer);
+
+	timer.m_wheel = this;
+	timer.m_expiry =
+	    std::min(ticks(Clock::now() + delay), m_current + RANGE - 1);
+	place(timer);
+	m_size++;
+}
+
+size_t sock::TimerWheel::cascade(size_t level)
+{
+	const auto shift = INNER_BITS + level * OUTER_BITS;
+	const auto index = (m_current >> shift) & (OUTER_SLOTS - 1);
+	auto& slot = m_outer[level][index];
+
+	// Timers of this slot now fit into a finer level.
+	while (slot.m_next != &slot)
+	{
+		auto& timer = *slot.m_next;
+		timer.unlink();
+		place(timer);
+	}
+
+	return index;
+}
+
+size_t sock::TimerWheel::advance(Clock::time_point now)
+{
+	// Deadlines round up, so the tick in progress has not expired yet.
+	const auto target = now <= m_start
+	                      ? 0
+	                      : static_cast<uint64_t>((now - m_start) / m_tick);
+	size_t fired = 0;
+
+	// `m_current` is the next tick to process.
+	while (m_current <= target)
+	{
+		const auto index = m_current & (INNER_SLOTS - 1);
+
+		if (index == 0)
+		{
+			for (size_t level = 0; level < OUTER_LEVELS; level++)
+			{
+				if (cascade(level) != 0)
+				{
+					break;
+				}
+			}
+		}
+
+		m_current++;
+
+		// Detach the slot first, callbacks may schedule into it again.
+		auto& slot = m_inner[index];
+
+		if (slot.m_next == &slot)
+		{
+			continue;
+		}
+
+		WheelTimer expired;
+		expired.m_next = slot.m_next;
+		expired.m_prev = slot.m_prev;
+		expired.m_next->m_prev = &expired;
+		expired.m_prev->m_next = &expired;
+		slot.m_next = &slot;
+		slot.m_prev = &slot;
+
+		while (expired.m_next != &expired)
+		{
+			auto& timer = *expired.m_next;
+			timer.unlink();
+			m_size--;
+			fired++;
+
+			if (timer.m_callback)
+			{
+				timer.m_callback();
+			}
+		}
+
+		expired.m_next = nullptr;
+		expired.m_prev = nullptr;
+	}
+
+	return fired;
+}
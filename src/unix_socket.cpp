@@ -1,10 +1,14 @@
+#include "sock/endpoint.hpp"
 #include "sock/internal/unix_socket.hpp"
 #include "sock/utils.hpp"
 #include <algorithm>
 #include <asm-generic/socket.h>
 #include <bits/types/struct_timeval.h>
+#include <cerrno>
+#include <fcntl.h>
 #include <iostream>
 #include <netdb.h>
+#include <poll.h>
 #include <string>
 #include <utility>
 
@@ -15,7 +19,11 @@ static constexpr int get_address_family(sock::Domain d)
 		case sock::Domain::INET:
 			return AF_INET;
 		case sock::Domain::UNSPEC:
-			return AF_INET;
+			return AF_INET6;
+		case sock::Domain::LOCAL:
+			return AF_UNIX;
+		case sock::Domain::INET6:
+			return AF_INET6;
 	}
 }
 
@@ -25,6 +33,8 @@ static constexpr int get_socket_type(sock::Type t)
 	{
 		case sock::Type::STREAM:
 			return SOCK_STREAM;
+		case sock::Type::SEQPACKET:
+			return SOCK_SEQPACKET;
 	}
 }
 
@@ -34,6 +44,10 @@ static constexpr int get_protocol(sock::Protocol p)
 	{
 		case sock::Protocol::TCP:
 			return IPPROTO_TCP;
+		case sock::Protocol::DEFAULT:
+			return 0;
+		case sock::Protocol::MPTCP:
+			return IPPROTO_MPTCP;
 	}
 }
 
@@ -73,16 +87,29 @@ static constexpr int get_option_name(sock::Option o)
 			return SO_SNDTIMEO;
 		case sock::Option::TYPE:
 			return SO_TYPE;
+		case sock::Option::REUSEPORT:
+			return SO_REUSEPORT;
 	}
 }
 
 static const auto _socket = socket;
 
+/**
+ * Lets IPv6 socket `fd` reach IPv4 peers through v4-mapped addresses.
+ */
+static auto dual_stack(int fd) -> bool
+{
+	const int off = 0;
+
+	return setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &off, sizeof(off)) == 0;
+}
+
 sock::internal::UnixSocket::UnixSocket(const sock::CtorArgs args)
 {
 	m_domain = get_address_family(args.domain);
 	m_socket_type = get_socket_type(args.type);
-	m_protocol = get_protocol(args.protocol);
+	// Local sockets know no protocols, whatever was asked for.
+	m_protocol = m_domain == AF_UNIX ? 0 : get_protocol(args.protocol);
 	m_flags = args.flags;
 
 	m_fd = _socket(
@@ -91,6 +118,27 @@ sock::internal::UnixSocket::UnixSocket(const sock::CtorArgs args)
 		m_protocol
 	);
 
+	// Kernels built without MPTCP, or with it switched off, still do TCP.
+	if (m_fd < 0 && m_protocol == IPPROTO_MPTCP)
+	{
+		m_protocol = IPPROTO_TCP;
+		m_fd = _socket(m_domain, m_socket_type, m_protocol);
+	}
+
+	if (args.domain == sock::Domain::UNSPEC)
+	{
+		// Hosts without IPv6 get plain IPv4 sockets.
+		if (m_fd < 0)
+		{
+			m_domain = AF_INET;
+			m_fd = _socket(m_domain, m_socket_type, m_protocol);
+		}
+		else
+		{
+			m_dual_stack = dual_stack(m_fd);
+		}
+	}
+
 	if (m_fd < 0)
 	{
 		m_status = sock::Status::SOCKET_CREATE_ERROR;
@@ -134,9 +182,7 @@ sock::internal::UnixSocket& sock::internal::UnixSocket::option(
 {
 	timeval to {
 		.tv_sec = static_cast<long>(timeout.count() / 1000),
-		.tv_usec = static_cast<long>(
-			timeout.count() - static_cast<long>(timeout.count() / 1000)*1000
-		)
+		.tv_usec = static_cast<long>((timeout.count() % 1000) * 1000)
 	};
 
 	const auto result = setsockopt(
@@ -155,40 +201,52 @@ sock::internal::UnixSocket& sock::internal::UnixSocket::option(
 	return *this;
 }
 
+auto sock::internal::UnixSocket::hints() const -> addrinfo
+{
+	addrinfo hints {};
+	hints.ai_family = m_dual_stack ? AF_UNSPEC : m_domain;
+	hints.ai_socktype = m_socket_type;
+	hints.ai_flags = m_flags;
+	hints.ai_protocol = m_protocol;
+
+	return hints;
+}
+
 static const auto _bind = bind;
 
 sock::internal::UnixSocket& sock::internal::UnixSocket::bind(sock::Address address)
 {
-	addrinfo hints;
+	const auto resolution = sock::internal::resolve(hints(), address);
 
-	memset(&hints, 0, sizeof(hints));
-	hints.ai_family = m_domain;
-	hints.ai_socktype = m_socket_type;
-	hints.ai_flags = m_flags;
-	hints.ai_protocol = m_protocol;
-	hints.ai_canonname = nullptr;
-	hints.ai_addr = nullptr;
-	hints.ai_next = nullptr;
+	if (resolution.status != sock::Status::GOOD)
+	{
+		m_status = m_domain == AF_UNIX ? sock::Status::BIND_ERROR : resolution.status;
+
+		return *this;
+	}
+
+	for (const auto& endpoint : resolution.endpoints)
+	{
+		if (bind(endpoint).m_status == sock::Status::GOOD)
+		{
+			break;
+		}
+	}
+
+	return *this;
+}
 
-	addrinfo* addr;
-	const auto s = getaddrinfo(address.host.empty() ? nullptr : address.host.data(), address.port.data(), &hints, &addr);
+sock::internal::UnixSocket& sock::internal::UnixSocket::bind(const sock::Endpoint& endpoint)
+{
+	const auto target = endpoint.for_family(m_domain);
 
-	if (s != 0) {
-		m_status = sock::Status::GETADDRINFO_ERROR;
+	if (_bind(m_fd, target.data(), target.size()) < 0)
+	{
+		m_status = sock::Status::BIND_ERROR;
 	}
 	else
 	{
-		for (auto rp = addr; rp != nullptr; rp = rp->ai_next) {
-			if (_bind(m_fd, rp->ai_addr, rp->ai_addrlen) < 0)
-			{
-				m_status = sock::Status::BIND_ERROR;
-			}
-			else
-			{
-				m_status = sock::Status::GOOD;
-				break;
-			}
-		}
+		m_status = sock::Status::GOOD;
 	}
 
 	return *this;
@@ -210,42 +268,172 @@ static const auto _connect = connect;
 
 sock::internal::UnixSocket& sock::internal::UnixSocket::connect(sock::Address address)
 {
-	addrinfo hints;
+	const auto resolution = sock::internal::resolve(hints(), address);
 
-	memset(&hints, 0, sizeof(hints));
-	hints.ai_family = m_domain;
-	hints.ai_socktype = m_socket_type;
-	hints.ai_flags = m_flags;
-	hints.ai_protocol = m_protocol;
-	hints.ai_canonname = nullptr;
-	hints.ai_addr = nullptr;
-	hints.ai_next = nullptr;
+	if (resolution.status != sock::Status::GOOD)
+	{
+		m_status = m_domain == AF_UNIX ? sock::Status::CONNECT_ERROR : resolution.status;
+
+		return *this;
+	}
+
+	for (const auto& endpoint : resolution.endpoints)
+	{
+		if (connect(endpoint).m_status == sock::Status::GOOD)
+		{
+			break;
+		}
+	}
 
-	addrinfo* addr;
-	const auto s = getaddrinfo(address.host.empty() ? nullptr : address.host.data(), address.port.data(), &hints, &addr);
+	return *this;
+}
+
+sock::internal::UnixSocket& sock::internal::UnixSocket::connect(const sock::Endpoint& endpoint)
+{
+	const auto target = endpoint.for_family(m_domain);
 
-	if (s != 0) {
-		m_status = sock::Status::GETADDRINFO_ERROR;
+	if (_connect(m_fd, target.data(), target.size()) < 0)
+	{
+		m_status = sock::Status::CONNECT_ERROR;
 	}
 	else
 	{
-		for (auto rp = addr; rp != nullptr; rp = rp->ai_next) {
+		m_status = sock::Status::GOOD;
+	}
 
-			if (_connect(m_fd, rp->ai_addr, rp->ai_addrlen) < 0)
+	return *this;
+}
+
+sock::internal::UnixSocket& sock::internal::UnixSocket::connect(
+	sock::Address address,
+	std::chrono::milliseconds timeout
+)
+{
+	// Local connects either succeed or fail right away.
+	if (m_domain == AF_UNIX)
+	{
+		return connect(address);
+	}
+
+	const auto resolution = sock::internal::resolve(hints(), address);
+
+	if (resolution.status != sock::Status::GOOD)
+	{
+		m_status = resolution.status;
+
+		return *this;
+	}
+
+	const auto flags = fcntl(m_fd, F_GETFL, 0);
+	bool attempted = false;
+
+	m_status = sock::Status::CONNECT_ERROR;
+
+	for (const auto& endpoint : resolution.endpoints)
+	{
+		const auto target = endpoint.for_family(m_domain);
+
+		// What a socket is good for after a failed or abandoned connect
+		// is unspecified, every further attempt gets a fresh one.
+		if (attempted)
+		{
+			close(m_fd);
+			m_fd = _socket(target.family(), m_socket_type, m_protocol);
+
+			if (m_fd < 0)
 			{
-				m_status = sock::Status::CONNECT_ERROR;
+				m_status = sock::Status::SOCKET_CREATE_ERROR;
+				break;
 			}
-			else
+
+			if (m_dual_stack)
 			{
-				m_status = sock::Status::GOOD;
-				break;
+				dual_stack(m_fd);
 			}
 		}
+
+		attempted = true;
+		fcntl(m_fd, F_SETFL, flags | O_NONBLOCK);
+
+		if (_connect(m_fd, target.data(), target.size()) == 0)
+		{
+			m_status = sock::Status::GOOD;
+			break;
+		}
+
+		if (errno != EINPROGRESS)
+		{
+			m_status = sock::Status::CONNECT_ERROR;
+			continue;
+		}
+
+		pollfd pending {.fd = m_fd, .events = POLLOUT, .revents = 0};
+		int ready;
+
+		do
+		{
+			ready = poll(
+				&pending,
+				1,
+				timeout.count() > 0 ? static_cast<int>(timeout.count()) : -1
+			);
+		} while (ready < 0 && errno == EINTR);
+
+		if (ready == 0)
+		{
+			m_status = sock::Status::TIMED_OUT;
+			continue;
+		}
+
+		int error = 0;
+		socklen_t size = sizeof(error);
+		getsockopt(m_fd, SOL_SOCKET, SO_ERROR, &error, &size);
+
+		if (ready > 0 && error == 0)
+		{
+			m_status = sock::Status::GOOD;
+			break;
+		}
+
+		m_status = sock::Status::CONNECT_ERROR;
+	}
+
+	if (m_fd >= 0)
+	{
+		fcntl(m_fd, F_SETFL, flags);
 	}
 
 	return *this;
 }
 
+std::pair<sock::internal::UnixSocket, sock::internal::UnixSocket>
+    sock::internal::UnixSocket::pair(const sock::CtorArgs args)
+{
+	int fds[2] {-1, -1};
+	std::pair<UnixSocket, UnixSocket> ends;
+
+	if (::socketpair(AF_UNIX, get_socket_type(args.type), 0, fds) < 0)
+	{
+		ends.first.m_status = sock::Status::SOCKET_CREATE_ERROR;
+		ends.second.m_status = sock::Status::SOCKET_CREATE_ERROR;
+
+		return ends;
+	}
+
+	const auto adopt = [&args](UnixSocket& end, int fd)
+	{
+		end.m_fd = fd;
+		end.m_domain = AF_UNIX;
+		end.m_socket_type = get_socket_type(args.type);
+		end.m_flags = args.flags;
+	};
+
+	adopt(ends.first, fds[0]);
+	adopt(ends.second, fds[1]);
+
+	return ends;
+}
+
 static const auto _accept = accept;
 
 sock::internal::UnixSocket sock::internal::UnixSocket::accept()
@@ -303,3 +491,16 @@ void sock::internal::UnixSocket::shutdown()
 		m_status = sock::Status::SHUTDOWN_ERROR;
 	}
 }
+
+sock::internal::UnixSocket& sock::internal::UnixSocket::non_blocking(bool enable)
+{
+	const auto flags = fcntl(m_fd, F_GETFL, 0);
+
+	if (flags < 0
+	    || fcntl(m_fd, F_SETFL, enable ? flags | O_NONBLOCK : flags & ~O_NONBLOCK) < 0)
+	{
+		m_status = sock::Status::OPTION_SET_ERROR;
+	}
+
+	return *this;
+}
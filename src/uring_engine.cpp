@@ -0,0 +1,745 @@
+#include "sock/internal/uring_engine.hpp"
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Receive buffers are provided to the kernel in this group.
+static constexpr uint16_t BUFFER_GROUP = 0;
+
+template<class T>
+static auto load_acquire(T* ptr) -> T
+{
+	return std::atomic_ref<T> {*ptr}.load(std::memory_order_acquire);
+}
+
+template<class T>
+static auto store_release(T* ptr, T value) -> void
+{
+	std::atomic_ref<T> {*ptr}.store(value, std::memory_order_release);
+}
+
+static auto io_uring_setup(unsigned entries, io_uring_params* params) -> int
+{
+	return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+static auto io_uring_register(
+    int fd,
+    unsigned opcode,
+    const void* arg,
+    unsigned nr_args
+) -> int
+{
+	return static_cast<int>(
+	    syscall(__NR_io_uring_register, fd, opcode, arg, nr_args)
+	);
+}
+
+sock::internal::UringEngine::UringEngine(EngineOptions options) :
+    m_options {options}
+{
+	io_uring_params params {};
+	params.flags = IORING_SETUP_SUBMIT_ALL | IORING_SETUP_COOP_TASKRUN;
+
+	m_ring_fd = io_uring_setup(m_options.queue_depth, &params);
+
+	if (m_ring_fd < 0 && errno == EINVAL)
+	{
+		params = {};
+		m_ring_fd = io_uring_setup(m_options.queue_depth, &params);
+	}
+
+	// Timed waits need EXT_ARG, sockets need FAST_POLL to avoid punting
+	// every operation to a worker thread.
+	constexpr auto required = IORING_FEAT_EXT_ARG | IORING_FEAT_FAST_POLL;
+
+	if (m_ring_fd < 0 || (params.features & required) != required)
+	{
+		m_status = sock::Status::IO_ENGINE_ERROR;
+		return;
+	}
+
+	m_sq_ring_size =
+	    params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	m_cq_ring_size =
+	    params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+	{
+		m_sq_ring_size = m_cq_ring_size =
+		    std::max(m_sq_ring_size, m_cq_ring_size);
+	}
+
+	m_sq_ring = mmap(
+	    nullptr,
+	    m_sq_ring_size,
+	    PROT_READ | PROT_WRITE,
+	    MAP_SHARED | MAP_POPULATE,
+	    m_ring_fd,
+	    IORING_OFF_SQ_RING
+	);
+
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+	{
+		m_cq_ring = m_sq_ring;
+	}
+	else
+	{
+		m_cq_ring = mmap(
+		    nullptr,
+		    m_cq_ring_size,
+		    PROT_READ | PROT_WRITE,
+		    MAP_SHARED | MAP_POPULATE,
+		    m_ring_fd,
+		    IORING_OFF_CQ_RING
+		);
+	}
+
+	m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+	auto sqes = mmap(
+	    nullptr,
+	    m_sqes_size,
+	    PROT_READ | PROT_WRITE,
+	    MAP_SHARED | MAP_POPULATE,
+	    m_ring_fd,
+	    IORING_OFF_SQES
+	);
+
+	if (m_sq_ring == MAP_FAILED || m_cq_ring == MAP_FAILED
+	    || sqes == MAP_FAILED)
+	{
+		m_status = sock::Status::IO_ENGINE_ERROR;
+		return;
+	}
+
+	auto sq = static_cast<char*>(m_sq_ring);
+	m_sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+	m_sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+	m_sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+	m_sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+	m_sq_entries = params.sq_entries;
+	m_sq_local_tail = *m_sq_tail;
+	m_sqes = static_cast<io_uring_sqe*>(sqes);
+
+	auto cq = static_cast<char*>(m_cq_ring);
+	m_cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+	m_cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+	m_cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+	m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+	// Provided buffer ring: the kernel takes a buffer from it for every
+	// multishot receive completion, `recycle()` hands it back.
+	m_buf_ring_size = m_options.buffer_count * sizeof(io_uring_buf);
+	auto ring = mmap(
+	    nullptr,
+	    m_buf_ring_size,
+	    PROT_READ | PROT_WRITE,
+	    MAP_PRIVATE | MAP_ANONYMOUS,
+	    -1,
+	    0
+	);
+
+	if (ring == MAP_FAILED)
+	{
+		m_buf_ring = nullptr;
+		m_status = sock::Status::IO_ENGINE_ERROR;
+		return;
+	}
+
+	m_buf_ring = static_cast<io_uring_buf_ring*>(ring);
+
+	io_uring_buf_reg reg {};
+	reg.ring_addr = reinterpret_cast<uint64_t>(m_buf_ring);
+	reg.ring_entries = m_options.buffer_count;
+	reg.bgid = BUFFER_GROUP;
+
+	if (io_uring_register(m_ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0)
+	{
+		m_status = sock::Status::IO_ENGINE_ERROR;
+		return;
+	}
+
+	m_buffers.resize(
+	    static_cast<size_t>(m_options.buffer_count) * m_options.buffer_size
+	);
+
+	for (unsigned i = 0; i < m_options.buffer_count; i++)
+	{
+		recycle(static_cast<uint16_t>(i));
+	}
+}
+
+sock::internal::UringEngine::~UringEngine()
+{
+	if (m_buf_ring != nullptr)
+	{
+		munmap(m_buf_ring, m_buf_ring_size);
+	}
+
+	if (m_sqes != nullptr)
+	{
+		munmap(m_sqes, m_sqes_size);
+	}
+
+	if (m_cq_ring != nullptr && m_cq_ring != MAP_FAILED
+	    && m_cq_ring != m_sq_ring)
+	{
+		munmap(m_cq_ring, m_cq_ring_size);
+	}
+
+	if (m_sq_ring != nullptr && m_sq_ring != MAP_FAILED)
+	{
+		munmap(m_sq_ring, m_sq_ring_size);
+	}
+
+	if (m_ring_fd >= 0)
+	{
+		::close(m_ring_fd);
+	}
+}
+
+void sock::internal::UringEngine::recycle(uint16_t buffer_id)
+{
+	const auto tail = m_buf_ring->tail;
+	const auto mask = m_options.buffer_count - 1;
+
+	// Not `m_buf_ring->bufs`: in C++ the uapi flexible array member is
+	// preceded by an empty struct and lands at a wrong offset.
+	auto& buf = reinterpret_cast<io_uring_buf*>(m_buf_ring)[tail & mask];
+
+	// Fields are set one by one: the first entry overlays the ring tail.
+	buf.addr = reinterpret_cast<uint64_t>(
+	    m_buffers.data()
+	    + static_cast<size_t>(buffer_id) * m_options.buffer_size
+	);
+	buf.len = m_options.buffer_size;
+	buf.bid = buffer_id;
+
+	store_release(&m_buf_ring->tail, static_cast<uint16_t>(tail + 1));
+}
+
+int sock::internal::UringEngine::enter(
+    unsigned submit,
+    unsigned wait,
+    unsigned flags,
+    void* arg,
+    size_t arg_size
+)
+{
+	return static_cast<int>(syscall(
+	    __NR_io_uring_enter,
+	    m_ring_fd,
+	    submit,
+	    wait,
+	    flags,
+	    arg,
+	    arg_size
+	));
+}
+
+io_uring_sqe* sock::internal::UringEngine::next_sqe()
+{
+	if (m_sq_local_tail - load_acquire(m_sq_head) >= m_sq_entries)
+	{
+		submit();
+
+		if (m_sq_local_tail - load_acquire(m_sq_head) >= m_sq_entries)
+		{
+			return nullptr;
+		}
+	}
+
+	const auto index = m_sq_local_tail & m_sq_mask;
+	auto sqe = &m_sqes[index];
+
+	std::memset(sqe, 0, sizeof(*sqe));
+	m_sq_array[index] = index;
+	m_sq_local_tail++;
+	m_to_submit++;
+
+	return sqe;
+}
+
+void sock::internal::UringEngine::prepare(
+    uint64_t id,
+    Operation& op,
+    bool link
+)
+{
+	auto sqe = next_sqe();
+
+	if (sqe == nullptr)
+	{
+		m_status = sock::Status::IO_ENGINE_ERROR;
+		return;
+	}
+
+	sqe->opcode = op.opcode;
+	sqe->user_data = id;
+	sqe->fd = op.fd;
+
+	const auto fixed = m_fixed_files.find(op.fd);
+
+	if (fixed != m_fixed_files.end() && op.opcode != IORING_OP_CLOSE)
+	{
+		sqe->fd = fixed->second;
+		sqe->flags |= IOSQE_FIXED_FILE;
+	}
+
+	switch (op.opcode)
+	{
+		case IORING_OP_ACCEPT:
+			sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+			sqe->accept_flags = SOCK_CLOEXEC;
+			break;
+		case IORING_OP_CONNECT:
+			sqe->addr = reinterpret_cast<uint64_t>(&op.address);
+			sqe->off = op.address_size;
+			break;
+		case IORING_OP_RECV:
+			sqe->ioprio = IORING_RECV_MULTISHOT;
+			sqe->flags |= IOSQE_BUFFER_SELECT;
+			sqe->buf_group = BUFFER_GROUP;
+			break;
+		case IORING_OP_SEND:
+			sqe->addr = reinterpret_cast<uint64_t>(op.payload.data() + op.sent);
+			sqe->len = op.payload.size() - op.sent;
+			// WAITALL makes the kernel retry short sends itself, which keeps
+			// linked chains intact.
+			sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+			break;
+		case IORING_OP_WRITE_FIXED:
+			sqe->addr = reinterpret_cast<uint64_t>(op.payload.data() + op.sent);
+			sqe->len = op.payload.size() - op.sent;
+			sqe->buf_index = op.buffer;
+			break;
+		case IORING_OP_SHUTDOWN:
+			sqe->len = SHUT_RDWR;
+			break;
+		default:
+			break;
+	}
+
+	if (link)
+	{
+		sqe->flags |= IOSQE_IO_LINK;
+	}
+}
+
+void sock::internal::UringEngine::start(
+    std::unique_ptr<Operation> op,
+    bool link
+)
+{
+	const auto id = m_next_id++;
+
+	prepare(id, *op, link);
+	m_operations.emplace(id, std::move(op));
+}
+
+sock::IoEngine&
+    sock::internal::UringEngine::accept(int fd, CompletionHandler handler)
+{
+	start(std::make_unique<Operation>(Operation {
+	    .opcode = IORING_OP_ACCEPT,
+	    .fd = fd,
+	    .handler = std::move(handler),
+	}));
+
+	return *this;
+}
+
+sock::IoEngine& sock::internal::UringEngine::connect(
+    int fd,
+    const sockaddr* address,
+    socklen_t address_size,
+    CompletionHandler handler
+)
+{
+	auto op = std::make_unique<Operation>(Operation {
+	    .opcode = IORING_OP_CONNECT,
+	    .fd = fd,
+	    .handler = std::move(handler),
+	    .address_size = address_size,
+	});
+	std::memcpy(&op->address, address, address_size);
+
+	start(std::move(op));
+
+	return *this;
+}
+
+sock::IoEngine&
+    sock::internal::UringEngine::receive(int fd, CompletionHandler handler)
+{
+	start(std::make_unique<Operation>(Operation {
+	    .opcode = IORING_OP_RECV,
+	    .fd = fd,
+	    .handler = std::move(handler),
+	}));
+
+	return *this;
+}
+
+sock::IoEngine& sock::internal::UringEngine::send(
+    int fd,
+    std::string_view payload,
+    CompletionHandler handler,
+    bool link
+)
+{
+	start(
+	    std::make_unique<Operation>(Operation {
+	        .opcode = IORING_OP_SEND,
+	        .fd = fd,
+	        .handler = std::move(handler),
+	        .payload = payload,
+	    }),
+	    link
+	);
+
+	return *this;
+}
+
+sock::IoEngine& sock::internal::UringEngine::send_fixed(
+    int fd,
+    unsigned buffer,
+    std::string_view payload,
+    CompletionHandler handler,
+    bool link
+)
+{
+	start(
+	    std::make_unique<Operation>(Operation {
+	        .opcode = IORING_OP_WRITE_FIXED,
+	        .fd = fd,
+	        .handler = std::move(handler),
+	        .payload = payload,
+	        .buffer = buffer,
+	    }),
+	    link
+	);
+
+	return *this;
+}
+
+sock::IoEngine& sock::internal::UringEngine::shutdown(
+    int fd,
+    CompletionHandler handler,
+    bool link
+)
+{
+	start(
+	    std::make_unique<Operation>(Operation {
+	        .opcode = IORING_OP_SHUTDOWN,
+	        .fd = fd,
+	        .handler = std::move(handler),
+	    }),
+	    link
+	);
+
+	return *this;
+}
+
+sock::IoEngine&
+    sock::internal::UringEngine::close(int fd, CompletionHandler handler)
+{
+	const auto fixed = m_fixed_files.find(fd);
+
+	// A registered descriptor keeps the socket open, drop it from the
+	// table first.
+	if (fixed != m_fixed_files.end())
+	{
+		const int removed = -1;
+		io_uring_files_update update {};
+		update.offset = static_cast<uint32_t>(fixed->second);
+		update.fds = reinterpret_cast<uint64_t>(&removed);
+
+		io_uring_register(
+		    m_ring_fd,
+		    IORING_REGISTER_FILES_UPDATE,
+		    &update,
+		    1
+		);
+		m_fixed_files.erase(fixed);
+	}
+
+	start(std::make_unique<Operation>(Operation {
+	    .opcode = IORING_OP_CLOSE,
+	    .fd = fd,
+	    .handler = std::move(handler),
+	}));
+
+	return *this;
+}
+
+sock::IoEngine& sock::internal::UringEngine::cancel(int fd)
+{
+	for (auto& [id, op] : m_operations)
+	{
+		if (op->fd == fd)
+		{
+			op->cancelled = true;
+		}
+	}
+
+	auto sqe = next_sqe();
+
+	if (sqe == nullptr)
+	{
+		m_status = sock::Status::IO_ENGINE_ERROR;
+		return *this;
+	}
+
+	sqe->opcode = IORING_OP_ASYNC_CANCEL;
+	sqe->fd = fd;
+	sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+	sqe->user_data = 0;
+
+	const auto fixed = m_fixed_files.find(fd);
+
+	if (fixed != m_fixed_files.end())
+	{
+		sqe->fd = fixed->second;
+		sqe->cancel_flags |= IORING_ASYNC_CANCEL_FD_FIXED;
+	}
+
+	return *this;
+}
+
+bool sock::internal::UringEngine::register_files(std::span<const int> fds)
+{
+	// Operations in flight refer to slots of the current table.
+	submit();
+
+	if (!m_fixed_files.empty())
+	{
+		io_uring_register(m_ring_fd, IORING_UNREGISTER_FILES, nullptr, 0);
+		m_fixed_files.clear();
+	}
+
+	if (io_uring_register(m_ring_fd, IORING_REGISTER_FILES, fds.data(), fds.size())
+	    < 0)
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < fds.size(); i++)
+	{
+		m_fixed_files[fds[i]] = static_cast<int>(i);
+	}
+
+	return true;
+}
+
+bool sock::internal::UringEngine::register_buffers(
+    std::span<const std::span<char>> buffers
+)
+{
+	if (m_buffers_registered)
+	{
+		io_uring_register(m_ring_fd, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+		m_buffers_registered = false;
+	}
+
+	std::vector<iovec> iov;
+	iov.reserve(buffers.size());
+
+	for (const auto& buffer : buffers)
+	{
+		iov.push_back({.iov_base = buffer.data(), .iov_len = buffer.size()});
+	}
+
+	m_buffers_registered = io_uring_register(
+	                           m_ring_fd,
+	                           IORING_REGISTER_BUFFERS,
+	                           iov.data(),
+	                           iov.size()
+	                       )
+	                    == 0;
+
+	return m_buffers_registered;
+}
+
+size_t sock::internal::UringEngine::submit()
+{
+	if (m_to_submit == 0)
+	{
+		return 0;
+	}
+
+	store_release(m_sq_tail, m_sq_local_tail);
+
+	const auto submitted = enter(m_to_submit, 0, 0, nullptr, 0);
+
+	if (submitted < 0)
+	{
+		if (errno != EINTR && errno != EBUSY && errno != EAGAIN)
+		{
+			m_status = sock::Status::IO_ENGINE_ERROR;
+		}
+
+		return 0;
+	}
+
+	m_to_submit -= submitted;
+
+	return submitted;
+}
+
+size_t sock::internal::UringEngine::run_once(std::chrono::milliseconds timeout)
+{
+	store_release(m_sq_tail, m_sq_local_tail);
+
+	const bool ready = *m_cq_head != load_acquire(m_cq_tail);
+	const unsigned wait = ready || timeout.count() == 0 ? 0 : 1;
+
+	__kernel_timespec ts {
+	    .tv_sec = timeout.count() / 1000,
+	    .tv_nsec = (timeout.count() % 1000) * 1000000,
+	};
+	io_uring_getevents_arg arg {};
+	arg.ts = reinterpret_cast<uint64_t>(&ts);
+
+	// GETEVENTS is passed even when not waiting so that deferred task
+	// work (COOP_TASKRUN) gets to run.
+	const auto submitted = wait && timeout.count() > 0
+	                         ? enter(
+	                               m_to_submit,
+	                               wait,
+	                               IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+	                               &arg,
+	                               sizeof(arg)
+	                           )
+	                         : enter(
+	                               m_to_submit,
+	                               wait,
+	                               IORING_ENTER_GETEVENTS,
+	                               nullptr,
+	                               _NSIG / 8
+	                           );
+
+	if (submitted >= 0)
+	{
+		m_to_submit -= std::min<unsigned>(submitted, m_to_submit);
+	}
+	else if (errno != ETIME && errno != EINTR && errno != EBUSY)
+	{
+		m_status = sock::Status::IO_ENGINE_ERROR;
+	}
+
+	size_t dispatched = 0;
+
+	for (auto head = *m_cq_head; head != load_acquire(m_cq_tail);
+	     head = *m_cq_head)
+	{
+		const auto cqe = m_cqes[head & m_cq_mask];
+
+		store_release(m_cq_head, head + 1);
+		dispatch(cqe);
+		dispatched++;
+	}
+
+	return dispatched;
+}
+
+void sock::internal::UringEngine::dispatch(const io_uring_cqe& cqe)
+{
+	const bool has_buffer = cqe.flags & IORING_CQE_F_BUFFER;
+	const auto buffer_id =
+	    static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+	const auto it = m_operations.find(cqe.user_data);
+
+	if (cqe.user_data == 0 || it == m_operations.end())
+	{
+		if (has_buffer)
+		{
+			recycle(buffer_id);
+		}
+
+		return;
+	}
+
+	const auto id = it->first;
+	auto& op = *it->second;
+	bool more = cqe.flags & IORING_CQE_F_MORE;
+
+	switch (op.opcode)
+	{
+		case IORING_OP_ACCEPT:
+			// Kernel may end a multishot request on its own, e.g. when the
+			// completion queue overflows.
+			if (!more && cqe.res >= 0 && !op.cancelled)
+			{
+				prepare(id, op, false);
+				more = true;
+			}
+
+			break;
+		case IORING_OP_RECV:
+			if (cqe.res == -ENOBUFS && !op.cancelled)
+			{
+				prepare(id, op, false);
+				return;
+			}
+
+			if (!more && cqe.res > 0 && !op.cancelled)
+			{
+				prepare(id, op, false);
+				more = true;
+			}
+
+			break;
+		case IORING_OP_SEND:
+		case IORING_OP_WRITE_FIXED:
+			if (cqe.res > 0)
+			{
+				op.sent += cqe.res;
+
+				if (static_cast<size_t>(op.sent) < op.payload.size())
+				{
+					prepare(id, op, false);
+					return;
+				}
+			}
+
+			break;
+		default:
+			break;
+	}
+
+	const auto result = (op.opcode == IORING_OP_SEND
+	                     || op.opcode == IORING_OP_WRITE_FIXED)
+	                         && cqe.res >= 0
+	                      ? op.sent
+	                      : cqe.res;
+	const auto data = has_buffer && cqe.res > 0
+	                    ? std::string_view {
+	                          m_buffers.data()
+	                              + static_cast<size_t>(buffer_id)
+	                                    * m_options.buffer_size,
+	                          static_cast<size_t>(cqe.res)}
+	                    : std::string_view {};
+
+	if (more)
+	{
+		op.handler({.result = result, .data = data, .more = true});
+	}
+	else
+	{
+		// Handler is moved out so it may queue operations freely.
+		auto owned = std::move(it->second);
+		m_operations.erase(it);
+		owned->handler({.result = result, .data = data, .more = false});
+	}
+
+	if (has_buffer)
+	{
+		recycle(buffer_id);
+	}
+}
@@ -1,3 +1,4 @@
+#include "sock/endpoint.hpp"
 #include "sock/internal/windows_socket.hpp"
 #include "sock/utils.hpp"
 #include <algorithm>
@@ -13,6 +14,12 @@ static constexpr auto get_address_family(sock::Domain d)
 			return AF_INET;
 		case sock::Domain::UNSPEC:
 			return AF_UNSPEC;
+		case sock::Domain::LOCAL:
+			// Addresses are still resolved with getaddrinfo(), which knows
+			// no local paths.
+			return AF_UNIX;
+		case sock::Domain::INET6:
+			return AF_INET6;
 	}
 }
 
@@ -22,6 +29,8 @@ static constexpr auto get_socket_type(sock::Type t)
 	{
 		case sock::Type::STREAM:
 			return SOCK_STREAM;
+		case sock::Type::SEQPACKET:
+			return SOCK_SEQPACKET;
 	}
 }
 
@@ -30,7 +39,10 @@ static constexpr auto get_protocol(sock::Protocol p)
 	switch (p)
 	{
 		case sock::Protocol::TCP:
+		case sock::Protocol::MPTCP:
 			return IPPROTO_TCP;
+		case sock::Protocol::DEFAULT:
+			return static_cast<decltype(IPPROTO_TCP)>(0);
 	}
 }
 
@@ -70,6 +82,9 @@ static constexpr auto get_option_name(sock::Option o)
 			return SO_SNDTIMEO;
 		case sock::Option::TYPE:
 			return SO_TYPE;
+		// Winsock's SO_REUSEADDR already lets several sockets share a port.
+		case sock::Option::REUSEPORT:
+			return SO_REUSEADDR;
 			break;
 	}
 }
@@ -149,37 +164,37 @@ const auto _bind = bind;
 sock::internal::WindowsSocket&
     sock::internal::WindowsSocket::bind(sock::Address address)
 {
-	addrinfo* info {nullptr};
-
-	// Resolve the local address and port to be used by the server
-	const auto getaddrinfo_result = getaddrinfo(
-	    address.host.length() > 0 ? address.host.data() : NULL,
-	    address.port.data(),
-	    &m_hints,
-	    &info
-	);
+	const auto resolution = sock::internal::resolve(m_hints, address);
 
-	if (getaddrinfo_result != 0)
+	if (resolution.status != sock::Status::GOOD)
 	{
-		m_status = sock::Status::GETADDRINFO_ERROR;
+		m_status = resolution.status;
+
+		return *this;
 	}
-	else
+
+	for (const auto& endpoint : resolution.endpoints)
 	{
-		for (auto rp = info; rp != nullptr; rp = rp->ai_next)
+		if (bind(endpoint).m_status == sock::Status::GOOD)
 		{
-			if (_bind(m_sock, rp->ai_addr, rp->ai_addrlen) == SOCKET_ERROR)
-			{
-				m_status = sock::Status::BIND_ERROR;
-			}
-			else
-			{
-				m_status = sock::Status::GOOD;
-				break;
-			}
+			break;
 		}
 	}
 
-	freeaddrinfo(info);
+	return *this;
+}
+
+sock::internal::WindowsSocket&
+    sock::internal::WindowsSocket::bind(const sock::Endpoint& endpoint)
+{
+	if (_bind(m_sock, endpoint.data(), endpoint.size()) == SOCKET_ERROR)
+	{
+		m_status = sock::Status::BIND_ERROR;
+	}
+	else
+	{
+		m_status = sock::Status::GOOD;
+	}
 
 	return *this;
 }
@@ -206,36 +221,135 @@ const auto _connect = connect;
 sock::internal::WindowsSocket&
     sock::internal::WindowsSocket::connect(sock::Address address)
 {
-	addrinfo* info {nullptr};
+	const auto resolution = sock::internal::resolve(m_hints, address);
 
-	// Resolve the local address and port to be used by the server
-	const auto getaddrinfo_result = getaddrinfo(
-	    address.host.length() > 0 ? address.host.data() : NULL,
-	    address.port.data(),
-	    &m_hints,
-	    &info
-	);
+	if (resolution.status != sock::Status::GOOD)
+	{
+		m_status = resolution.status;
+
+		return *this;
+	}
 
-	if (getaddrinfo_result != 0)
+	// Try to connect to ip until succeded or failed
+	for (const auto& endpoint : resolution.endpoints)
 	{
-		m_status = sock::Status::GETADDRINFO_ERROR;
+		if (connect(endpoint).m_status == sock::Status::GOOD)
+		{
+			break;
+		}
+	}
+
+	return *this;
+}
+
+sock::internal::WindowsSocket&
+    sock::internal::WindowsSocket::connect(const sock::Endpoint& endpoint)
+{
+	if (_connect(m_sock, endpoint.data(), endpoint.size()) == SOCKET_ERROR)
+	{
+		m_status = sock::Status::CONNECT_ERROR;
 	}
 	else
 	{
-		// Try to connect to ip until succeded or failed
-		for (auto ptr = info; ptr != nullptr; ptr = ptr->ai_next)
+		m_status = sock::Status::GOOD;
+	}
+
+	return *this;
+}
+
+sock::internal::WindowsSocket& sock::internal::WindowsSocket::connect(
+    sock::Address address,
+    std::chrono::milliseconds timeout
+)
+{
+	const std::string host {address.host};
+	const std::string port {address.port};
+	addrinfo* info {nullptr};
+
+	if (getaddrinfo(
+	        host.empty() ? NULL : host.c_str(),
+	        port.c_str(),
+	        &m_hints,
+	        &info
+	    )
+	    != 0)
+	{
+		m_status = sock::Status::GETADDRINFO_ERROR;
+
+		return *this;
+	}
+
+	bool attempted = false;
+	m_status = sock::Status::CONNECT_ERROR;
+
+	for (auto ptr = info; ptr != nullptr; ptr = ptr->ai_next)
+	{
+		if (attempted)
 		{
-			if (_connect(m_sock, ptr->ai_addr, (int) ptr->ai_addrlen)
-			    == SOCKET_ERROR)
-			{
-				m_status = sock::Status::CONNECT_ERROR;
-			}
-			else
+			closesocket(m_sock);
+			m_sock = socket(ptr->ai_family, ptr->ai_socktype, ptr->ai_protocol);
+
+			if (m_sock == INVALID_SOCKET)
 			{
-				m_status = sock::Status::GOOD;
+				m_status = sock::Status::SOCKET_CREATE_ERROR;
 				break;
 			}
 		}
+
+		attempted = true;
+		u_long mode = 1;
+		ioctlsocket(m_sock, FIONBIO, &mode);
+
+		if (_connect(m_sock, ptr->ai_addr, (int) ptr->ai_addrlen) == 0)
+		{
+			m_status = sock::Status::GOOD;
+			break;
+		}
+
+		if (WSAGetLastError() != WSAEWOULDBLOCK)
+		{
+			m_status = sock::Status::CONNECT_ERROR;
+			continue;
+		}
+
+		fd_set writable;
+		fd_set failed;
+		FD_ZERO(&writable);
+		FD_ZERO(&failed);
+		FD_SET(m_sock, &writable);
+		FD_SET(m_sock, &failed);
+
+		timeval to {
+		    .tv_sec = static_cast<long>(timeout.count() / 1000),
+		    .tv_usec = static_cast<long>((timeout.count() % 1000) * 1000)};
+
+		const auto ready = select(
+		    0,
+		    NULL,
+		    &writable,
+		    &failed,
+		    timeout.count() > 0 ? &to : NULL
+		);
+
+		if (ready == 0)
+		{
+			m_status = sock::Status::TIMED_OUT;
+			continue;
+		}
+
+		if (ready > 0 && FD_ISSET(m_sock, &writable))
+		{
+			m_status = sock::Status::GOOD;
+			break;
+		}
+
+		m_status = sock::Status::CONNECT_ERROR;
+	}
+
+	if (m_sock != INVALID_SOCKET)
+	{
+		u_long mode = 0;
+		ioctlsocket(m_sock, FIONBIO, &mode);
 	}
 
 	freeaddrinfo(info);
@@ -303,3 +417,20 @@ void sock::internal::WindowsSocket::shutdown()
 		m_status = sock::Status::GOOD;
 	}
 }
+
+sock::internal::WindowsSocket&
+    sock::internal::WindowsSocket::non_blocking(bool enable)
+{
+	u_long mode = enable ? 1 : 0;
+
+	if (ioctlsocket(m_sock, FIONBIO, &mode) == SOCKET_ERROR)
+	{
+		m_status = sock::Status::OPTION_SET_ERROR;
+	}
+	else
+	{
+		m_status = sock::Status::GOOD;
+	}
+
+	return *this;
+}
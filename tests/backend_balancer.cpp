@@ -0,0 +1,134 @@
+#include "sock/backend_balancer.hpp"
+#include "sock/socket_factory.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+static constexpr sock::CtorArgs TCP {
+    .domain = sock::Domain::INET,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::TCP,
+    .flags = sock::Flags::PASSIVE,
+};
+
+static constexpr const char* PORTS[] {"19857", "19858", "19859", "19860"};
+
+/**
+ * Backends whose connections complete in the backlog, never accepted.
+ */
+struct Backends
+{
+	Backends()
+	{
+		for (const auto port : PORTS)
+		{
+			auto& server = servers.emplace_back(
+			    sock::SocketFactory::instance().create(TCP)
+			);
+			server.option(sock::Option::REUSEADDR, 1);
+			server.bind({.host = "127.0.0.1", .port = port});
+			server.listen(64);
+
+			endpoints.push_back(
+			    *sock::Endpoint::parse({.host = "127.0.0.1", .port = port})
+			);
+		}
+	}
+
+	std::vector<sock::Socket> servers;
+	std::vector<sock::Endpoint> endpoints;
+};
+
+GTEST_TEST(BackendBalancer, hashes_keys_consistently)
+{
+	Backends backends;
+	sock::BackendBalancer balancer {TCP, backends.endpoints};
+	std::vector<size_t> counts(balancer.size(), 0);
+
+	for (int i = 0; i < 10000; i++)
+	{
+		const auto key = "user:" + std::to_string(i);
+		const auto backend = balancer.pick(key);
+		ASSERT_EQ(backend, balancer.pick(key));
+		counts[backend]++;
+	}
+
+	// Evenly enough spread.
+	ASSERT_GT(*std::min_element(counts.begin(), counts.end()), 1500);
+	ASSERT_LT(*std::max_element(counts.begin(), counts.end()), 3500);
+
+	// Removing a backend only moves the keys it had.
+	auto fewer = backends.endpoints;
+	fewer.pop_back();
+	sock::BackendBalancer smaller {TCP, fewer};
+
+	for (int i = 0; i < 1000; i++)
+	{
+		const auto key = "user:" + std::to_string(i);
+
+		if (balancer.pick(key) != 3)
+		{
+			ASSERT_EQ(balancer.pick(key), smaller.pick(key));
+		}
+	}
+}
+
+GTEST_TEST(BackendBalancer, bounds_load_of_hot_keys)
+{
+	Backends backends;
+	sock::BackendBalancer balancer {TCP, backends.endpoints, {.load_factor = 1.25}};
+
+	const auto home = balancer.pick("hot");
+	std::vector<sock::BackendBalancer::Request> requests;
+
+	for (int i = 0; i < 12; i++)
+	{
+		requests.push_back(balancer.by_key("hot"));
+		ASSERT_EQ(sock::Status::GOOD, requests.back().status());
+	}
+
+	ASSERT_EQ(home, requests.front().backend());
+
+	// ceil(1.25 * 12 / 4)
+	for (size_t i = 0; i < balancer.size(); i++)
+	{
+		ASSERT_LE(balancer.stats(i).outstanding, 4);
+	}
+
+	ASSERT_EQ(4, balancer.stats(home).outstanding);
+
+	requests.clear();
+	ASSERT_EQ(home, balancer.pick("hot"));
+	ASSERT_EQ(12, balancer.stats(0).completed + balancer.stats(1).completed
+	                  + balancer.stats(2).completed + balancer.stats(3).completed);
+}
+
+GTEST_TEST(BackendBalancer, prefers_less_loaded_backends)
+{
+	Backends backends;
+	sock::BackendBalancer balancer {TCP, backends.endpoints};
+	std::vector<sock::BackendBalancer::Request> busy;
+
+	for (int i = 0; i < 3; i++)
+	{
+		busy.push_back(balancer.start(0));
+	}
+
+	// Two distinct choices out of four: the busy one never wins.
+	for (int i = 0; i < 200; i++)
+	{
+		ASSERT_NE(0, balancer.pick());
+	}
+
+	auto request = balancer.least_loaded();
+	ASSERT_EQ(sock::Status::GOOD, request.status());
+	ASSERT_EQ(1, balancer.stats(request.backend()).outstanding);
+
+	request.finish(false);
+	ASSERT_EQ(1, balancer.stats(request.backend()).failed);
+	ASSERT_EQ(0, balancer.stats(request.backend()).outstanding);
+
+	busy.front().finish(true);
+	ASSERT_GT(balancer.stats(0).latency_ns, 0);
+}
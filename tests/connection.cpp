@@ -0,0 +1,239 @@
+#include "sock/balancer.hpp"
+#include "sock/connection.hpp"
+#include "sock/runtime.hpp"
+#include "sock/socket_factory.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+static constexpr sock::CtorArgs TCP {
+    .domain = sock::Domain::INET,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::TCP,
+    .flags = sock::Flags::PASSIVE,
+};
+
+static auto receive_exactly(sock::Socket& socket, size_t size) -> std::string
+{
+	std::string received;
+	sock::Buffer buff;
+
+	while (received.size() < size)
+	{
+		socket.receive(buff);
+
+		if (buff.received_size() == 0)
+		{
+			break;
+		}
+
+		received += buff.view();
+	}
+
+	return received;
+}
+
+GTEST_TEST(Connection, migrates_with_buffered_input)
+{
+	sock::Runtime runtime {{.cores = 2}};
+
+	// Replies to each line with "<core>:<line>" and moves to the other
+	// core on "move".
+	runtime.listen(
+	    TCP,
+	    {.host = "127.0.0.1", .port = "18843"},
+	    [](sock::Core& core, sock::Socket&& socket)
+	    {
+		    core.adopt(std::make_shared<sock::Connection>(
+		        std::move(socket),
+		        [](sock::Connection& conn)
+		        {
+			        auto& input = conn.input();
+			        size_t end;
+
+			        while ((end = input.find('\n')) != std::string::npos)
+			        {
+				        const auto line = input.substr(0, end);
+				        input.erase(0, end + 1);
+
+				        auto& owner = *conn.core();
+				        conn.write(std::to_string(owner.index()) + ":" + line);
+
+				        if (line == "move")
+				        {
+					        owner.migrate(conn, (owner.index() + 1) % 2);
+				        }
+			        }
+		        }
+		    ));
+	    }
+	);
+	ASSERT_EQ(sock::Status::GOOD, runtime.status());
+	runtime.start();
+
+	auto client = sock::SocketFactory::instance().create(TCP);
+	client.connect({.host = "127.0.0.1", .port = "18843"});
+	ASSERT_EQ(sock::Status::GOOD, client.status());
+
+	client.send("move\nhal");
+	const auto before = receive_exactly(client, 6);
+	ASSERT_EQ("move", before.substr(2));
+
+	client.send("f\n");
+	const auto after = receive_exactly(client, 6);
+	ASSERT_EQ("half", after.substr(2));
+	ASSERT_NE(before[0], after[0]);
+
+	runtime.stop();
+
+	ASSERT_EQ(
+	    1,
+	    runtime.core(0).metrics().migrated + runtime.core(1).metrics().migrated
+	);
+}
+
+GTEST_TEST(Balancer, spreads_load_across_cores)
+{
+	constexpr size_t clients_count = 4;
+	constexpr size_t payload = 16 * 1024;
+
+	sock::Runtime runtime {{.cores = 2}};
+
+	// Every connection starts on core 0.
+	runtime.listen(
+	    TCP,
+	    {.host = "127.0.0.1", .port = "18844"},
+	    [](sock::Core& core, sock::Socket&& socket)
+	    {
+		    auto connection = std::make_shared<sock::Connection>(
+		        std::move(socket),
+		        [](sock::Connection& conn)
+		        {
+			        conn.write(conn.input());
+			        conn.input().clear();
+		        }
+		    );
+		    core.adopt(connection);
+		    core.migrate(*connection, 0);
+	    }
+	);
+	runtime.start();
+
+	sock::Balancer balancer {runtime, {.min_load = 1024}};
+	std::vector<sock::Socket> clients;
+
+	for (size_t i = 0; i < clients_count; i++)
+	{
+		auto& client = clients.emplace_back(
+		    sock::SocketFactory::instance().create(TCP)
+		);
+		client.connect({.host = "127.0.0.1", .port = "18844"});
+		ASSERT_EQ(sock::Status::GOOD, client.status());
+	}
+
+	const std::string message(payload, 'x');
+
+	for (int round = 0; round < 20; round++)
+	{
+		for (auto& client : clients)
+		{
+			client.send(message);
+			ASSERT_EQ(payload, receive_exactly(client, payload).size());
+		}
+
+		balancer.rebalance();
+	}
+
+	runtime.stop();
+
+	ASSERT_GT(balancer.decisions(), 0);
+	ASSERT_GT(runtime.core(1).metrics().connections, 0);
+	ASSERT_EQ(
+	    clients_count,
+	    runtime.core(0).metrics().connections
+	        + runtime.core(1).metrics().connections
+	);
+}
+
+GTEST_TEST(Connection, applies_backpressure_to_slow_readers)
+{
+	constexpr size_t requests = 100;
+	constexpr size_t reply = 64 * 1024;
+	constexpr sock::Watermarks watermarks {
+	    .high = 256 * 1024,
+	    .low = 64 * 1024,
+	    .not_sent_lowat = 16 * 1024,
+	};
+
+	sock::Runtime runtime {{.cores = 1}};
+	std::atomic<size_t> processed = 0;
+	std::atomic<size_t> drained = 0;
+	std::atomic<size_t> deepest = 0;
+
+	// Answers each "x" with a large reply, but only while the client
+	// keeps up.
+	const auto serve = [&](sock::Connection& conn)
+	{
+		auto& input = conn.input();
+
+		while (!input.empty() && !conn.congested())
+		{
+			input.erase(0, 1);
+			conn.write(std::string(reply, 'y'));
+			processed++;
+			deepest = std::max(deepest.load(), conn.pending_output());
+		}
+	};
+
+	runtime.listen(
+	    TCP,
+	    {.host = "127.0.0.1", .port = "18845"},
+	    [&](sock::Core& core, sock::Socket&& socket)
+	    {
+		    socket.option(sock::Option::SNDBUF, 16 * 1024);
+
+		    auto connection = std::make_shared<sock::Connection>(
+		        std::move(socket),
+		        serve,
+		        watermarks
+		    );
+		    connection->on_drained(
+		        [&](sock::Connection& conn)
+		        {
+			        drained++;
+			        serve(conn);
+		        }
+		    );
+		    core.adopt(connection);
+	    }
+	);
+	runtime.start();
+
+	auto client = sock::SocketFactory::instance().create(TCP);
+	client.option(sock::Option::RCVBUF, 16 * 1024);
+	client.connect({.host = "127.0.0.1", .port = "18845"});
+	ASSERT_EQ(sock::Status::GOOD, client.status());
+
+	client.send(std::string(requests, 'x'));
+	std::this_thread::sleep_for(std::chrono::milliseconds {200});
+
+	// The client does not read, the server stopped short of buffering
+	// every reply.
+	auto& metrics = runtime.core(0).metrics();
+	ASSERT_LT(processed, requests);
+	ASSERT_EQ(1, metrics.congestions);
+	ASSERT_GT(metrics.queued, watermarks.high);
+	ASSERT_LE(deepest, watermarks.high + reply);
+
+	ASSERT_EQ(requests * reply, receive_exactly(client, requests * reply).size());
+	runtime.stop();
+
+	ASSERT_EQ(requests, processed);
+	ASSERT_GT(drained, 0);
+	ASSERT_EQ(0, metrics.queued);
+}
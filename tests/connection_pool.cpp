@@ -0,0 +1,132 @@
+#include "sock/connection_pool.hpp"
+#include "sock/socket_factory.hpp"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+static constexpr sock::CtorArgs TCP {
+    .domain = sock::Domain::INET,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::TCP,
+    .flags = sock::Flags::PASSIVE,
+};
+
+/**
+ * Connections complete in the backlog, the test accepts them when it
+ * wants to look at the server side.
+ */
+static auto listener(const char* port) -> sock::Socket
+{
+	auto server = sock::SocketFactory::instance().create(TCP);
+	server.option(sock::Option::REUSEADDR, 1);
+	server.bind({.host = "127.0.0.1", .port = port});
+	server.listen(16);
+	server.non_blocking(true);
+
+	return server;
+}
+
+static auto endpoint(const char* port) -> sock::Endpoint
+{
+	return *sock::Endpoint::parse({.host = "127.0.0.1", .port = port});
+}
+
+GTEST_TEST(ConnectionPool, reuses_idle_connections)
+{
+	auto server = listener("19853");
+	sock::ConnectionPool pool {TCP};
+
+	for (int i = 0; i < 3; i++)
+	{
+		auto lease = pool.acquire(endpoint("19853"));
+		ASSERT_EQ(sock::Status::GOOD, lease.status());
+		lease->send("ping");
+	}
+
+	ASSERT_EQ(1, pool.metrics().misses);
+	ASSERT_EQ(2, pool.metrics().hits);
+	ASSERT_NEAR(2.0 / 3, pool.metrics().hit_rate(), 0.001);
+
+	// One handshake for all three requests.
+	auto conn = server.accept();
+	ASSERT_GE(conn.native_handle(), 0);
+	ASSERT_LT(server.accept().native_handle(), 0);
+
+	sock::Buffer buff;
+	conn.receive(buff);
+	ASSERT_EQ("pingpingping", buff.view());
+}
+
+GTEST_TEST(ConnectionPool, replaces_connections_closed_by_peer)
+{
+	auto server = listener("19854");
+	sock::ConnectionPool pool {TCP, {.thread_cache = 0}};
+
+	pool.acquire(endpoint("19854"));
+	ASSERT_EQ(1, pool.idle(endpoint("19854")));
+
+	server.accept();
+	std::this_thread::sleep_for(20ms);
+
+	auto lease = pool.acquire(endpoint("19854"));
+	ASSERT_EQ(sock::Status::GOOD, lease.status());
+	ASSERT_EQ(1, pool.metrics().broken);
+	ASSERT_EQ(2, pool.metrics().misses);
+
+	// Discarded leases are closed rather than kept.
+	lease.discard();
+	lease = pool.acquire(endpoint("19854"));
+	ASSERT_EQ(3, pool.metrics().misses);
+}
+
+GTEST_TEST(ConnectionPool, waits_for_release_at_max_size)
+{
+	auto server = listener("19855");
+	sock::ConnectionPool pool {TCP, {.max_size = 1, .wait_timeout = 50ms}};
+
+	auto held = pool.acquire(endpoint("19855"));
+	ASSERT_EQ(sock::Status::GOOD, held.status());
+
+	const auto start = std::chrono::steady_clock::now();
+	ASSERT_EQ(sock::Status::TIMED_OUT, pool.acquire(endpoint("19855")).status());
+	ASSERT_GE(std::chrono::steady_clock::now() - start, 50ms);
+	ASSERT_EQ(1, pool.metrics().timeouts);
+
+	std::thread releasing {
+	    [&held]()
+	    {
+		    std::this_thread::sleep_for(10ms);
+		    const auto released = std::move(held);
+	    }};
+
+	auto lease = pool.acquire(endpoint("19855"));
+	releasing.join();
+
+	ASSERT_EQ(sock::Status::GOOD, lease.status());
+	ASSERT_EQ(1, pool.metrics().hits);
+	ASSERT_EQ(2, pool.metrics().waits);
+	ASSERT_GT(pool.metrics().wait_ns, 0);
+}
+
+GTEST_TEST(ConnectionPool, evicts_idle_down_to_minimum)
+{
+	auto server = listener("19856");
+	sock::ConnectionPool pool {
+	    TCP,
+	    {.min_idle = 2, .idle_timeout = 0ms, .thread_cache = 0}};
+
+	ASSERT_EQ(sock::Status::GOOD, pool.warm(endpoint("19856")));
+	ASSERT_EQ(2, pool.idle(endpoint("19856")));
+
+	{
+		auto a = pool.acquire(endpoint("19856"));
+		auto b = pool.acquire(endpoint("19856"));
+		auto c = pool.acquire(endpoint("19856"));
+	}
+
+	ASSERT_EQ(3, pool.idle(endpoint("19856")));
+	ASSERT_EQ(1, pool.evict_idle());
+	ASSERT_EQ(2, pool.idle(endpoint("19856")));
+}
@@ -0,0 +1,121 @@
+#include "sock/async_socket.hpp"
+#include "sock/endpoint.hpp"
+#include "sock/socket_factory.hpp"
+#include "sock/task.hpp"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <string_view>
+#include <thread>
+
+static constexpr sock::CtorArgs TCP {
+    .domain = sock::Domain::INET,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::TCP,
+    .flags = sock::Flags::PASSIVE,
+};
+
+GTEST_TEST(Endpoint, parses_numeric_literals)
+{
+	const auto v4 = sock::Endpoint::parse({.host = "127.0.0.1", .port = "8080"});
+	ASSERT_TRUE(v4.has_value());
+	ASSERT_EQ(AF_INET, v4->family());
+	ASSERT_EQ(8080, v4->port());
+	ASSERT_EQ("127.0.0.1:8080", v4->to_string());
+
+	const auto v6 = sock::Endpoint::parse({.host = "::1", .port = "443"});
+	ASSERT_TRUE(v6.has_value());
+	ASSERT_EQ(AF_INET6, v6->family());
+	ASSERT_EQ("[::1]:443", v6->to_string());
+
+	ASSERT_FALSE(sock::Endpoint::parse({.host = "localhost", .port = "80"}));
+	ASSERT_FALSE(sock::Endpoint::parse({.host = "127.0.0.1", .port = "http"}));
+	ASSERT_FALSE(sock::Endpoint::parse({.host = "127.0.0.1", .port = "70000"}));
+
+	// Views into a longer string are not NUL-terminated.
+	constexpr std::string_view line {"10.0.0.1:8080/"};
+	const auto sliced = sock::resolve(
+	    TCP,
+	    {.host = line.substr(0, 8), .port = line.substr(9, 4)}
+	);
+	ASSERT_EQ(sock::Status::GOOD, sliced.status);
+	ASSERT_EQ(1, sliced.endpoints.size());
+	ASSERT_EQ("10.0.0.1:8080", sliced.endpoints[0].to_string());
+
+	// The domain still has to fit.
+	ASSERT_EQ(
+	    sock::Status::GETADDRINFO_ERROR,
+	    sock::resolve(TCP, {.host = "::1", .port = "80"}).status
+	);
+}
+
+GTEST_TEST(Endpoint, connects_without_lookup)
+{
+	const auto resolution =
+	    sock::resolve(TCP, {.host = "localhost", .port = "19846"});
+	ASSERT_EQ(sock::Status::GOOD, resolution.status);
+	ASSERT_FALSE(resolution.endpoints.empty());
+
+	const auto& endpoint = resolution.endpoints[0];
+	auto& factory = sock::SocketFactory::instance();
+
+	auto server = factory.create(TCP);
+	server.option(sock::Option::REUSEADDR, 1);
+	server.bind(endpoint);
+	server.listen(4);
+	ASSERT_EQ(sock::Status::GOOD, server.status());
+
+	// The same endpoint serves any number of connections.
+	for (int i = 0; i < 3; i++)
+	{
+		auto client = factory.create(TCP);
+		client.connect(endpoint);
+		ASSERT_EQ(sock::Status::GOOD, client.status());
+
+		auto conn = server.accept();
+		client.send("hi");
+
+		sock::Buffer buff;
+		conn.receive(buff);
+		ASSERT_EQ("hi", buff.view());
+	}
+
+	sock::Reactor reactor;
+	sock::AsyncSocket client {reactor, TCP};
+	ASSERT_EQ(
+	    sock::Status::GOOD,
+	    sock::block_on(reactor, client.async_connect(endpoint))
+	);
+}
+
+GTEST_TEST(ResolverCache, expires_after_ttl)
+{
+	using namespace std::chrono_literals;
+
+	sock::ResolverCache cache {50ms};
+
+	const auto first = cache.resolve(TCP, {.host = "localhost", .port = "80"});
+	ASSERT_EQ(sock::Status::GOOD, first.status);
+	ASSERT_EQ(0, cache.hits());
+	ASSERT_EQ(1, cache.misses());
+
+	const auto second = cache.resolve(TCP, {.host = "localhost", .port = "80"});
+	ASSERT_EQ(first.endpoints, second.endpoints);
+	ASSERT_EQ(1, cache.hits());
+	ASSERT_EQ(1, cache.size());
+
+	// Literals never reach the cache.
+	cache.resolve(TCP, {.host = "127.0.0.1", .port = "80"});
+	ASSERT_EQ(1, cache.size());
+	ASSERT_EQ(1, cache.misses());
+
+	// Failures are not remembered.
+	const auto failed =
+	    cache.resolve(TCP, {.host = "no-such-host.invalid", .port = "80"});
+	ASSERT_EQ(sock::Status::GETADDRINFO_ERROR, failed.status);
+	ASSERT_EQ(1, cache.size());
+
+	std::this_thread::sleep_for(60ms);
+	cache.resolve(TCP, {.host = "localhost", .port = "80"});
+	ASSERT_EQ(1, cache.hits());
+	ASSERT_EQ(3, cache.misses());
+}
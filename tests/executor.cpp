@@ -0,0 +1,105 @@
+#include "sock/executor.hpp"
+#include "sock/internal/work_stealing_deque.hpp"
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+
+GTEST_TEST(WorkStealingDeque, pops_newest_and_steals_oldest)
+{
+	sock::internal::WorkStealingDeque<int*> deque {2};
+	int items[5] {};
+
+	for (auto& item : items)
+	{
+		deque.push(&item);
+	}
+
+	ASSERT_EQ(5, deque.size());
+
+	int* item = nullptr;
+	ASSERT_TRUE(deque.pop(item));
+	ASSERT_EQ(&items[4], item);
+	ASSERT_TRUE(deque.steal(item));
+	ASSERT_EQ(&items[0], item);
+
+	while (deque.pop(item))
+	{}
+
+	ASSERT_EQ(0, deque.size());
+	ASSERT_FALSE(deque.steal(item));
+}
+
+GTEST_TEST(Executor, runs_jobs_submitted_from_anywhere)
+{
+	std::atomic<int> done = 0;
+
+	{
+		sock::Executor executor {4};
+
+		for (int i = 0; i < 100; i++)
+		{
+			executor.submit(
+			    [&executor, &done]()
+			    {
+				    for (int j = 0; j < 100; j++)
+				    {
+					    executor.submit(
+					        [&done]()
+					        {
+						        done++;
+					        }
+					    );
+				    }
+			    }
+			);
+		}
+	}
+
+	ASSERT_EQ(10000, done);
+}
+
+GTEST_TEST(Executor, idle_workers_steal_from_busy_ones)
+{
+	using namespace std::chrono_literals;
+
+	sock::Executor executor {2};
+	std::atomic<int> done = 0;
+	std::atomic<bool> blocked = true;
+	std::atomic<int> finished_while_blocked = -1;
+
+	executor.submit(
+	    [&]()
+	    {
+		    // These go to this worker's own deque, which it is not going to
+		    // look at until the sleep is over.
+		    for (int i = 0; i < 100; i++)
+		    {
+			    executor.submit(
+			        [&done]()
+			        {
+				        done++;
+			        }
+			    );
+		    }
+
+		    const auto deadline = std::chrono::steady_clock::now() + 1s;
+
+		    while (done < 100 && std::chrono::steady_clock::now() < deadline)
+		    {
+			    std::this_thread::sleep_for(1ms);
+		    }
+
+		    finished_while_blocked = done.load();
+		    blocked = false;
+	    }
+	);
+
+	while (blocked)
+	{
+		std::this_thread::sleep_for(1ms);
+	}
+
+	ASSERT_EQ(100, finished_while_blocked);
+	ASSERT_GT(executor.steals(), 0);
+}
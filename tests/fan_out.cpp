@@ -0,0 +1,126 @@
+#include "sock/fan_out.hpp"
+#include "sock/socket_factory.hpp"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+
+static constexpr sock::CtorArgs TCP {
+    .domain = sock::Domain::INET,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::TCP,
+    .flags = sock::Flags::PASSIVE,
+};
+
+/**
+ * A listener whose accept queue is full: the kernel drops further SYNs,
+ * so connecting to it hangs like connecting to a dead host.
+ */
+struct BlackHole
+{
+	explicit BlackHole(const char* port)
+	{
+		server.option(sock::Option::REUSEADDR, 1);
+		server.bind({.host = "127.0.0.1", .port = port});
+		server.listen(0);
+		filler.connect({.host = "127.0.0.1", .port = port});
+	}
+
+	sock::Socket server {sock::SocketFactory::instance().create(TCP)};
+	sock::Socket filler {sock::SocketFactory::instance().create(TCP)};
+};
+
+GTEST_TEST(Socket, gives_up_connecting_after_timeout)
+{
+	BlackHole hole {"15845"};
+	ASSERT_EQ(sock::Status::GOOD, hole.filler.status());
+
+	auto client = sock::SocketFactory::instance().create(TCP);
+	const auto start = Clock::now();
+	client.connect({.host = "127.0.0.1", .port = "15845"}, 100ms);
+
+	ASSERT_EQ(sock::Status::TIMED_OUT, client.status());
+	ASSERT_LT(Clock::now() - start, 1s);
+}
+
+GTEST_TEST(FanOut, hands_out_connections_as_they_complete)
+{
+	sock::Reactor reactor;
+	BlackHole hole {"15846"};
+
+	sock::AsyncSocket server {reactor, TCP};
+	server.socket().option(sock::Option::REUSEADDR, 1);
+	server.socket().bind({.host = "127.0.0.1", .port = "15847"});
+	server.socket().listen(8);
+
+	// Nothing listens on 15848.
+	const std::string hole_port = "15846";
+	const std::vector<sock::Address> backends {
+	    {.host = "127.0.0.1", .port = hole_port},
+	    {.host = "127.0.0.1", .port = "15847"},
+	    {.host = "127.0.0.1", .port = "15848"},
+	};
+
+	const auto start = Clock::now();
+	std::vector<size_t> order;
+	std::vector<sock::Status> statuses(backends.size());
+	bool echoed = false;
+
+	auto run = [&]() -> sock::Task<>
+	{
+		sock::FanOut fan_out {reactor, TCP, backends, 200ms};
+
+		while (auto result = co_await fan_out.next())
+		{
+			order.push_back(result->index);
+			statuses[result->index] = result->status;
+
+			if (result->status == sock::Status::GOOD)
+			{
+				auto peer = co_await server.async_accept();
+				co_await result->socket.async_send("hi");
+
+				sock::Buffer buff;
+				co_await peer.async_receive(buff);
+				echoed = buff.view() == "hi";
+			}
+		}
+
+		co_return;
+	};
+
+	sock::block_on(reactor, run());
+
+	ASSERT_EQ(3, order.size());
+	ASSERT_EQ(0, order.back());
+	ASSERT_EQ(sock::Status::TIMED_OUT, statuses[0]);
+	ASSERT_EQ(sock::Status::GOOD, statuses[1]);
+	ASSERT_EQ(sock::Status::CONNECT_ERROR, statuses[2]);
+	ASSERT_TRUE(echoed);
+	ASSERT_LT(Clock::now() - start, 1s);
+}
+
+GTEST_TEST(FanOut, cancels_pending_connects_when_destroyed)
+{
+	sock::Reactor reactor;
+	BlackHole hole {"15849"};
+
+	const std::vector<sock::Address> backends(
+	    4,
+	    {.host = "127.0.0.1", .port = "15849"}
+	);
+
+	auto run = [&]() -> sock::Task<size_t>
+	{
+		sock::FanOut fan_out {reactor, TCP, backends};
+		co_await sock::sleep_for(reactor, 20ms);
+
+		co_return fan_out.remaining();
+	};
+
+	ASSERT_EQ(4, sock::block_on(reactor, run()));
+	ASSERT_EQ(0, reactor.size());
+}
@@ -0,0 +1,141 @@
+#include "sock/fd_channel.hpp"
+#include "sock/prefork.hpp"
+#include "sock/socket_factory.hpp"
+#include <gtest/gtest.h>
+#include <set>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static constexpr sock::CtorArgs TCP {
+    .domain = sock::Domain::INET,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::TCP,
+    .flags = sock::Flags::PASSIVE,
+};
+
+GTEST_TEST(FdChannel, passes_sockets_with_buffered_data)
+{
+	// More than fit into one batch.
+	constexpr size_t count = sock::FdChannel::MAX_BATCH + 6;
+
+	auto [sender, receiver] = sock::FdChannel::pair();
+	ASSERT_EQ(sock::Status::GOOD, sender.status());
+
+	std::vector<int> peers;
+	std::vector<sock::Handoff> handoffs;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		int fds[2];
+		ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+		peers.push_back(fds[0]);
+		handoffs.push_back({
+		    .socket = sock::Socket {fds[1]},
+		    .data = i % 3 == 0 ? "" : "read " + std::to_string(i),
+		});
+	}
+
+	ASSERT_EQ(count, sender.send(handoffs));
+	ASSERT_EQ(-1, handoffs[0].socket.native_handle());
+
+	std::vector<sock::Handoff> received;
+
+	while (received.size() < count)
+	{
+		ASSERT_GT(receiver.receive(received), 0);
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		ASSERT_EQ(i % 3 == 0 ? "" : "read " + std::to_string(i), received[i].data);
+
+		// The passed descriptor still reaches the same peer.
+		received[i].socket.send("x");
+
+		char byte = 0;
+		ASSERT_EQ(1, read(peers[i], &byte, 1));
+		ASSERT_EQ('x', byte);
+		close(peers[i]);
+	}
+
+	sender.close();
+	ASSERT_EQ(0, receiver.receive(received));
+	ASSERT_EQ(sock::Status::GOOD, receiver.status());
+}
+
+GTEST_TEST(Prefork, hands_connections_to_worker_processes)
+{
+	// Each worker answers with "<index>:<pid>" and closes.
+	sock::Prefork prefork {
+	    TCP,
+	    {.host = "127.0.0.1", .port = "19845"},
+	    [](size_t index, sock::FdChannel& channel)
+	    {
+		    const auto reply =
+		        std::to_string(index) + ":" + std::to_string(getpid());
+		    std::vector<sock::Handoff> batch;
+
+		    while (channel.receive(batch) > 0)
+		    {
+			    for (auto& handoff : batch)
+			    {
+				    handoff.socket.send(reply);
+			    }
+
+			    batch.clear();
+		    }
+	    },
+	    {.workers = 2}};
+	ASSERT_EQ(sock::Status::GOOD, prefork.status());
+	prefork.start();
+
+	std::thread acceptor {
+	    [&prefork]()
+	    {
+		    prefork.run();
+	    }};
+
+	const auto request = []()
+	{
+		auto client = sock::SocketFactory::instance().create(TCP);
+		client.connect({.host = "127.0.0.1", .port = "19845"});
+
+		sock::Buffer buff;
+		client.receive(buff);
+
+		return std::string {buff.view()};
+	};
+
+	std::set<std::string> replies;
+
+	for (int i = 0; i < 4; i++)
+	{
+		replies.insert(request());
+	}
+
+	ASSERT_EQ(2, replies.size());
+
+	const auto first = prefork.pid(0);
+	prefork.reactor().post(
+	    [&prefork]()
+	    {
+		    prefork.restart(0);
+	    }
+	);
+
+	for (int i = 0; i < 4; i++)
+	{
+		replies.insert(request());
+	}
+
+	prefork.stop();
+	acceptor.join();
+
+	ASSERT_NE(first, prefork.pid(0));
+	ASSERT_TRUE(replies.contains("0:" + std::to_string(prefork.pid(0))));
+	ASSERT_EQ(3, replies.size());
+	ASSERT_EQ(8, prefork.handed_off());
+}
@@ -0,0 +1,117 @@
+#include "sock/framing.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+static auto frames(std::initializer_list<std::string> payloads, sock::Prefix prefix)
+    -> std::string
+{
+	const sock::FrameEncoder encoder {prefix};
+	std::string out;
+
+	for (const auto& payload : payloads)
+	{
+		EXPECT_EQ(sock::Status::GOOD, encoder.encode(payload, out));
+	}
+
+	return out;
+}
+
+GTEST_TEST(FrameDecoder, hands_out_whole_frames_in_place)
+{
+	const auto bytes = frames({"one", "", "three"}, sock::Prefix::U32);
+	sock::FrameDecoder decoder;
+	decoder.feed(bytes);
+
+	auto frame = decoder.next();
+	ASSERT_EQ("one", frame);
+	// A view into the fed bytes, not a copy.
+	ASSERT_EQ(bytes.data() + 4, frame->data());
+
+	ASSERT_EQ("", decoder.next());
+	ASSERT_EQ("three", decoder.next());
+	ASSERT_FALSE(decoder.next());
+	ASSERT_EQ(0, decoder.buffered());
+}
+
+GTEST_TEST(FrameDecoder, gathers_frames_split_across_reads)
+{
+	for (const auto prefix :
+	     {sock::Prefix::U16, sock::Prefix::U32, sock::Prefix::VARINT})
+	{
+		const std::string large(300, 'x');
+		const auto bytes = frames({"alpha", large, "", "omega"}, prefix);
+
+		// Every split point, every read size.
+		for (size_t step = 1; step <= bytes.size(); step++)
+		{
+			sock::FrameDecoder decoder {prefix};
+			std::vector<std::string> decoded;
+
+			for (size_t offset = 0; offset < bytes.size(); offset += step)
+			{
+				// The receive buffer is reused for every read.
+				std::string read = bytes.substr(offset, step);
+				decoder.feed(read);
+
+				while (const auto frame = decoder.next())
+				{
+					decoded.emplace_back(*frame);
+				}
+
+				read.assign(read.size(), '?');
+			}
+
+			ASSERT_EQ(sock::Status::GOOD, decoder.status());
+			ASSERT_EQ(4, decoded.size()) << "step " << step;
+			ASSERT_EQ("alpha", decoded[0]);
+			ASSERT_EQ(large, decoded[1]);
+			ASSERT_EQ("", decoded[2]);
+			ASSERT_EQ("omega", decoded[3]);
+		}
+	}
+}
+
+GTEST_TEST(FrameDecoder, rejects_oversized_and_malformed_frames)
+{
+	sock::FrameDecoder decoder {sock::Prefix::U32, 8};
+	const auto bytes = frames({"fits", "does not fit"}, sock::Prefix::U32);
+	decoder.feed(bytes);
+
+	ASSERT_EQ("fits", decoder.next());
+	ASSERT_FALSE(decoder.next());
+	ASSERT_EQ(sock::Status::FRAME_ERROR, decoder.status());
+
+	// Caught from the prefix alone, before the payload arrives.
+	decoder.reset();
+	decoder.feed({"\0\0\1\0", 4});
+	ASSERT_FALSE(decoder.next());
+	ASSERT_EQ(sock::Status::FRAME_ERROR, decoder.status());
+
+	// Eleven continuation bytes.
+	sock::FrameDecoder varint {sock::Prefix::VARINT};
+	const std::string continued(11, '\x80');
+	varint.feed(continued);
+	ASSERT_FALSE(varint.next());
+	ASSERT_EQ(sock::Status::FRAME_ERROR, varint.status());
+
+	std::string out;
+	ASSERT_EQ(
+	    sock::Status::FRAME_ERROR,
+	    sock::FrameEncoder {sock::Prefix::U16}.encode(std::string(70000, 'x'), out)
+	);
+	ASSERT_TRUE(out.empty());
+}
+
+GTEST_TEST(FrameEncoder, writes_varints)
+{
+	const sock::FrameEncoder encoder {sock::Prefix::VARINT};
+	char header[sock::FrameEncoder::MAX_HEADER];
+
+	ASSERT_EQ(1, encoder.header(0, header));
+	ASSERT_EQ(1, encoder.header(127, header));
+	ASSERT_EQ(2, encoder.header(300, header));
+	ASSERT_EQ('\xac', header[0]);
+	ASSERT_EQ('\x02', header[1]);
+	ASSERT_EQ(10, encoder.header(SIZE_MAX, header));
+}
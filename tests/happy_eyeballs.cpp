@@ -0,0 +1,187 @@
+#include "sock/happy_eyeballs.hpp"
+#include "sock/resolver.hpp"
+#include "sock/socket_factory.hpp"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+
+static constexpr sock::CtorArgs TCP {
+    .domain = sock::Domain::INET,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::TCP,
+    .flags = sock::Flags::PASSIVE,
+};
+
+static constexpr sock::CtorArgs TCP6 {
+    .domain = sock::Domain::INET6,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::TCP,
+    .flags = sock::Flags::PASSIVE,
+};
+
+static constexpr sock::CtorArgs DUAL {
+    .domain = sock::Domain::UNSPEC,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::TCP,
+    .flags = sock::Flags::PASSIVE,
+};
+
+static auto endpoint(const char* host, const char* port) -> sock::Endpoint
+{
+	return *sock::Endpoint::parse({.host = host, .port = port});
+}
+
+static auto listener(sock::CtorArgs args, const char* host, const char* port)
+    -> sock::Socket
+{
+	auto server = sock::SocketFactory::instance().create(args);
+	server.option(sock::Option::REUSEADDR, 1);
+	server.bind({.host = host, .port = port});
+	server.listen(4);
+
+	return server;
+}
+
+GTEST_TEST(Socket, unspecified_domain_is_dual_stack)
+{
+	auto server = listener(DUAL, "::", "19847");
+	ASSERT_EQ(sock::Status::GOOD, server.status());
+
+	for (const auto args : {TCP, TCP6, DUAL})
+	{
+		for (const auto host : {"127.0.0.1", "::1"})
+		{
+			// Only unspecified sockets reach both families.
+			const bool v6 = host[0] == ':';
+
+			if ((args.domain == sock::Domain::INET && v6)
+			    || (args.domain == sock::Domain::INET6 && !v6))
+			{
+				continue;
+			}
+
+			auto client = sock::SocketFactory::instance().create(args);
+			client.connect({.host = host, .port = "19847"});
+			ASSERT_EQ(sock::Status::GOOD, client.status()) << host;
+
+			auto conn = server.accept();
+			ASSERT_EQ(sock::Status::GOOD, conn.status());
+		}
+	}
+}
+
+GTEST_TEST(Resolver, resolves_off_the_reactor_thread)
+{
+	sock::Reactor reactor;
+	sock::ResolverCache cache;
+	sock::Resolver resolver {reactor, 2, &cache};
+
+	const auto run = [&resolver]() -> sock::Task<int>
+	{
+		std::string port {"19848"};
+		auto lookup = resolver.resolve(TCP, {.host = "localhost", .port = port});
+		// The resolver copied the views.
+		port = "0";
+
+		const auto resolved = co_await std::move(lookup);
+		const auto literal =
+		    co_await resolver.resolve(TCP6, {.host = "::1", .port = "80"});
+
+		if (resolved.status != sock::Status::GOOD
+		    || resolved.endpoints.empty()
+		    || resolved.endpoints[0].port() != 19848
+		    || literal.endpoints.size() != 1)
+		{
+			co_return -1;
+		}
+
+		co_return static_cast<int>(resolved.endpoints.size());
+	};
+
+	ASSERT_GT(sock::block_on(reactor, run()), 0);
+	ASSERT_EQ(1, cache.misses());
+}
+
+GTEST_TEST(HappyEyeballs, falls_back_when_first_family_hangs)
+{
+	// A full accept queue drops further SYNs, like a broken IPv6 path.
+	auto hole = listener(TCP6, "::1", "19849");
+	sock::Socket filler {sock::SocketFactory::instance().create(TCP6)};
+	hole.listen(0);
+	filler.connect({.host = "::1", .port = "19849"});
+	ASSERT_EQ(sock::Status::GOOD, filler.status());
+
+	auto server = listener(TCP, "127.0.0.1", "19850");
+
+	sock::Reactor reactor;
+	const auto start = Clock::now();
+	auto connected = sock::block_on(
+	    reactor,
+	    sock::happy_eyeballs(
+	        reactor,
+	        TCP,
+	        {endpoint("::1", "19849"), endpoint("127.0.0.1", "19850")},
+	        {.attempt_delay = 50ms}
+	    )
+	);
+	const auto elapsed = Clock::now() - start;
+
+	ASSERT_EQ(sock::Status::GOOD, connected.status);
+	ASSERT_EQ(endpoint("127.0.0.1", "19850"), connected.endpoint);
+	ASSERT_GE(elapsed, 50ms);
+	ASSERT_LT(elapsed, 1s);
+	ASSERT_EQ(1, reactor.size());
+	ASSERT_EQ(sock::Status::GOOD, server.accept().status());
+}
+
+GTEST_TEST(HappyEyeballs, keeps_first_family_and_reports_failures)
+{
+	auto v6 = listener(TCP6, "::1", "19851");
+	auto v4 = listener(TCP, "127.0.0.1", "19851");
+
+	sock::Reactor reactor;
+	sock::Resolver resolver {reactor};
+
+	const auto start = Clock::now();
+	auto connected = sock::block_on(
+	    reactor,
+	    sock::happy_eyeballs(
+	        reactor,
+	        TCP,
+	        {endpoint("127.0.0.1", "19852"),
+	         endpoint("::1", "19851"),
+	         endpoint("127.0.0.1", "19851")},
+	        {.attempt_delay = 1s}
+	    )
+	);
+
+	// The refused first attempt hands over to IPv6 right away.
+	ASSERT_EQ(sock::Status::GOOD, connected.status);
+	ASSERT_EQ(AF_INET6, connected.endpoint.family());
+	ASSERT_LT(Clock::now() - start, 500ms);
+
+	auto refused = sock::block_on(
+	    reactor,
+	    sock::happy_eyeballs(
+	        reactor,
+	        resolver,
+	        DUAL,
+	        {.host = "127.0.0.1", .port = "19852"}
+	    )
+	);
+	ASSERT_EQ(sock::Status::CONNECT_ERROR, refused.status);
+
+	auto unresolved = sock::block_on(
+	    reactor,
+	    sock::happy_eyeballs(
+	        reactor,
+	        resolver,
+	        DUAL,
+	        {.host = "no-such-host.invalid", .port = "80"}
+	    )
+	);
+	ASSERT_EQ(sock::Status::GETADDRINFO_ERROR, unresolved.status);
+}
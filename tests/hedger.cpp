@@ -0,0 +1,157 @@
+#include "sock/hedger.hpp"
+#include "sock/endpoint.hpp"
+#include "sock/socket_factory.hpp"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+
+static constexpr sock::CtorArgs TCP {
+    .domain = sock::Domain::INET,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::TCP,
+    .flags = sock::Flags::PASSIVE,
+};
+
+/**
+ * Answers every request of one connection with its name, `delay` late.
+ */
+struct Backend
+{
+	Backend(const char* at, const char* name, std::chrono::milliseconds delay) :
+	    port {at},
+	    server {sock::SocketFactory::instance().create(TCP)}
+	{
+		server.option(sock::Option::REUSEADDR, 1);
+		server.bind({.host = "127.0.0.1", .port = port});
+		server.listen(4);
+
+		thread = std::thread {
+		    [this, name, delay]()
+		    {
+			    auto conn = server.accept();
+			    sock::Buffer buff;
+
+			    while (true)
+			    {
+				    conn.receive(buff);
+
+				    if (conn.status() != sock::Status::GOOD
+				        || buff.received_size() == 0)
+				    {
+					    break;
+				    }
+
+				    std::this_thread::sleep_for(delay);
+				    conn.send(name);
+			    }
+		    }};
+	}
+
+	~Backend()
+	{
+		thread.join();
+	}
+
+	auto connect(sock::Reactor& reactor) -> sock::AsyncSocket
+	{
+		sock::AsyncSocket client {reactor, TCP};
+		sock::block_on(
+		    reactor,
+		    client.async_connect(
+		        *sock::Endpoint::parse({.host = "127.0.0.1", .port = port})
+		    )
+		);
+
+		return client;
+	}
+
+	const char* port;
+	sock::Socket server;
+	std::thread thread;
+};
+
+GTEST_TEST(Hedger, hedges_slow_requests)
+{
+	Backend slow {"19861", "slow", 300ms};
+	Backend fast {"19862", "fast", 0ms};
+	sock::Reactor reactor;
+	sock::Hedger hedger {reactor, {.initial_delay = 20ms, .budget = 1.0}};
+
+	auto primary = slow.connect(reactor);
+	auto backup = fast.connect(reactor);
+
+	const auto start = Clock::now();
+	auto hedged = sock::block_on(reactor, hedger.request(primary, backup, "get"));
+
+	ASSERT_EQ(sock::Status::GOOD, hedged.status);
+	ASSERT_EQ("fast", hedged.reply);
+	ASSERT_EQ(1, hedged.winner);
+	ASSERT_TRUE(hedged.hedged);
+	ASSERT_LT(Clock::now() - start, 200ms);
+
+	ASSERT_EQ(1, hedger.metrics().hedged);
+	ASSERT_EQ(1, hedger.metrics().backup_wins);
+}
+
+GTEST_TEST(Hedger, keeps_fast_replies_and_learns_their_latency)
+{
+	Backend primary_backend {"19863", "primary", 0ms};
+	Backend backup_backend {"19864", "backup", 0ms};
+	sock::Reactor reactor;
+	sock::Hedger hedger {
+	    reactor,
+	    {.initial_delay = 500ms, .min_samples = 8, .budget = 1.0}};
+
+	auto primary = primary_backend.connect(reactor);
+	auto backup = backup_backend.connect(reactor);
+
+	for (int i = 0; i < 16; i++)
+	{
+		auto hedged =
+		    sock::block_on(reactor, hedger.request(primary, backup, "get"));
+
+		ASSERT_EQ(sock::Status::GOOD, hedged.status);
+		ASSERT_EQ("primary", hedged.reply);
+		ASSERT_FALSE(hedged.hedged);
+	}
+
+	ASSERT_EQ(0, hedger.metrics().hedged);
+	ASSERT_EQ(16, hedger.metrics().requests);
+
+	// Loopback replies take well under the initial guess.
+	ASSERT_LT(hedger.delay(), 100ms);
+}
+
+GTEST_TEST(Hedger, stays_within_budget)
+{
+	Backend slow {"19865", "slow", 50ms};
+	Backend fast {"19866", "fast", 0ms};
+	sock::Reactor reactor;
+	sock::Hedger hedger {reactor, {.initial_delay = 5ms, .budget = 0.25}};
+
+	auto primary = slow.connect(reactor);
+	auto backup = fast.connect(reactor);
+
+	for (int i = 0; i < 8; i++)
+	{
+		auto hedged =
+		    sock::block_on(reactor, hedger.request(primary, backup, "get"));
+		ASSERT_EQ(sock::Status::GOOD, hedged.status);
+
+		if (hedged.hedged)
+		{
+			// The slow reply is still due, it must not pass for the
+			// next one.
+			sock::Buffer late;
+			sock::block_on(reactor, primary.async_receive(late));
+			ASSERT_EQ("slow", late.view());
+		}
+	}
+
+	ASSERT_EQ(8, hedger.metrics().requests);
+	ASSERT_EQ(2, hedger.metrics().hedged);
+	ASSERT_EQ(6, hedger.metrics().denied);
+}
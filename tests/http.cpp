@@ -0,0 +1,225 @@
+#include "sock/http.hpp"
+#include "sock/runtime.hpp"
+#include "sock/socket_factory.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+static constexpr sock::CtorArgs TCP {
+    .domain = sock::Domain::INET,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::TCP,
+    .flags = sock::Flags::PASSIVE,
+};
+
+static auto connect(const char* port) -> sock::Socket
+{
+	auto client = sock::SocketFactory::instance().create(TCP);
+	client.connect({.host = "127.0.0.1", .port = port});
+
+	return client;
+}
+
+/**
+ * Receives `size` bytes, or everything up to the server closing.
+ */
+static auto receive(sock::Socket& client, size_t size = SIZE_MAX) -> std::string
+{
+	std::string input;
+	sock::Buffer buff;
+
+	while (input.size() < size)
+	{
+		client.receive(buff);
+
+		if (buff.received_size() == 0)
+		{
+			break;
+		}
+
+		input.append(buff.view());
+	}
+
+	return input;
+}
+
+GTEST_TEST(HttpParser, views_point_into_received_bytes)
+{
+	const std::string bytes {
+	    "POST /items?id=7 HTTP/1.1\r\n"
+	    "Host: example.com\r\n"
+	    "content-length:  5 \r\n"
+	    "\r\n"
+	    "hello"
+	    "GET /next HTTP/1.1\r\n\r\n"};
+	sock::HttpParser parser;
+	sock::HttpRequest request;
+
+	const auto size = parser.parse(bytes, request);
+	ASSERT_EQ(bytes.find("GET"), size);
+	ASSERT_EQ("POST", request.method);
+	ASSERT_EQ("/items?id=7", request.target);
+	ASSERT_EQ(1, request.minor_version);
+	ASSERT_EQ(2, request.headers.size());
+	ASSERT_EQ("example.com", request.header("host"));
+	ASSERT_EQ("5", request.header("Content-Length"));
+	ASSERT_FALSE(request.header("Accept"));
+	ASSERT_EQ("hello", request.body);
+	ASSERT_TRUE(request.keep_alive);
+
+	// Not copies.
+	ASSERT_EQ(bytes.data() + 5, request.target.data());
+	ASSERT_EQ(bytes.data() + bytes.find("hello"), request.body.data());
+
+	ASSERT_EQ(bytes.size() - size, parser.parse(std::string_view {bytes}.substr(size), request));
+	ASSERT_EQ("/next", request.target);
+	ASSERT_TRUE(request.body.empty());
+}
+
+GTEST_TEST(HttpParser, waits_for_whole_requests)
+{
+	const std::string bytes {
+	    "PUT /upload HTTP/1.1\r\n"
+	    "Transfer-Encoding: chunked\r\n"
+	    "Expect: 100-continue\r\n"
+	    "Connection: close\r\n"
+	    "\r\n"
+	    "6;name=value\r\nhello \r\n"
+	    "5\r\nworld\r\n"
+	    "0\r\n"
+	    "Trailer: ignored\r\n"
+	    "\r\n"};
+	const auto head = bytes.find("\r\n\r\n") + 4;
+
+	for (size_t size = 0; size < bytes.size(); size++)
+	{
+		sock::HttpParser parser;
+		sock::HttpRequest request;
+
+		ASSERT_EQ(0, parser.parse(std::string_view {bytes}.substr(0, size), request));
+		ASSERT_EQ(sock::Status::GOOD, parser.status()) << size;
+		ASSERT_EQ(size >= head, parser.expects_continue()) << size;
+	}
+
+	sock::HttpParser parser;
+	sock::HttpRequest request;
+
+	ASSERT_EQ(bytes.size(), parser.parse(bytes, request));
+	ASSERT_EQ("hello world", request.body);
+	ASSERT_FALSE(request.keep_alive);
+	ASSERT_FALSE(parser.expects_continue());
+}
+
+GTEST_TEST(HttpParser, rejects_malformed_requests)
+{
+	const std::vector<std::pair<std::string, int>> cases {
+	    {"GET /\r\n\r\n", 400},
+	    {"GET / HTTP/2.0\r\n\r\n", 505},
+	    {"G(T / HTTP/1.1\r\n\r\n", 400},
+	    {"GET / HTTP/1.1\r\nHost : x\r\n\r\n", 400},
+	    {"GET / HTTP/1.1\r\nA: b\r\n folded\r\n\r\n", 400},
+	    {"GET / HTTP/1.1\r\nContent-Length: 1\r\nContent-Length: 2\r\n\r\n", 400},
+	    {"GET / HTTP/1.1\r\nContent-Length: -1\r\n\r\n", 400},
+	    {"GET / HTTP/1.1\r\nContent-Length: 1\r\nTransfer-Encoding: chunked\r\n\r\n",
+	     400},
+	    {"GET / HTTP/1.1\r\nTransfer-Encoding: gzip\r\n\r\n", 501},
+	    {"GET / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nxyz\r\n", 400},
+	    {"GET / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n1\r\nabc", 400},
+	    {"GET / HTTP/1.1\r\nContent-Length: 65\r\n\r\n", 413},
+	    {"GET / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n41\r\n", 413},
+	    {"GET / HTTP/1.1\r\nX: " + std::string(200, 'x') + "\r\n\r\n", 431},
+	    {"GET / HTTP/1.1\r\nX: " + std::string(200, 'x'), 431},
+	    {"GET / HTTP/1.1\r\nA: 1\r\nB: 2\r\nC: 3\r\n\r\n", 431},
+	};
+
+	for (const auto& [bytes, error] : cases)
+	{
+		sock::HttpParser parser {{.max_head = 128, .max_headers = 2, .max_body = 64}};
+		sock::HttpRequest request;
+
+		ASSERT_EQ(0, parser.parse(bytes, request)) << bytes;
+		ASSERT_EQ(sock::Status::FRAME_ERROR, parser.status()) << bytes;
+		ASSERT_EQ(error, parser.error()) << bytes;
+	}
+}
+
+GTEST_TEST(HttpServer, answers_pipelined_requests_in_one_write)
+{
+	sock::HttpServer server {
+	    [](const sock::HttpRequest& request, sock::HttpResponse& response)
+	    {
+		    response.header("Content-Type", "text/plain");
+		    response.body = std::string {request.target} + " " + std::string {request.body};
+	    }};
+	sock::Runtime runtime {{.cores = 1, .pin = false}};
+	runtime.listen(TCP, {.host = "127.0.0.1", .port = "19872"}, server.acceptor());
+	ASSERT_EQ(sock::Status::GOOD, runtime.status());
+	runtime.start();
+
+	auto client = connect("19872");
+	client.send(
+	    "GET /a HTTP/1.1\r\nHost: x\r\n\r\n"
+	    "POST /b HTTP/1.1\r\nContent-Length: 3\r\n\r\nbee"
+	    "POST /c HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+	    "2\r\nse\r\n1\r\na\r\n0\r\n\r\n"
+	    "HEAD /d HTTP/1.1\r\n\r\n"
+	);
+
+	const std::string expected {
+	    "HTTP/1.1 200 OK\r\nContent-Length: 3\r\nContent-Type: text/plain\r\n\r\n/a "
+	    "HTTP/1.1 200 OK\r\nContent-Length: 6\r\nContent-Type: text/plain\r\n\r\n/b bee"
+	    "HTTP/1.1 200 OK\r\nContent-Length: 6\r\nContent-Type: text/plain\r\n\r\n/c sea"
+	    "HTTP/1.1 200 OK\r\nContent-Length: 3\r\nContent-Type: text/plain\r\n\r\n"};
+	ASSERT_EQ(expected, receive(client, expected.size()));
+
+	// The connection stays open for more.
+	const std::string more {
+	    "HTTP/1.1 200 OK\r\nContent-Length: 3\r\nContent-Type: text/plain\r\n\r\n/e "};
+	client.send("GET /e HTTP/1.1\r\n\r\n");
+	ASSERT_EQ(more, receive(client, more.size()));
+
+	runtime.stop();
+
+	ASSERT_EQ(5, server.metrics().requests);
+	ASSERT_EQ(2, server.metrics().writes);
+}
+
+GTEST_TEST(HttpServer, closes_when_asked_or_on_errors)
+{
+	sock::HttpServer server {
+	    [](const sock::HttpRequest&, sock::HttpResponse& response)
+	    {
+		    response.body = "ok";
+	    }};
+	sock::Runtime runtime {{.cores = 1, .pin = false}};
+	runtime.listen(TCP, {.host = "127.0.0.1", .port = "19873"}, server.acceptor());
+	runtime.start();
+
+	auto old = connect("19873");
+	old.send("GET / HTTP/1.0\r\n\r\n");
+	ASSERT_EQ(
+	    "HTTP/1.1 200 OK\r\nContent-Length: 2\r\nConnection: close\r\n\r\nok",
+	    receive(old)
+	);
+
+	auto kept = connect("19873");
+	const std::string kept_alive {
+	    "HTTP/1.1 200 OK\r\nContent-Length: 2\r\nConnection: keep-alive\r\n\r\nok"};
+	kept.send("GET / HTTP/1.0\r\nConnection: keep-alive\r\n\r\n");
+	ASSERT_EQ(kept_alive, receive(kept, kept_alive.size()));
+
+	// The request after a malformed one is never answered.
+	auto bad = connect("19873");
+	bad.send("GET / HTTP/1.1\r\nBad header\r\n\r\nGET / HTTP/1.1\r\n\r\n");
+	ASSERT_EQ(
+	    "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n",
+	    receive(bad)
+	);
+
+	runtime.stop();
+
+	ASSERT_EQ(2, server.metrics().requests);
+	ASSERT_EQ(1, server.metrics().rejected);
+}
@@ -0,0 +1,190 @@
+#include "sock/io_engine.hpp"
+#include "sock/socket_factory.hpp"
+#include <array>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+
+static void echo_through_engine(sock::Engine kind, const char* port)
+{
+	using namespace std::chrono_literals;
+
+	auto engine = sock::make_io_engine(kind);
+	ASSERT_EQ(kind, engine->kind());
+	ASSERT_EQ(sock::Status::GOOD, engine->status());
+
+	auto& factory = sock::SocketFactory::instance();
+	auto server = factory.create({
+	    .domain = sock::Domain::INET,
+	    .type = sock::Type::STREAM,
+	    .protocol = sock::Protocol::TCP,
+	    .flags = sock::Flags::PASSIVE,
+	});
+	server.option(sock::Option::REUSEADDR, 1);
+	server.bind({.host = "localhost", .port = port});
+	server.listen(1);
+	ASSERT_EQ(sock::Status::GOOD, server.status());
+
+	int accepted = -1;
+	int cancelled = 0;
+	int sent = -1;
+	int shut = -1;
+	bool closed = false;
+	std::string received;
+	std::array<char, 16> fixed {"General Kenobi!"};
+	std::array<std::span<char>, 1> buffers {std::span {fixed}};
+
+	engine->accept(
+	    server.native_handle(),
+	    [&](const sock::Completion& c)
+	    {
+		    if (c.result == -ECANCELED)
+		    {
+			    cancelled++;
+			    return;
+		    }
+
+		    ASSERT_LE(0, c.result);
+		    accepted = c.result;
+		    engine->cancel(server.native_handle());
+
+		    const int files[] = {accepted};
+		    ASSERT_TRUE(engine->register_files(files));
+		    ASSERT_TRUE(engine->register_buffers(buffers));
+
+		    engine->receive(
+		        accepted,
+		        [&](const sock::Completion& r)
+		        {
+			        if (r.result > 0)
+			        {
+				        received += r.data;
+			        }
+
+			        if (received == "Hello there" && sent < 0)
+			        {
+				        sent = 0;
+				        engine
+				            ->send_fixed(
+				                accepted,
+				                0,
+				                {fixed.data(), 15},
+				                [&sent](const sock::Completion& s)
+				                {
+					                sent = s.result;
+				                },
+				                true
+				            )
+				            .shutdown(
+				                accepted,
+				                [&shut](const sock::Completion& s)
+				                {
+					                shut = s.result;
+				                }
+				            );
+			        }
+
+			        if (r.result == 0)
+			        {
+				        engine->close(
+				            accepted,
+				            [&closed](const sock::Completion&)
+				            {
+					            closed = true;
+				            }
+				        );
+			        }
+		        }
+		    );
+	    }
+	);
+
+	std::string reply;
+	std::thread client_thread {
+	    [&factory, &reply, port]()
+	    {
+		    auto client = factory.create({
+		        .domain = sock::Domain::INET,
+		        .type = sock::Type::STREAM,
+		        .protocol = sock::Protocol::TCP,
+		    });
+		    client.connect({.host = "localhost", .port = port});
+		    client.send("Hello there");
+
+		    sock::Buffer buff;
+		    do
+		    {
+			    client.receive(buff);
+			    reply += buff.view();
+		    } while (buff.received_size() > 0);
+	    }};
+
+	const auto deadline = std::chrono::steady_clock::now() + 5s;
+	while (!closed && std::chrono::steady_clock::now() < deadline)
+	{
+		engine->run_once(100ms);
+	}
+
+	client_thread.join();
+
+	ASSERT_TRUE(closed);
+	ASSERT_EQ(1, cancelled);
+	ASSERT_EQ(15, sent);
+	ASSERT_EQ(0, shut);
+	ASSERT_EQ("Hello there", received);
+	ASSERT_EQ("General Kenobi!", reply);
+	ASSERT_EQ(sock::Status::GOOD, engine->status());
+}
+
+GTEST_TEST(IoEngine, io_uring_engine_echoes)
+{
+	echo_through_engine(sock::Engine::IO_URING, "14843");
+}
+
+GTEST_TEST(IoEngine, epoll_engine_echoes)
+{
+	echo_through_engine(sock::Engine::EPOLL, "14844");
+}
+
+GTEST_TEST(IoEngine, failed_link_cancels_rest_of_chain)
+{
+	for (const auto kind : {sock::Engine::IO_URING, sock::Engine::EPOLL})
+	{
+		auto engine = sock::make_io_engine(kind);
+
+		int fds[2];
+		ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+		close(fds[1]);
+
+		int first = 1;
+		int second = 1;
+
+		engine
+		    ->send(
+		        fds[0],
+		        "lost",
+		        [&first](const sock::Completion& c)
+		        {
+			        first = c.result;
+		        },
+		        true
+		    )
+		    .shutdown(
+		        fds[0],
+		        [&second](const sock::Completion& c)
+		        {
+			        second = c.result;
+		        }
+		    );
+
+		for (int i = 0; i < 10 && second == 1; i++)
+		{
+			engine->run_once(std::chrono::milliseconds {100});
+		}
+
+		ASSERT_EQ(-EPIPE, first) << sock::str_engine(kind);
+		ASSERT_EQ(-ECANCELED, second) << sock::str_engine(kind);
+
+		close(fds[0]);
+	}
+}
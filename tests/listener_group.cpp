@@ -0,0 +1,123 @@
+#include "sock/listener_group.hpp"
+#include "sock/socket_factory.hpp"
+#include "sock/utils.hpp"
+#include <gtest/gtest.h>
+#include <poll.h>
+#include <sched.h>
+#include <vector>
+
+static constexpr sock::CtorArgs TCP {
+    .domain = sock::Domain::INET,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::TCP,
+    .flags = sock::Flags::PASSIVE,
+};
+
+/**
+ * Accepts `count` connections from whichever listeners have them and
+ * returns how many each listener got.
+ */
+static auto accept_all(sock::ListenerGroup& group, size_t count)
+    -> std::vector<size_t>
+{
+	std::vector<size_t> accepted(group.size(), 0);
+	std::vector<pollfd> fds;
+
+	for (auto& listener : group)
+	{
+		fds.push_back({.fd = listener.native_handle(), .events = POLLIN});
+	}
+
+	for (size_t total = 0; total < count;)
+	{
+		if (poll(fds.data(), fds.size(), 1000) <= 0)
+		{
+			break;
+		}
+
+		for (size_t i = 0; i < fds.size(); i++)
+		{
+			if (fds[i].revents & POLLIN)
+			{
+				group.listener(i).accept();
+				accepted[i]++;
+				total++;
+			}
+		}
+	}
+
+	return accepted;
+}
+
+GTEST_TEST(ListenerGroup, spreads_connections_between_listeners)
+{
+	constexpr size_t connections = 64;
+
+	sock::ListenerGroup group {
+	    TCP,
+	    {.host = "127.0.0.1", .port = "16843"},
+	    4};
+	ASSERT_EQ(sock::Status::GOOD, group.status());
+	ASSERT_EQ(4, group.size());
+
+	std::vector<sock::Socket> clients;
+
+	for (size_t i = 0; i < connections; i++)
+	{
+		auto& client = clients.emplace_back(
+		    sock::SocketFactory::instance().create(TCP)
+		);
+		client.connect({.host = "127.0.0.1", .port = "16843"});
+		ASSERT_EQ(sock::Status::GOOD, client.status());
+	}
+
+	const auto accepted = accept_all(group, connections);
+	size_t total = 0;
+	size_t used = 0;
+
+	for (auto n : accepted)
+	{
+		total += n;
+		used += n > 0;
+	}
+
+	ASSERT_EQ(connections, total);
+	ASSERT_GT(used, 1);
+}
+
+GTEST_TEST(ListenerGroup, steers_connections_to_listener_of_current_cpu)
+{
+	constexpr size_t connections = 16;
+
+	// Loopback packets are processed on the sending CPU.
+	const auto cpu = sched_getcpu();
+	cpu_set_t previous;
+	sched_getaffinity(0, sizeof(previous), &previous);
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	ASSERT_EQ(0, sched_setaffinity(0, sizeof(set), &set));
+
+	sock::ListenerGroup group {
+	    TCP,
+	    {.host = "127.0.0.1", .port = "16844"},
+	    4,
+	    {.steer_by_cpu = true}};
+	ASSERT_EQ(sock::Status::GOOD, group.status());
+
+	std::vector<sock::Socket> clients;
+
+	for (size_t i = 0; i < connections; i++)
+	{
+		auto& client = clients.emplace_back(
+		    sock::SocketFactory::instance().create(TCP)
+		);
+		client.connect({.host = "127.0.0.1", .port = "16844"});
+		ASSERT_EQ(sock::Status::GOOD, client.status());
+	}
+
+	const auto accepted = accept_all(group, connections);
+	sched_setaffinity(0, sizeof(previous), &previous);
+
+	ASSERT_EQ(connections, accepted[cpu % group.size()]);
+}
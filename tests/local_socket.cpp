@@ -0,0 +1,107 @@
+#include "sock/async_socket.hpp"
+#include "sock/socket_factory.hpp"
+#include "sock/task.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <unistd.h>
+
+static constexpr sock::CtorArgs LOCAL_STREAM {
+    .domain = sock::Domain::LOCAL,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::DEFAULT,
+};
+
+static constexpr sock::CtorArgs LOCAL_SEQPACKET {
+    .domain = sock::Domain::LOCAL,
+    .type = sock::Type::SEQPACKET,
+    .protocol = sock::Protocol::DEFAULT,
+};
+
+GTEST_TEST(LocalSocket, streams_over_filesystem_path)
+{
+	const auto path = "/tmp/sock-test-" + std::to_string(getpid()) + ".sock";
+	unlink(path.c_str());
+
+	auto server = sock::SocketFactory::instance().create(LOCAL_STREAM);
+	server.bind({.host = path});
+	server.listen(1);
+	ASSERT_EQ(sock::Status::GOOD, server.status());
+
+	// Wrapped sockets take the same arguments.
+	sock::Status last = sock::Status::GOOD;
+	auto client = sock::SocketFactory::instance()
+	                  .wrap(LOCAL_STREAM)
+	                  .with(
+	                      [&last](sock::Socket& socket)
+	                      {
+		                      last = socket.status();
+	                      }
+	                  )
+	                  .create();
+	client.connect({.host = path});
+	ASSERT_EQ(sock::Status::GOOD, last);
+
+	auto peer = server.accept();
+	client.send("over a path");
+
+	sock::Buffer buff;
+	peer.receive(buff);
+	ASSERT_EQ("over a path", buff.view());
+
+	unlink(path.c_str());
+}
+
+GTEST_TEST(LocalSocket, keeps_message_boundaries_in_abstract_namespace)
+{
+	const auto name = "@sock-test-" + std::to_string(getpid());
+
+	auto server = sock::SocketFactory::instance().create(LOCAL_SEQPACKET);
+	server.bind({.host = name});
+	server.listen(1);
+	ASSERT_EQ(sock::Status::GOOD, server.status());
+
+	// Nothing on the filesystem.
+	ASSERT_NE(0, access(name.c_str(), F_OK));
+
+	sock::Reactor reactor;
+	sock::AsyncSocket client {reactor, LOCAL_SEQPACKET};
+	ASSERT_EQ(
+	    sock::Status::GOOD,
+	    sock::block_on(reactor, client.async_connect({.host = name}))
+	);
+
+	auto peer = server.accept();
+	client.socket().send("one");
+	client.socket().send("two");
+
+	sock::Buffer buff;
+	peer.receive(buff);
+	ASSERT_EQ("one", buff.view());
+	peer.receive(buff);
+	ASSERT_EQ("two", buff.view());
+}
+
+GTEST_TEST(LocalSocket, creates_connected_pairs)
+{
+	auto [left, right] = sock::SocketFactory::instance().pair(LOCAL_SEQPACKET);
+	ASSERT_EQ(sock::Status::GOOD, left.status());
+	ASSERT_EQ(sock::Status::GOOD, right.status());
+
+	left.send("ping");
+
+	sock::Buffer buff;
+	right.receive(buff);
+	ASSERT_EQ("ping", buff.view());
+
+	right.send("pong");
+	left.receive(buff);
+	ASSERT_EQ("pong", buff.view());
+}
+
+GTEST_TEST(LocalSocket, rejects_paths_that_do_not_fit)
+{
+	auto socket = sock::SocketFactory::instance().create(LOCAL_STREAM);
+	socket.bind({.host = std::string(200, 'x')});
+
+	ASSERT_EQ(sock::Status::BIND_ERROR, socket.status());
+}
@@ -0,0 +1,69 @@
+#include "sock/mptcp.hpp"
+#include "sock/socket_factory.hpp"
+#include <gtest/gtest.h>
+
+static constexpr sock::CtorArgs MPTCP {
+    .domain = sock::Domain::INET,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::MPTCP,
+    .flags = sock::Flags::PASSIVE,
+};
+
+static constexpr sock::CtorArgs TCP {
+    .domain = sock::Domain::INET,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::TCP,
+    .flags = sock::Flags::PASSIVE,
+};
+
+GTEST_TEST(Mptcp, connects_with_or_without_kernel_support)
+{
+	auto server = sock::SocketFactory::instance().create(MPTCP);
+	server.option(sock::Option::REUSEADDR, 1);
+	server.bind({.host = "127.0.0.1", .port = "19870"});
+	server.listen(4);
+	ASSERT_EQ(sock::Status::GOOD, server.status());
+
+	auto client = sock::SocketFactory::instance().create(MPTCP);
+	client.connect({.host = "127.0.0.1", .port = "19870"});
+	ASSERT_EQ(sock::Status::GOOD, client.status());
+
+	auto conn = server.accept();
+	client.send("ping");
+
+	sock::Buffer buff;
+	conn.receive(buff);
+	ASSERT_EQ("ping", buff.view());
+
+	if (!sock::is_mptcp(client))
+	{
+		GTEST_SKIP() << "The kernel has no MPTCP, the socket fell back to TCP";
+	}
+
+	const auto info = sock::mptcp_status(client);
+	ASSERT_TRUE(info.active);
+	ASSERT_GE(info.subflows.size(), 1);
+	ASSERT_EQ(
+	    *sock::Endpoint::parse({.host = "127.0.0.1", .port = "19870"}),
+	    info.subflows.front().remote
+	);
+	ASSERT_EQ("127.0.0.1", info.subflows.front().local.to_string().substr(0, 9));
+}
+
+GTEST_TEST(Mptcp, reports_nothing_for_plain_tcp)
+{
+	auto server = sock::SocketFactory::instance().create(TCP);
+	server.option(sock::Option::REUSEADDR, 1);
+	server.bind({.host = "127.0.0.1", .port = "19871"});
+	server.listen(4);
+
+	auto client = sock::SocketFactory::instance().create(TCP);
+	client.connect({.host = "127.0.0.1", .port = "19871"});
+	ASSERT_EQ(sock::Status::GOOD, client.status());
+
+	ASSERT_FALSE(sock::is_mptcp(client));
+
+	const auto info = sock::mptcp_status(client);
+	ASSERT_FALSE(info.active);
+	ASSERT_TRUE(info.subflows.empty());
+}
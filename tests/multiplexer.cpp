@@ -0,0 +1,235 @@
+#include "sock/multiplexer.hpp"
+#include "sock/socket_factory.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <future>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+static constexpr sock::CtorArgs TCP {
+    .domain = sock::Domain::INET,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::TCP,
+    .flags = sock::Flags::PASSIVE,
+};
+
+static auto listener(const char* port) -> sock::Socket
+{
+	auto server = sock::SocketFactory::instance().create(TCP);
+	server.option(sock::Option::REUSEADDR, 1);
+	server.bind({.host = "127.0.0.1", .port = port});
+	server.listen(4);
+
+	return server;
+}
+
+static auto connect(const char* port) -> sock::Socket
+{
+	auto client = sock::SocketFactory::instance().create(TCP);
+	client.connect({.host = "127.0.0.1", .port = port});
+
+	return client;
+}
+
+static auto u32(std::string_view in) -> uint32_t
+{
+	const auto bytes = reinterpret_cast<const uint8_t*>(in.data());
+
+	return (uint32_t {bytes[0]} << 24) | (uint32_t {bytes[1]} << 16)
+	    | (uint32_t {bytes[2]} << 8) | uint32_t {bytes[3]};
+}
+
+GTEST_TEST(Multiplexer, matches_responses_by_id)
+{
+	static constexpr int COUNT = 100;
+	auto server = listener("19867");
+
+	// Reads all requests, answers them last to first.
+	std::thread backend {
+	    [&server]()
+	    {
+		    auto conn = server.accept();
+		    std::string input;
+		    std::vector<std::string> frames;
+		    sock::Buffer buff;
+
+		    while (frames.size() < COUNT)
+		    {
+			    conn.receive(buff);
+			    ASSERT_GT(buff.received_size(), 0);
+			    input.append(buff.view());
+
+			    while (input.size() >= 4 && input.size() >= 4 + u32(input))
+			    {
+				    const auto size = 4 + u32(input);
+				    frames.push_back(input.substr(0, size));
+				    input.erase(0, size);
+			    }
+		    }
+
+		    std::string output;
+
+		    for (auto it = frames.rbegin(); it != frames.rend(); it++)
+		    {
+			    // Same length and id, the payload echoed upper-cased.
+			    auto frame = *it;
+			    std::transform(
+			        frame.begin() + 8,
+			        frame.end(),
+			        frame.begin() + 8,
+			        ::toupper
+			    );
+			    output += frame;
+		    }
+
+		    conn.send(output);
+		    conn.receive(buff);
+	    }};
+
+	sock::Reactor reactor;
+	auto client = std::make_unique<sock::Multiplexer>(reactor, connect("19867"));
+	std::vector<std::string> replies(COUNT);
+	int done = 0;
+
+	for (int i = 0; i < COUNT; i++)
+	{
+		client->call(
+		    "req" + std::to_string(i),
+		    [&, i](sock::Reply reply)
+		    {
+			    ASSERT_EQ(sock::Status::GOOD, reply.status);
+			    replies[i] = std::move(reply.payload);
+			    done++;
+		    }
+		);
+	}
+
+	ASSERT_EQ(COUNT, client->in_flight());
+
+	while (done < COUNT)
+	{
+		reactor.run_once(1s);
+	}
+
+	for (int i = 0; i < COUNT; i++)
+	{
+		ASSERT_EQ("REQ" + std::to_string(i), replies[i]);
+	}
+
+	// Everything queued went out with one write.
+	ASSERT_EQ(1, client->metrics().flushes);
+	ASSERT_EQ(COUNT, client->metrics().responses);
+	ASSERT_EQ(0, client->in_flight());
+
+	client.reset();
+	backend.join();
+}
+
+GTEST_TEST(Multiplexer, pipelines_from_other_threads)
+{
+	auto server = listener("19868");
+
+	// Echoes lines as they come, in order.
+	std::thread backend {
+	    [&server]()
+	    {
+		    auto conn = server.accept();
+		    sock::Buffer buff;
+
+		    while (true)
+		    {
+			    conn.receive(buff);
+
+			    if (conn.status() != sock::Status::GOOD
+			        || buff.received_size() == 0)
+			    {
+				    break;
+			    }
+
+			    conn.send(buff.view());
+		    }
+	    }};
+
+	sock::Reactor reactor;
+	std::vector<std::future<sock::Reply>> replies;
+	std::atomic<bool> called {false};
+
+	{
+		sock::Multiplexer client {
+		    reactor,
+		    connect("19868"),
+		    sock::Matching::ORDER,
+		    [](std::string_view bytes) -> size_t
+		    {
+			    const auto end = bytes.find('\n');
+
+			    return end == std::string_view::npos ? 0 : end + 1;
+		    }};
+
+		std::thread caller {
+		    [&]()
+		    {
+			    for (int i = 0; i < 200; i++)
+			    {
+				    replies.push_back(
+				        client.call("line " + std::to_string(i) + "\n")
+				    );
+			    }
+
+			    called = true;
+		    }};
+
+		while (!called || client.in_flight() > 0)
+		{
+			reactor.run_once(10ms);
+		}
+
+		caller.join();
+	}
+
+	for (int i = 0; i < 200; i++)
+	{
+		auto reply = replies[i].get();
+		ASSERT_EQ(sock::Status::GOOD, reply.status);
+		ASSERT_EQ("line " + std::to_string(i) + "\n", reply.payload);
+	}
+
+	backend.join();
+}
+
+GTEST_TEST(Multiplexer, fails_outstanding_requests_when_peer_closes)
+{
+	auto server = listener("19869");
+	sock::Reactor reactor;
+	sock::Multiplexer client {reactor, connect("19869")};
+
+	auto first = client.call("one");
+	auto second = client.call("two");
+	reactor.run_once(1s);
+
+	{
+		auto conn = server.accept();
+		sock::Buffer buff;
+		conn.receive(buff);
+	}
+
+	while (client.status() == sock::Status::GOOD)
+	{
+		reactor.run_once(1s);
+	}
+
+	ASSERT_EQ(sock::Status::RECEIVE_ERROR, first.get().status);
+	ASSERT_EQ(sock::Status::RECEIVE_ERROR, second.get().status);
+
+	// Later requests fail right away.
+	auto third = client.call("three");
+	ASSERT_EQ(std::future_status::ready, third.wait_for(0s));
+	ASSERT_EQ(sock::Status::RECEIVE_ERROR, third.get().status);
+}
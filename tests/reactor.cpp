@@ -0,0 +1,302 @@
+#include "sock/reactor.hpp"
+#include "sock/socket_factory.hpp"
+#include "sock/utils.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+GTEST_TEST(Reactor, dispatches_timers_in_order)
+{
+	using namespace std::chrono_literals;
+
+	sock::Reactor reactor;
+	ASSERT_EQ(sock::Status::GOOD, reactor.status());
+
+	std::string order;
+
+	reactor.after(
+	    30ms,
+	    [&order]()
+	    {
+		    order += "c";
+	    }
+	);
+	reactor.after(
+	    10ms,
+	    [&order]()
+	    {
+		    order += "a";
+	    }
+	);
+	const auto cancelled = reactor.after(
+	    20ms,
+	    [&order]()
+	    {
+		    order += "x";
+	    }
+	);
+	reactor.after(
+	    20ms,
+	    [&order]()
+	    {
+		    order += "b";
+	    }
+	);
+	ASSERT_TRUE(reactor.cancel(cancelled));
+
+	int ticks = 0;
+	sock::Reactor::TimerId ticker = 0;
+	ticker = reactor.every(
+	    5ms,
+	    [&reactor, &ticks, &ticker]()
+	    {
+		    if (++ticks == 3)
+		    {
+			    reactor.cancel(ticker);
+		    }
+	    }
+	);
+
+	reactor.after(
+	    40ms,
+	    [&reactor]()
+	    {
+		    reactor.stop();
+	    }
+	);
+	reactor.run();
+
+	ASSERT_STREQ("abc", order.c_str());
+	ASSERT_EQ(3, ticks);
+}
+
+GTEST_TEST(Reactor, runs_callbacks_posted_from_other_threads)
+{
+	sock::Reactor reactor;
+	std::vector<int> values;
+
+	std::thread producer {
+	    [&reactor, &values]()
+	    {
+		    for (int i = 0; i < 100; i++)
+		    {
+			    reactor.post(
+			        [&values, i]()
+			        {
+				        values.push_back(i);
+			        }
+			    );
+		    }
+
+		    reactor.stop();
+	    }};
+
+	reactor.run();
+	producer.join();
+
+	ASSERT_EQ(100, values.size());
+	for (int i = 0; i < 100; i++)
+	{
+		ASSERT_EQ(i, values[i]);
+	}
+}
+
+GTEST_TEST(Reactor, serves_many_clients_on_one_thread)
+{
+	constexpr int CLIENTS = 16;
+
+	auto& factory = sock::SocketFactory::instance();
+	sock::Reactor reactor;
+
+	auto server = factory.create({
+	    .domain = sock::Domain::INET,
+	    .type = sock::Type::STREAM,
+	    .protocol = sock::Protocol::TCP,
+	    .flags = sock::Flags::PASSIVE,
+	});
+	server.option(sock::Option::REUSEADDR, 1);
+	server.bind({.host = "localhost", .port = "12843"});
+	server.listen(CLIENTS);
+	server.non_blocking(true);
+	ASSERT_EQ(sock::Status::GOOD, server.status());
+
+	std::vector<std::unique_ptr<sock::SocketWrapper>> connections;
+	int served = 0;
+
+	reactor.add(
+	    server,
+	    sock::Events::READABLE,
+	    [&](uint32_t)
+	    {
+		    auto wrapper = std::make_unique<sock::SocketWrapper>(
+		        server.accept(),
+		        nullptr
+		    );
+		    wrapper->non_blocking(true);
+
+		    reactor.add(
+		        *wrapper,
+		        sock::Events::READABLE,
+		        [&](sock::SocketWrapper& connection, uint32_t)
+		        {
+			        sock::Buffer buff;
+			        connection.receive(buff);
+
+			        if (buff.received_size() == 0)
+			        {
+				        reactor.remove(connection.native_handle());
+				        return;
+			        }
+
+			        connection.send(buff.view());
+
+			        if (++served == CLIENTS)
+			        {
+				        reactor.stop();
+			        }
+		        }
+		    );
+		    connections.push_back(std::move(wrapper));
+	    }
+	);
+
+	std::vector<std::string> replies(CLIENTS);
+	std::thread clients {
+	    [&replies, &factory]()
+	    {
+		    std::vector<sock::Socket> sockets;
+
+		    for (int i = 0; i < CLIENTS; i++)
+		    {
+			    auto& client = sockets.emplace_back(factory.create({
+			        .domain = sock::Domain::INET,
+			        .type = sock::Type::STREAM,
+			        .protocol = sock::Protocol::TCP,
+			    }));
+			    client.connect({.host = "localhost", .port = "12843"});
+			    client.send("ping " + std::to_string(i));
+		    }
+
+		    for (int i = 0; i < CLIENTS; i++)
+		    {
+			    sock::Buffer buff;
+			    sockets[i].receive(buff);
+			    replies[i] = buff.view();
+		    }
+	    }};
+
+	reactor.run();
+	clients.join();
+
+	ASSERT_EQ(CLIENTS, served);
+	ASSERT_EQ(CLIENTS, connections.size());
+	ASSERT_EQ(sock::Status::GOOD, reactor.status());
+
+	for (int i = 0; i < CLIENTS; i++)
+	{
+		ASSERT_EQ("ping " + std::to_string(i), replies[i]);
+	}
+}
+
+GTEST_TEST(Reactor, edge_triggered_handler_fires_once_per_arrival)
+{
+	int fds[2];
+	ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+
+	sock::Reactor reactor;
+	int level_calls = 0;
+	int edge_calls = 0;
+
+	reactor.add(
+	    fds[0],
+	    sock::Events::READABLE | sock::Events::EDGE_TRIGGERED,
+	    [&edge_calls](uint32_t events)
+	    {
+		    ASSERT_TRUE(events & sock::Events::READABLE);
+		    edge_calls++;
+	    }
+	);
+	ASSERT_EQ(1, write(fds[1], "x", 1));
+
+	for (int i = 0; i < 3; i++)
+	{
+		reactor.run_once(std::chrono::milliseconds {0});
+	}
+
+	reactor.remove(fds[0]);
+	reactor.add(
+	    fds[0],
+	    sock::Events::READABLE,
+	    [&level_calls](uint32_t)
+	    {
+		    level_calls++;
+	    }
+	);
+
+	for (int i = 0; i < 3; i++)
+	{
+		reactor.run_once(std::chrono::milliseconds {0});
+	}
+
+	ASSERT_EQ(1, edge_calls);
+	ASSERT_EQ(3, level_calls);
+
+	close(fds[0]);
+	close(fds[1]);
+}
+
+GTEST_TEST(Reactor, spins_before_blocking)
+{
+	using namespace std::chrono_literals;
+
+	sock::Reactor reactor;
+	reactor.wait_strategy({.spin = 20ms});
+
+	bool ran = false;
+	std::thread poster {
+	    [&reactor, &ran]()
+	    {
+		    std::this_thread::sleep_for(1ms);
+		    reactor.post(
+		        [&ran]()
+		        {
+			        ran = true;
+		        }
+		    );
+	    }};
+
+	reactor.run_once(100ms);
+	poster.join();
+
+	ASSERT_TRUE(ran);
+	ASSERT_EQ(1, reactor.wait_stats().spin_hits);
+	ASSERT_EQ(0, reactor.wait_stats().blocks);
+	ASSERT_GT(reactor.wait_stats().spinning, 0ms);
+
+	// Nothing comes, the spin phase runs out and the wait blocks.
+	reactor.run_once(30ms);
+
+	ASSERT_EQ(1, reactor.wait_stats().blocks);
+	ASSERT_GE(reactor.wait_stats().spinning, 20ms);
+	ASSERT_GT(reactor.wait_stats().blocked, 0ms);
+}
+
+GTEST_TEST(Reactor, adaptive_wait_stops_spinning_when_idle)
+{
+	using namespace std::chrono_literals;
+
+	sock::Reactor reactor;
+	reactor.wait_strategy(sock::WaitStrategy::hybrid(2ms, 0us));
+
+	for (int i = 0; i < 20; i++)
+	{
+		reactor.run_once(3ms);
+	}
+
+	const auto before = reactor.wait_stats().spinning;
+	reactor.run_once(3ms);
+
+	ASSERT_LT(reactor.wait_stats().spinning - before, 100us);
+	ASSERT_EQ(21, reactor.wait_stats().blocks);
+}
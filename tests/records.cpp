@@ -0,0 +1,117 @@
+#include "sock/records.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+GTEST_TEST(Records, every_isa_finds_what_find_finds)
+{
+	std::minstd_rand engine {42};
+	std::uniform_int_distribution<int> byte {0, 5};
+	const std::string alphabet {"ab\r\n\0x", 6};
+
+	for (size_t size = 0; size < 300; size++)
+	{
+		std::string bytes;
+
+		for (size_t i = 0; i < size; i++)
+		{
+			bytes += alphabet[byte(engine)];
+		}
+
+		for (const std::string_view delimiter :
+		     {std::string_view {"\n"},
+		      std::string_view {"\0", 1},
+		      std::string_view {"\r\n"},
+		      std::string_view {"\r\n\r\n"}})
+		{
+			for (size_t from = 0; from <= std::min<size_t>(size, 40); from++)
+			{
+				const auto view = std::string_view {bytes}.substr(from);
+				const auto expected = view.find(delimiter);
+
+				for (const auto isa :
+				     {sock::Isa::PORTABLE, sock::Isa::SSE2, sock::Isa::AVX2})
+				{
+					ASSERT_EQ(expected, sock::find_delimiter(view, delimiter, isa))
+					    << sock::str_isa(isa) << " size " << size << " from " << from;
+				}
+			}
+		}
+	}
+}
+
+GTEST_TEST(RecordReader, hands_out_whole_records_in_place)
+{
+	const std::string bytes {"GET / HTTP/1.1\r\nHost: x\r\n\r\ntail"};
+	sock::RecordReader reader;
+	reader.feed(bytes);
+
+	auto record = reader.next();
+	ASSERT_EQ("GET / HTTP/1.1", record);
+	ASSERT_EQ(bytes.data(), record->data());
+	ASSERT_EQ("Host: x", reader.next());
+	ASSERT_EQ("", reader.next());
+	ASSERT_FALSE(reader.next());
+	ASSERT_EQ(4, reader.buffered());
+}
+
+GTEST_TEST(RecordReader, gathers_records_split_across_reads)
+{
+	for (const std::string& delimiter :
+	     {std::string {"\r\n"}, std::string {"\0", 1}, std::string {"\r\n\r\n"}})
+	{
+		const std::vector<std::string> records {"alpha", "", std::string(100, 'x'), "\r", "omega"};
+		std::string bytes;
+
+		for (const auto& record : records)
+		{
+			bytes += record + delimiter;
+		}
+
+		for (size_t step = 1; step <= bytes.size(); step++)
+		{
+			sock::RecordReader reader {delimiter};
+			std::vector<std::string> read_records;
+
+			for (size_t offset = 0; offset < bytes.size(); offset += step)
+			{
+				// The receive buffer is reused for every read.
+				std::string read = bytes.substr(offset, step);
+				reader.feed(read);
+
+				while (const auto record = reader.next())
+				{
+					read_records.emplace_back(*record);
+				}
+
+				read.assign(read.size(), '?');
+			}
+
+			ASSERT_EQ(sock::Status::GOOD, reader.status());
+			ASSERT_EQ(records, read_records) << "step " << step;
+			ASSERT_EQ(0, reader.buffered());
+		}
+	}
+}
+
+GTEST_TEST(RecordReader, rejects_oversized_records)
+{
+	sock::RecordReader reader {"\n", 8};
+	const std::string bytes {"short\nmuch too long\n"};
+	reader.feed(bytes);
+
+	ASSERT_EQ("short", reader.next());
+	ASSERT_FALSE(reader.next());
+	ASSERT_EQ(sock::Status::FRAME_ERROR, reader.status());
+
+	// Also without a delimiter in sight.
+	reader.reset();
+	const std::string first {"12345"};
+	const std::string second {"6789"};
+	reader.feed(first);
+	ASSERT_FALSE(reader.next());
+	reader.feed(second);
+	ASSERT_FALSE(reader.next());
+	ASSERT_EQ(sock::Status::FRAME_ERROR, reader.status());
+}
@@ -0,0 +1,118 @@
+#include "sock/runtime.hpp"
+#include "sock/socket_factory.hpp"
+#include "sock/utils.hpp"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+static constexpr sock::CtorArgs TCP {
+    .domain = sock::Domain::INET,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::TCP,
+    .flags = sock::Flags::PASSIVE,
+};
+
+GTEST_TEST(Runtime, passes_messages_between_cores)
+{
+	sock::Runtime runtime {{.cores = 2}};
+	ASSERT_EQ(sock::Status::GOOD, runtime.status());
+	ASSERT_EQ(2, runtime.size());
+
+	std::atomic<bool> done = false;
+	std::thread::id first;
+	std::thread::id second;
+
+	runtime.start();
+	runtime.core(0).send(
+	    0,
+	    [&](sock::Core& core)
+	    {
+		    first = std::this_thread::get_id();
+		    core.send(
+		        1,
+		        [&](sock::Core&)
+		        {
+			        second = std::this_thread::get_id();
+			        done = true;
+		        }
+		    );
+	    }
+	);
+
+	while (!done)
+	{
+		std::this_thread::yield();
+	}
+
+	runtime.stop();
+
+	ASSERT_NE(first, second);
+	ASSERT_EQ(1, runtime.core(0).metrics().messages);
+	ASSERT_EQ(1, runtime.core(1).metrics().messages);
+}
+
+GTEST_TEST(Runtime, echoes_on_every_core)
+{
+	constexpr size_t clients_count = 16;
+
+	sock::Runtime runtime {{.cores = 2}};
+
+	runtime.listen(
+	    TCP,
+	    {.host = "127.0.0.1", .port = "17843"},
+	    [](sock::Core& core, sock::Socket&& accepted)
+	    {
+		    auto conn = std::make_shared<sock::Socket>(std::move(accepted));
+
+		    core.reactor().add(
+		        *conn,
+		        sock::Events::READABLE,
+		        [&core, conn](uint32_t)
+		        {
+			        auto buff = core.buffers().acquire();
+			        conn->receive(*buff);
+
+			        if (buff->received_size() == 0)
+			        {
+				        core.reactor().remove(conn->native_handle());
+				        return;
+			        }
+
+			        conn->send(buff->view());
+		        }
+		    );
+	    }
+	);
+	ASSERT_EQ(sock::Status::GOOD, runtime.status());
+
+	runtime.start();
+
+	std::vector<sock::Socket> clients;
+
+	for (size_t i = 0; i < clients_count; i++)
+	{
+		auto& client = clients.emplace_back(
+		    sock::SocketFactory::instance().create(TCP)
+		);
+		client.connect({.host = "127.0.0.1", .port = "17843"});
+		ASSERT_EQ(sock::Status::GOOD, client.status());
+
+		const auto message = "hello " + std::to_string(i);
+		client.send(message);
+
+		sock::Buffer buff;
+		client.receive(buff);
+		ASSERT_EQ(message, buff.view());
+	}
+
+	clients.clear();
+	runtime.stop();
+
+	ASSERT_EQ(
+	    clients_count,
+	    runtime.core(0).metrics().accepted + runtime.core(1).metrics().accepted
+	);
+}
@@ -0,0 +1,194 @@
+#include "sock/connection.hpp"
+#include "sock/runtime.hpp"
+#include "sock/send_queue.hpp"
+#include "sock/socket_factory.hpp"
+#include <atomic>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static constexpr sock::CtorArgs TCP {
+    .domain = sock::Domain::INET,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::TCP,
+    .flags = sock::Flags::PASSIVE,
+};
+
+static auto read_all(int fd, size_t size) -> std::string
+{
+	std::string received;
+	char buff[4096];
+
+	while (received.size() < size)
+	{
+		const auto n = read(fd, buff, sizeof(buff));
+
+		if (n <= 0)
+		{
+			break;
+		}
+
+		received.append(buff, n);
+	}
+
+	return received;
+}
+
+GTEST_TEST(SendQueue, signals_once_per_batch)
+{
+	sock::SendQueue queue;
+	ASSERT_EQ(sock::Status::GOOD, queue.status());
+
+	int fds[2];
+	ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+
+	std::vector<std::thread> producers;
+
+	for (int p = 0; p < 4; p++)
+	{
+		producers.emplace_back(
+		    [&queue]()
+		    {
+			    for (int i = 0; i < 100; i++)
+			    {
+				    queue.push("x");
+			    }
+		    }
+		);
+	}
+
+	for (auto& t : producers)
+	{
+		t.join();
+	}
+
+	ASSERT_EQ(1, queue.wakeups());
+	ASSERT_EQ(400, queue.flush(fds[0]));
+	ASSERT_FALSE(queue.pending());
+	ASSERT_EQ(std::string(400, 'x'), read_all(fds[1], 400));
+
+	queue.push("y");
+	ASSERT_EQ(2, queue.wakeups());
+
+	close(fds[0]);
+	close(fds[1]);
+}
+
+GTEST_TEST(SendQueue, keeps_order_of_each_producer)
+{
+	constexpr int producers_count = 4;
+	constexpr int messages = 2000;
+
+	sock::SendQueue queue;
+	int fds[2];
+	ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+
+	std::string received;
+	std::thread reader {
+	    [&]()
+	    {
+		    received = read_all(fds[1], producers_count * messages * 6);
+	    }};
+
+	std::vector<std::thread> producers;
+	std::atomic<int> running = producers_count;
+
+	for (int p = 0; p < producers_count; p++)
+	{
+		producers.emplace_back(
+		    [&, p]()
+		    {
+			    for (int i = 0; i < messages; i++)
+			    {
+				    char message[7];
+				    std::snprintf(message, sizeof(message), "%d%04d\n", p, i);
+				    queue.push(message);
+			    }
+
+			    running--;
+		    }
+		);
+	}
+
+	pollfd notifier {.fd = queue.notifier(), .events = POLLIN, .revents = 0};
+
+	while (running > 0 || queue.pending())
+	{
+		poll(&notifier, 1, 10);
+		ASSERT_GE(queue.flush(fds[0]), 0);
+	}
+
+	for (auto& t : producers)
+	{
+		t.join();
+	}
+
+	reader.join();
+
+	ASSERT_EQ(producers_count * messages * 6, received.size());
+	ASSERT_LT(queue.wakeups(), producers_count * messages);
+
+	std::vector<int> next(producers_count, 0);
+
+	for (size_t i = 0; i < received.size(); i += 6)
+	{
+		const auto p = received[i] - '0';
+		ASSERT_EQ(next[p]++, std::stoi(received.substr(i + 1, 4)));
+	}
+
+	close(fds[0]);
+	close(fds[1]);
+}
+
+GTEST_TEST(SendQueue, lets_other_threads_write_to_a_connection)
+{
+	constexpr int messages = 1000;
+
+	sock::Runtime runtime {{.cores = 1}};
+	std::shared_ptr<sock::Connection> connection;
+	std::atomic<bool> accepted = false;
+
+	runtime.listen(
+	    TCP,
+	    {.host = "127.0.0.1", .port = "19843"},
+	    [&](sock::Core& core, sock::Socket&& socket)
+	    {
+		    connection = std::make_shared<sock::Connection>(
+		        std::move(socket),
+		        [](sock::Connection&)
+		        {}
+		    );
+		    core.adopt(connection);
+		    accepted = true;
+	    }
+	);
+	runtime.start();
+
+	auto client = sock::SocketFactory::instance().create(TCP);
+	client.connect({.host = "127.0.0.1", .port = "19843"});
+
+	while (!accepted)
+	{
+		std::this_thread::yield();
+	}
+
+	std::thread producer {
+	    [&connection]()
+	    {
+		    for (int i = 0; i < messages; i++)
+		    {
+			    connection->post("ping\n");
+		    }
+	    }};
+
+	const auto received = read_all(client.native_handle(), messages * 5);
+	producer.join();
+	runtime.stop();
+
+	ASSERT_EQ(messages * 5, received.size());
+}
@@ -0,0 +1,129 @@
+#include "sock/internal/concepts.hpp"
+#include "sock/shm_socket.hpp"
+#include <algorithm>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static_assert(sock::internal::is_socket<sock::ShmSocket, sock::Status>);
+
+static constexpr sock::CtorArgs ARGS {
+    .domain = sock::Domain::LOCAL,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::DEFAULT,
+};
+
+static auto pattern(size_t i) -> char
+{
+	return static_cast<char>('a' + i % 23);
+}
+
+GTEST_TEST(ShmSocket, streams_between_processes)
+{
+	// Many times the ring, so both sides have to wait for each other.
+	constexpr size_t total = 8 << 20;
+
+	const auto name = "@sock-shm-test-" + std::to_string(getpid());
+
+	sock::ShmSocket server {ARGS};
+	server.bind({.host = name});
+	server.listen(1);
+	ASSERT_EQ(sock::Status::GOOD, server.status());
+
+	const auto child = fork();
+	ASSERT_GE(child, 0);
+
+	if (child == 0)
+	{
+		sock::ShmSocket client {ARGS, 64 * 1024};
+		client.connect({.host = name});
+
+		std::string chunk(10000, '\0');
+
+		for (size_t sent = 0; sent < total; sent += chunk.size())
+		{
+			for (size_t i = 0; i < chunk.size(); i++)
+			{
+				chunk[i] = pattern(sent + i);
+			}
+
+			client.send(std::string_view {chunk}.substr(
+			    0,
+			    std::min(chunk.size(), total - sent)
+			));
+		}
+
+		sock::Buffer buff;
+		client.receive(buff);
+		_exit(client.status() == sock::Status::GOOD && buff.view() == "done"
+		          ? 0
+		          : 1);
+	}
+
+	auto conn = server.accept();
+	ASSERT_EQ(sock::Status::GOOD, conn.status());
+
+	size_t received = 0;
+	bool intact = true;
+	sock::Buffer buff;
+
+	while (received < total)
+	{
+		conn.receive(buff);
+		ASSERT_GT(buff.received_size(), 0);
+
+		for (size_t i = 0; i < buff.received_size(); i++)
+		{
+			intact = intact && buff.buffer()[i] == pattern(received + i);
+		}
+
+		received += buff.received_size();
+	}
+
+	ASSERT_TRUE(intact);
+	ASSERT_EQ(total, received);
+	conn.send("done");
+
+	int status = -1;
+	waitpid(child, &status, 0);
+	ASSERT_TRUE(WIFEXITED(status));
+	ASSERT_EQ(0, WEXITSTATUS(status));
+}
+
+GTEST_TEST(ShmSocket, reports_close_and_timeouts)
+{
+	using namespace std::chrono_literals;
+
+	const auto name = "@sock-shm-close-" + std::to_string(getpid());
+
+	sock::ShmSocket server {ARGS};
+	server.bind({.host = name});
+	server.listen(1);
+
+	auto client = std::make_unique<sock::ShmSocket>(ARGS);
+	client->connect({.host = name});
+	ASSERT_EQ(sock::Status::GOOD, client->status());
+
+	auto conn = server.accept();
+	conn.option(sock::Option::RCVTIMEO, 50ms);
+
+	sock::Buffer buff;
+	const auto start = std::chrono::steady_clock::now();
+	conn.receive(buff);
+	ASSERT_EQ(sock::Status::RECEIVE_ERROR, conn.status());
+	ASSERT_GE(std::chrono::steady_clock::now() - start, 50ms);
+
+	client->send("bye");
+	client.reset();
+
+	conn.receive(buff);
+	ASSERT_EQ("bye", buff.view());
+	conn.receive(buff);
+	ASSERT_EQ(0, buff.received_size());
+
+	conn.send("anyone?");
+	ASSERT_EQ(sock::Status::SEND_ERROR, conn.status());
+}
@@ -0,0 +1,193 @@
+#include "sock/async_socket.hpp"
+#include "sock/internal/frame_pool.hpp"
+#include "sock/reactor.hpp"
+#include "sock/task.hpp"
+#include "sock/utils.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+static constexpr sock::CtorArgs TCP {
+    .domain = sock::Domain::INET,
+    .type = sock::Type::STREAM,
+    .protocol = sock::Protocol::TCP,
+    .flags = sock::Flags::PASSIVE,
+};
+
+static auto listener(sock::Reactor& reactor, const char* port)
+    -> sock::AsyncSocket
+{
+	sock::AsyncSocket server {reactor, TCP};
+	server.socket().option(sock::Option::REUSEADDR, 1);
+	server.socket().bind({.host = "127.0.0.1", .port = port});
+	server.socket().listen(64);
+
+	return server;
+}
+
+static auto echo(sock::AsyncSocket conn) -> sock::Task<>
+{
+	sock::Buffer buff;
+
+	while (co_await conn.async_receive(buff) == sock::Status::GOOD
+	       && buff.received_size() > 0)
+	{
+		if (co_await conn.async_send(buff.view()) != sock::Status::GOOD)
+		{
+			break;
+		}
+	}
+}
+
+GTEST_TEST(Task, returns_values_through_nested_awaits)
+{
+	sock::Reactor reactor;
+
+	auto add = [](int a, int b) -> sock::Task<int>
+	{
+		co_return a + b;
+	};
+	auto sum = [&]() -> sock::Task<int>
+	{
+		int total = 0;
+
+		for (int i = 0; i < 10; i++)
+		{
+			total += co_await add(i, 1);
+		}
+
+		co_return total;
+	};
+
+	ASSERT_EQ(55, sock::block_on(reactor, sum()));
+}
+
+GTEST_TEST(Task, serves_many_connections_with_coroutines)
+{
+	constexpr int connections = 32;
+
+	sock::Reactor reactor;
+	auto server = listener(reactor, "15843");
+	ASSERT_EQ(sock::Status::GOOD, server.status());
+
+	auto serve = [&]() -> sock::Task<>
+	{
+		for (int i = 0; i < connections; i++)
+		{
+			auto conn = co_await server.async_accept();
+
+			if (conn.status() != sock::Status::GOOD)
+			{
+				break;
+			}
+
+			sock::spawn(echo(std::move(conn)));
+		}
+	};
+
+	int echoed = 0;
+
+	auto client = [&](int i) -> sock::Task<>
+	{
+		sock::AsyncSocket conn {reactor, TCP};
+
+		if (co_await conn.async_connect({.host = "127.0.0.1", .port = "15843"})
+		    != sock::Status::GOOD)
+		{
+			co_return;
+		}
+
+		const auto message = "hello " + std::to_string(i);
+		sock::Buffer buff;
+
+		co_await conn.async_send(message);
+		co_await conn.async_receive(buff);
+
+		if (buff.view() == message)
+		{
+			echoed++;
+		}
+	};
+
+	auto clients = [&]() -> sock::Task<>
+	{
+		for (int i = 0; i < connections; i++)
+		{
+			sock::spawn(client(i));
+		}
+
+		while (echoed < connections)
+		{
+			co_await sock::sleep_for(reactor, std::chrono::milliseconds {1});
+		}
+	};
+
+	sock::spawn(serve());
+	sock::block_on(reactor, clients());
+
+	ASSERT_EQ(connections, echoed);
+}
+
+GTEST_TEST(Task, times_out_and_cancels_operations)
+{
+	using namespace std::chrono_literals;
+
+	sock::Reactor reactor;
+	auto server = listener(reactor, "15844");
+	ASSERT_EQ(sock::Status::GOOD, server.status());
+
+	server.timeout(20ms);
+	auto accepted = sock::block_on(reactor, server.async_accept());
+	ASSERT_EQ(sock::Status::TIMED_OUT, accepted.status());
+
+	sock::AsyncSocket client {reactor, TCP};
+	ASSERT_EQ(
+	    sock::Status::GOOD,
+	    sock::block_on(
+	        reactor,
+	        client.async_connect({.host = "127.0.0.1", .port = "15844"})
+	    )
+	);
+
+	server.timeout(0ms);
+	reactor.after(
+	    10ms,
+	    [&client]()
+	    {
+		    client.cancel();
+	    }
+	);
+
+	sock::Buffer buff;
+	ASSERT_EQ(
+	    sock::Status::CANCELLED,
+	    sock::block_on(reactor, client.async_receive(buff))
+	);
+}
+
+GTEST_TEST(Task, reuses_coroutine_frames)
+{
+	sock::Reactor reactor;
+
+	auto step = [](int i) -> sock::Task<int>
+	{
+		co_return i;
+	};
+	auto run = [&](int n) -> sock::Task<int>
+	{
+		int total = 0;
+
+		for (int i = 0; i < n; i++)
+		{
+			total += co_await step(i);
+		}
+
+		co_return total;
+	};
+
+	sock::block_on(reactor, run(10));
+	const auto misses = sock::internal::FramePool::misses();
+
+	sock::block_on(reactor, run(10000));
+
+	ASSERT_EQ(misses, sock::internal::FramePool::misses());
+}
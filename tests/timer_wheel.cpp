@@ -0,0 +1,167 @@
+#include "sock/socket_factory.hpp"
+#include "sock/timer_wheel.hpp"
+#include <algorithm>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+using Clock = sock::TimerWheel::Clock;
+
+GTEST_TEST(TimerWheel, fires_across_levels_in_deadline_order)
+{
+	sock::TimerWheel wheel;
+	std::string order;
+
+	sock::WheelTimer a {[&order]() { order += "a"; }};
+	sock::WheelTimer b {[&order]() { order += "b"; }};
+	sock::WheelTimer c {[&order]() { order += "c"; }};
+	sock::WheelTimer x {[&order]() { order += "x"; }};
+
+	// Inner wheel, first and second outer wheel.
+	wheel.schedule(c, 20000ms);
+	wheel.schedule(a, 10ms);
+	wheel.schedule(b, 300ms);
+	wheel.schedule(x, 200ms);
+	wheel.cancel(x);
+	ASSERT_EQ(3, wheel.size());
+
+	ASSERT_EQ(0, wheel.advance(Clock::now()));
+	ASSERT_EQ(3, wheel.advance(Clock::now() + 25s));
+	ASSERT_EQ("abc", order);
+	ASSERT_EQ(0, wheel.size());
+	ASSERT_FALSE(a.armed());
+}
+
+GTEST_TEST(TimerWheel, rearms_without_firing_twice)
+{
+	sock::TimerWheel wheel;
+	int fired = 0;
+	sock::WheelTimer idle {[&fired]() { fired++; }};
+
+	const auto start = Clock::now();
+
+	for (int i = 0; i < 100; i++)
+	{
+		wheel.schedule(idle, 50ms);
+	}
+
+	ASSERT_EQ(1, wheel.size());
+	ASSERT_EQ(0, wheel.advance(start + 40ms));
+	wheel.schedule(idle, 100ms);
+	ASSERT_EQ(0, wheel.advance(start + 60ms));
+	ASSERT_EQ(1, wheel.advance(start + 200ms));
+	ASSERT_EQ(1, fired);
+
+	{
+		sock::WheelTimer dropped;
+		wheel.schedule(dropped, 10ms);
+		ASSERT_EQ(1, wheel.size());
+	}
+
+	ASSERT_EQ(0, wheel.size());
+}
+
+GTEST_TEST(TimerWheel, handles_many_socket_deadlines)
+{
+	constexpr size_t sockets = 100000;
+
+	sock::TimerWheel wheel;
+	std::vector<std::unique_ptr<sock::WheelTimer>> timers;
+	size_t fired = 0;
+
+	for (size_t i = 0; i < sockets; i++)
+	{
+		auto& timer = timers.emplace_back(
+		    std::make_unique<sock::WheelTimer>([&fired]() { fired++; })
+		);
+		wheel.schedule(*timer, std::chrono::milliseconds {i % 60000});
+	}
+
+	// Every socket saw traffic, push its idle deadline back.
+	for (size_t i = 0; i < sockets; i++)
+	{
+		wheel.schedule(*timers[i], std::chrono::milliseconds {60000 + i % 1000});
+	}
+
+	ASSERT_EQ(sockets, wheel.size());
+	ASSERT_EQ(0, wheel.advance(Clock::now() + 59s));
+	ASSERT_EQ(sockets, wheel.advance(Clock::now() + 62s));
+	ASSERT_EQ(sockets, fired);
+}
+
+GTEST_TEST(TimerWheel, fires_on_time)
+{
+	constexpr size_t count = 2000;
+
+	sock::TimerWheel wheel;
+	std::mt19937 random {42};
+	std::uniform_int_distribution<int> delays {1, 300};
+
+	std::vector<Clock::time_point> deadlines(count);
+	std::vector<Clock::time_point> fired_at(count);
+	std::vector<std::unique_ptr<sock::WheelTimer>> timers;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const auto delay = std::chrono::milliseconds {delays(random)};
+		deadlines[i] = Clock::now() + delay;
+
+		auto& timer = timers.emplace_back(std::make_unique<sock::WheelTimer>(
+		    [&fired_at, i]()
+		    {
+			    fired_at[i] = Clock::now();
+		    }
+		));
+		wheel.schedule(*timer, delay);
+	}
+
+	while (wheel.size() > 0)
+	{
+		wheel.advance();
+		std::this_thread::sleep_for(wheel.tick() / 2);
+	}
+
+	std::vector<Clock::duration> lateness;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		ASSERT_GE(fired_at[i], deadlines[i]) << "timer " << i << " fired early";
+		lateness.push_back(fired_at[i] - deadlines[i]);
+	}
+
+	std::sort(lateness.begin(), lateness.end());
+
+	// One tick of resolution plus the loop's own sleep, with headroom for a
+	// loaded machine.
+	ASSERT_LT(lateness[count * 99 / 100], 10ms);
+}
+
+GTEST_TEST(Socket, converts_millisecond_timeouts_to_timeval)
+{
+	auto socket = sock::SocketFactory::instance().create({
+	    .domain = sock::Domain::INET,
+	    .type = sock::Type::STREAM,
+	    .protocol = sock::Protocol::TCP,
+	});
+	socket.option(sock::Option::RCVTIMEO, 1500ms);
+	ASSERT_EQ(sock::Status::GOOD, socket.status());
+
+	timeval timeout {};
+	socklen_t size = sizeof(timeout);
+	getsockopt(
+	    socket.native_handle(),
+	    SOL_SOCKET,
+	    SO_RCVTIMEO,
+	    &timeout,
+	    &size
+	);
+
+	ASSERT_EQ(1, timeout.tv_sec);
+	ASSERT_EQ(500000, timeout.tv_usec);
+}